@@ -0,0 +1,398 @@
+/*
+ *
+ *   Copyright (C) 2012-2020 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+// uget-daemon: run UgetApp, UgetTask and UgetRpc without GTK.
+// Downloads are added and controlled by JSON-RPC, e.g. "uget-daemon URL"
+// from other process or query and subscription methods of UgetRpc.
+
+#if defined _WIN32 || defined _WIN64
+#include <windows.h>   // Sleep()
+#define  ug_sleep       Sleep
+#else
+#include <unistd.h>    // usleep(), sync()
+#define  ug_sleep(millisecond)    usleep (millisecond * 1000)
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>    // exit(), getenv(), EXIT_SUCCESS
+#include <signal.h>    // signal(), SIGTERM
+#include <UgUtil.h>
+#include <UgString.h>
+#include <UgFileUtil.h>
+#include <UgOption.h>
+#include <UgetApp.h>
+#include <UgetRpc.h>
+#include <UgetOption.h>
+#include <UgetPluginAgent.h>
+#include <UgetPluginCurl.h>
+#include <UgetPluginAria2.h>
+#include <UgetPluginMedia.h>
+#include <UgetPluginMega.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifndef PACKAGE_VERSION
+#define PACKAGE_VERSION    ""
+#endif
+
+// share data with uget-gtk. Both programs use the same RPC address,
+// only one of them can run at the same time.
+#define UGET_DAEMON_DIR            "uGet"
+// interval of main loop (milliseconds)
+#define UGET_DAEMON_INTERVAL       500
+// save categories every 60 seconds (counts of interval)
+#define UGET_DAEMON_AUTOSAVE       (60 * 1000 / UGET_DAEMON_INTERVAL)
+
+typedef struct UgetDaemon    UgetDaemon;
+
+struct UgetDaemon
+{
+	UGET_APP_MEMBERS;
+
+	UgetRpc*  rpc;
+	int       offline;
+	int       n_active;
+	int       n_counts;
+};
+
+static volatile sig_atomic_t  daemon_quitting = 0;
+
+static void sys_signal_handler (int sig)
+{
+	switch (sig) {
+	case SIGINT:  // Ctrl-C
+	case SIGTERM: // termination request
+		// main loop will stop tasks and save data.
+		daemon_quitting = 1;
+		break;
+
+	default:
+		break;
+	}
+}
+
+// ----------------------------------------------------------------------------
+// directory
+
+static char* uget_daemon_get_config_dir (void)
+{
+	const char* dir;
+
+#if defined _WIN32 || defined _WIN64
+	dir = getenv ("APPDATA");
+	if (dir == NULL)
+		dir = ".";
+	return ug_build_filename (dir, UGET_DAEMON_DIR, NULL);
+#else
+	dir = getenv ("XDG_CONFIG_HOME");
+	if (dir && dir[0])
+		return ug_build_filename (dir, UGET_DAEMON_DIR, NULL);
+	dir = getenv ("HOME");
+	if (dir == NULL)
+		dir = ".";
+	return ug_build_filename (dir, ".config", UGET_DAEMON_DIR, NULL);
+#endif
+}
+
+static char* uget_daemon_get_download_dir (void)
+{
+	const char* dir;
+
+#if defined _WIN32 || defined _WIN64
+	dir = getenv ("USERPROFILE");
+#else
+	dir = getenv ("HOME");
+#endif
+	if (dir == NULL)
+		dir = ".";
+	return ug_build_filename (dir, "Downloads", NULL);
+}
+
+// ----------------------------------------------------------------------------
+// UgetDaemon
+
+static void  uget_daemon_add_default_category (UgetDaemon* daemon)
+{
+	UgetNode*     cnode;
+	UgetCommon*   common;
+	UgetCategory* category;
+	char*         folder;
+
+	cnode = uget_node_new (NULL);
+	common = ug_info_realloc (cnode->info, UgetCommonInfo);
+	common->name = ug_strdup ("Home");
+	folder = uget_daemon_get_download_dir ();
+	common->folder = ug_str_intern (folder);
+	ug_free (folder);
+	category = ug_info_realloc (cnode->info, UgetCategoryInfo);
+	*(char**)ug_array_alloc (&category->schemes, 1) = ug_strdup ("ftps");
+	*(char**)ug_array_alloc (&category->schemes, 1) = ug_strdup ("magnet");
+	*(char**)ug_array_alloc (&category->file_exts, 1) = ug_strdup ("torrent");
+	*(char**)ug_array_alloc (&category->file_exts, 1) = ug_strdup ("metalink");
+
+	uget_app_add_category ((UgetApp*) daemon, cnode, TRUE);
+}
+
+static void  uget_daemon_init (UgetDaemon* daemon, UgetRpc* rpc)
+{
+	char*  dir;
+
+	daemon->rpc = rpc;
+	daemon->offline = FALSE;
+	daemon->n_active = 0;
+	daemon->n_counts = 0;
+	uget_app_init ((UgetApp*) daemon);
+	dir = uget_daemon_get_config_dir ();
+	uget_app_set_config_dir ((UgetApp*) daemon, dir);
+	ug_free (dir);
+
+	if (uget_app_load_categories ((UgetApp*) daemon, NULL) == 0)
+		uget_daemon_add_default_category (daemon);
+
+	// plug-in initialize
+	uget_plugin_global_set(UgetPluginCurlInfo,  UGET_PLUGIN_GLOBAL_INIT, (void*) TRUE);
+	uget_plugin_global_set(UgetPluginMediaInfo, UGET_PLUGIN_GLOBAL_INIT, (void*) TRUE);
+	uget_plugin_global_set(UgetPluginMegaInfo,  UGET_PLUGIN_GLOBAL_INIT, (void*) TRUE);
+	// curl is default plug-in, aria2 is not launched by daemon.
+	uget_app_add_plugin ((UgetApp*) daemon, UgetPluginCurlInfo);
+	uget_app_add_plugin ((UgetApp*) daemon, UgetPluginMediaInfo);
+	uget_app_add_plugin ((UgetApp*) daemon, UgetPluginMegaInfo);
+	uget_app_set_default_plugin ((UgetApp*) daemon, UgetPluginCurlInfo);
+	uget_plugin_agent_global_set(UGET_PLUGIN_AGENT_GLOBAL_PLUGIN,
+	                             (void*) UgetPluginCurlInfo);
+
+	uget_app_use_uri_hash ((UgetApp*) daemon);
+}
+
+static void  uget_daemon_final (UgetDaemon* daemon)
+{
+	uget_app_clear_attachment ((UgetApp*) daemon);
+	uget_app_final ((UgetApp*) daemon);
+	// plug-in finalize
+	uget_plugin_global_set(UgetPluginCurlInfo,  UGET_PLUGIN_GLOBAL_INIT, (void*) FALSE);
+	uget_plugin_global_set(UgetPluginMediaInfo, UGET_PLUGIN_GLOBAL_INIT, (void*) FALSE);
+	uget_plugin_global_set(UgetPluginMegaInfo,  UGET_PLUGIN_GLOBAL_INIT, (void*) FALSE);
+}
+
+static void  uget_daemon_save (UgetDaemon* daemon)
+{
+	if (daemon->config_dir == NULL)
+		return;
+	ug_create_dir_all (daemon->config_dir, -1);
+	uget_app_save_categories ((UgetApp*) daemon, NULL);
+}
+
+static void  uget_daemon_quit (UgetDaemon* daemon)
+{
+	// stop all tasks
+	uget_task_remove_all (&daemon->task);
+	uget_daemon_save (daemon);
+	uget_app_clear_plugins ((UgetApp*) daemon);
+}
+
+// ----------------------------------------------------------------------------
+// RPC
+
+static void  uget_daemon_add_uris (UgetDaemon* daemon, UgetRpcCmd* cmd)
+{
+	UgLink*     link;
+	UgArrayPtr  dnodes;
+	UgetNode*   cnode;
+	UgetNode*   dnode;
+	UgetCommon* common;
+	UgInfo*     node_info;
+
+	// select category, other downloads match category by URI and filename.
+	cnode = NULL;
+	if (cmd->value.category_index != -1)
+		cnode = uget_node_nth_child (&daemon->real, cmd->value.category_index);
+
+	node_info = ug_info_new(8, 0);
+	uget_option_value_to_info (&cmd->value, node_info);
+	ug_array_init (&dnodes, sizeof (UgetNode*), cmd->uris.size);
+	for (link = cmd->uris.head;  link;  link = link->next) {
+		if (link->data == NULL)
+			continue;
+		dnode = uget_node_new (NULL);
+		ug_info_assign (dnode->info, node_info, NULL);
+		common = ug_info_realloc (dnode->info, UgetCommonInfo);
+		common->uri = link->data;
+		link->data = NULL;
+		*(UgetNode**) ug_array_alloc (&dnodes, 1) = dnode;
+	}
+	ug_info_unref (node_info);
+
+	// add all downloads at once, daemon has no view to sync.
+	uget_app_add_downloads ((UgetApp*) daemon,
+			(UgetNode**) dnodes.at, dnodes.length, cnode, NULL,
+			TRUE, TRUE);
+	ug_array_clear (&dnodes);
+}
+
+static void  uget_daemon_timeout_rpc (UgetDaemon* daemon)
+{
+	UgetRpcReq*  req;
+	UgetRpcCmd*  cmd;
+
+	// status of downloads for query methods
+	uget_rpc_update (daemon->rpc, (UgetApp*) daemon);
+
+	while (uget_rpc_has_request (daemon->rpc)) {
+		req = uget_rpc_get_request (daemon->rpc);
+		switch (req->method_id) {
+		case UGET_RPC_SEND_COMMAND:
+			cmd = (UgetRpcCmd*) req;
+			// control online/offline
+			if (cmd->value.ctrl.offline == 0)
+				daemon->offline = FALSE;
+			else if (cmd->value.ctrl.offline == 1)
+				daemon->offline = TRUE;
+			// add downloads quietly
+			if (cmd->uris.size > 0)
+				uget_daemon_add_uris (daemon, cmd);
+			break;
+
+		// UGET_RPC_PRESENT: no window to present
+		default:
+			break;
+		}
+		req->free (req);
+	}
+}
+
+// ----------------------------------------------------------------------------
+// Queuing
+
+static void  uget_daemon_timeout_queuing (UgetDaemon* daemon)
+{
+	int  n_active;
+
+	n_active = uget_app_grow ((UgetApp*) daemon, daemon->offline);
+	if (n_active != daemon->n_active) {
+		if (n_active > 0 && daemon->n_active == 0)
+			printf ("uget-daemon: downloading started\n");
+		else if (n_active == 0 && daemon->n_active > 0) {
+			printf ("uget-daemon: downloading stopped, %d completed, %d error\n",
+			        daemon->n_completed, daemon->n_error);
+			daemon->n_error = 0;
+			daemon->n_completed = 0;
+		}
+		fflush (stdout);
+	}
+
+	// adjust speed limit every 1 seconds
+	if (n_active > 0 && (daemon->n_counts & 1))
+		uget_task_adjust_speed (&daemon->task);
+
+	uget_app_trim ((UgetApp*) daemon, NULL);
+	daemon->n_moved = 0;   // reset counter
+	daemon->n_active = n_active;
+}
+
+// ----------------------------------------------------------------------------
+// main ()
+
+int  main (int argc, char** argv)
+{
+	UgetDaemon*  daemon;
+	UgetRpc*     rpc;
+	char*        dir;
+
+	// Command line
+	if (ug_args_find_version (argc-1, argv+1)) {
+		printf ("uGet " PACKAGE_VERSION " daemon" "\n");
+		return EXIT_SUCCESS;
+	}
+	if (ug_args_find_help (argc-1, argv+1)) {
+		ug_option_entry_print_help (uget_option_entry,
+		                            argv[0], "[URL]", NULL);
+		return EXIT_SUCCESS;
+	}
+
+	// JSON-RPC server
+	dir = uget_daemon_get_config_dir ();
+	rpc = uget_rpc_new (NULL);
+#ifdef USE_UNIX_DOMAIN_SOCKET
+	rpc->backup_dir = ug_build_filename (dir, "RPC-socket", NULL);
+	uget_rpc_use_unix_socket (rpc, rpc->backup_dir, -1);
+	ug_free (rpc->backup_dir);
+#endif
+	rpc->backup_dir = ug_build_filename (dir, "attachment", NULL);
+	ug_create_dir_all (rpc->backup_dir, -1);
+	ug_free (dir);
+	if (uget_rpc_start_server (rpc, TRUE))
+		uget_rpc_send_command (rpc, argc-1, argv+1);
+	else {
+		// uget-gtk or other daemon is running, pass arguments to it.
+		uget_rpc_send_command (rpc, argc-1, argv+1);
+		uget_rpc_free (rpc);
+		return EXIT_SUCCESS;
+	}
+
+	daemon = ug_malloc0 (sizeof (UgetDaemon));
+	uget_daemon_init (daemon, rpc);
+
+	// signal handler
+	signal (SIGINT,  sys_signal_handler);
+	signal (SIGTERM, sys_signal_handler);
+#if !(defined _WIN32 || defined _WIN64)
+	// RPC clients may close connection before response is written.
+	signal (SIGPIPE, SIG_IGN);
+#endif
+
+	while (daemon_quitting == 0) {
+		uget_daemon_timeout_rpc (daemon);
+		uget_daemon_timeout_queuing (daemon);
+		if (++daemon->n_counts % UGET_DAEMON_AUTOSAVE == 0)
+			uget_daemon_save (daemon);
+		ug_sleep (UGET_DAEMON_INTERVAL);
+	}
+
+	uget_daemon_quit (daemon);
+	uget_daemon_final (daemon);
+	ug_free (daemon);
+
+	// sleep 1 second to wait thread and shutdown RPC
+	ug_sleep (1000);
+	uget_rpc_free (rpc);
+#if !(defined _WIN32 || defined _WIN64)
+	sync ();
+#endif
+
+	return EXIT_SUCCESS;
+}
@@ -129,7 +129,8 @@ const UgEntry  Test3Entry[] =
 
 void  test3_init(Test3* t3);
 
-const UgDataInfo  Test3Info =
+// not const, test_slot() register it
+UgDataInfo  Test3Info =
 {
 	"Test3",
 	sizeof(Test3),
@@ -167,6 +168,24 @@ void  test_info(UgInfo* info)
 	printf("ug_info_realloc (Test3Info) : %d\n", ((Test3*)data)->type);
 }
 
+void  test_slot(void)
+{
+	UgInfo* info;
+	void*   data;
+
+	puts("\n--- test_slot:");
+	printf("ug_info_register_slot (Test3Info) : %d\n",
+	       ug_info_register_slot(&Test3Info));
+	info = ug_info_new(8, 1);
+	data = ug_info_realloc(info, &Test2Info);
+	data = ug_info_realloc(info, &Test3Info);
+	printf("Test3Info in slot : %s\n",
+	       (info->at[0].data == data && info->length == 2) ? "yes" : "no");
+	printf("ug_info_get (Test3Info) : %d\n",
+	       ((Test3*)ug_info_get(info, &Test3Info))->type);
+	ug_info_unref(info);
+}
+
 void  parse_info(UgInfo* info)
 {
 	int     code;
@@ -288,6 +307,7 @@ int   main(void)
 	dump_info(&info);
 	write_info_to_file(&info, "test-info.json");
 	ug_info_final(&info);
+	test_slot();
 
 	return 0;
 }
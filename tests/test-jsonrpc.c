@@ -35,18 +35,25 @@
  */
 
 #include <stdio.h>
+#include <string.h>
+#include <stdlib.h>    // atoi()
+#include <UgString.h>
+#include <UgUtil.h>
+#include <UgStdio.h>
 #include <UgSocket.h>
 #include <UgJsonrpc.h>
 #include <UgJsonrpcCurl.h>
 #include <UgJsonrpcSocket.h>
 
 #include <UgetAria2.h>
+#include <UgetRpc.h>
 #include <curl/curl.h>
 
 #if defined _WIN32 || defined _WIN64
 #include <winsock2.h>
 #else
 #include <unistd.h>    // sleep()
+#include <fcntl.h>     // open()
 #endif
 
 #if defined _WIN32 || defined _WIN64
@@ -346,6 +353,338 @@ void test_jsonrpc_socket (void)
 	ug_socket_server_unref (server);
 }
 
+static void jsonrpc_requested (UgJsonrpc* jrpc, int type,
+                               UgJsonrpcObject* jobj, UgJsonrpcArray* jarray,
+                               void* data)
+{
+	if (type != UG_JSON_OBJECT)
+		return;
+	ug_jsonrpc_object_clear_request (jobj);
+	jobj->result.type = UG_VALUE_STRING;
+	jobj->result.c.string = ug_strdup ("pong");
+	ug_jsonrpc_response (jrpc, jobj);
+	ug_jsonrpc_object_clear (jobj);
+}
+
+void test_jsonrpc_socket_poll (void)
+{
+	UgJsonrpcObject* request;
+	UgJsonrpcObject* response;
+	UgJsonrpcSocket* jclient;
+	UgSocketServer*  server;
+	SOCKET           stalled;
+	char             buf[256];
+	const char*      half1 = "{\"jsonrpc\":\"2.0\",\"id\":\"a{\",";
+	const char*      half2 = "\"method\":\"ping\"}  {\"jsonrpc\":\"2.0\",\"id\":7,\"method\":\"ping\"}";
+	int              n;
+
+	puts ("----- test_jsonrpc_socket_poll()");
+
+	server = ug_socket_server_new_addr ("127.0.0.1", "14778");
+	if (server == NULL) {
+		puts ("failed to create UgJsonrpcSocketServer");
+		return;
+	}
+	ug_socket_server_poll_jsonrpc (server, jsonrpc_requested, NULL);
+	ug_sleep (100);
+
+	// this client send half of request and stall
+	stalled = socket (AF_INET, SOCK_STREAM, 0);
+	ug_socket_connect (stalled, "127.0.0.1", "14778");
+	send (stalled, half1, strlen (half1), 0);
+
+	// other client must not be blocked by stalled client
+	jclient = ug_malloc (sizeof (UgJsonrpcSocket));
+	ug_jsonrpc_socket_init (jclient);
+	ug_jsonrpc_socket_connect (jclient, "127.0.0.1", "14778");
+	request = ug_jsonrpc_object_new ();
+	response = ug_jsonrpc_object_new ();
+	request->method_static = "ping";
+	ug_jsonrpc_call (&jclient->rpc, request, response);
+	printf ("other client get %s (expect pong)\n",
+	        (response->result.type == UG_VALUE_STRING) ?
+	        response->result.c.string : "nothing");
+	ug_jsonrpc_object_free (response);
+	ug_jsonrpc_object_free (request);
+	ug_jsonrpc_socket_close (jclient);
+	ug_jsonrpc_socket_final (jclient);
+	ug_free (jclient);
+
+	// complete request and send next request in the same packet
+	send (stalled, half2, strlen (half2), 0);
+	for (n = 0;  n < 20;  n++) {
+		ug_sleep (50);
+		if (recv (stalled, buf, sizeof (buf) - 1, MSG_PEEK | MSG_DONTWAIT) > 60)
+			break;
+	}
+	n = recv (stalled, buf, sizeof (buf) - 1, 0);
+	buf[(n > 0) ? n : 0] = 0;
+	printf ("stalled client get %s (expect 2 responses)\n", buf);
+	closesocket (stalled);
+
+	ug_socket_server_stop (server);
+	ug_socket_server_unref (server);
+	ug_sleep (1100);
+}
+
+#ifdef __linux__
+// epoll refuse regular file, server thread must fall back to select().
+static UgSocketWatch  fallback_file;
+static UgSocketWatch  fallback_client;
+static int            fallback_file_ready;
+
+static void  on_fallback_ready (UgSocketWatch* watch, int events)
+{
+	char  buf[16];
+	int   n;
+
+	if (events & UG_SOCKET_TIMEOUT) {
+		if (watch == &fallback_client)
+			closesocket (watch->socket);
+		return;
+	}
+	ug_socket_server_unwatch (watch->server, watch);
+	if (watch == &fallback_file) {
+		fallback_file_ready++;
+		return;
+	}
+	n = recv (watch->socket, buf, sizeof (buf), 0);
+	if (n > 0)
+		send (watch->socket, buf, n, 0);
+	closesocket (watch->socket);
+}
+
+static void  fallback_receiver (UgSocketServer* server,
+                                SOCKET client_fd, void* data)
+{
+	fallback_file.events = UG_SOCKET_READ;
+	ug_socket_server_watch (server, &fallback_file);
+	fallback_client.socket = client_fd;
+	fallback_client.events = UG_SOCKET_READ;
+	fallback_client.timeout = 3000;
+	fallback_client.func = on_fallback_ready;
+	ug_socket_server_watch (server, &fallback_client);
+}
+
+void test_socket_server_fallback (void)
+{
+	UgSocketServer*  server;
+	SOCKET           client;
+	char             buf[16];
+	int              n;
+
+	puts ("----- test_socket_server_fallback()");
+
+	server = ug_socket_server_new_addr ("127.0.0.1", "14779");
+	if (server == NULL) {
+		puts ("failed to create UgSocketServer");
+		return;
+	}
+	fallback_file.socket = open ("/dev/null", O_RDONLY);
+	fallback_file.func = on_fallback_ready;
+	ug_socket_server_set_receiver (server, fallback_receiver, NULL);
+	ug_socket_server_start (server);
+	ug_sleep (100);
+
+	client = socket (AF_INET, SOCK_STREAM, 0);
+	ug_socket_connect (client, "127.0.0.1", "14779");
+	send (client, "hello", 5, 0);
+	n = recv (client, buf, sizeof (buf) - 1, 0);
+	buf[(n > 0) ? n : 0] = 0;
+	ug_sleep (100);
+	printf ("select() echo %s (expect hello), file ready %d (expect 1), "
+	        "epoll closed %d (expect 1)\n",
+	        buf, fallback_file_ready, server->epoll_fd == -1);
+	closesocket (client);
+
+	ug_socket_server_stop (server);
+	ug_socket_server_unref (server);
+	ug_sleep (1100);
+	close (fallback_file.socket);
+}
+#endif // __linux__
+
+// ----------------------------------------------------------------------------
+// test_uget_rpc_query
+
+static int  count_string (const char* text, const char* str)
+{
+	int  count;
+
+	for (count = 0;  (text = strstr (text, str)) != NULL;  count++)
+		text++;
+	return count;
+}
+
+// receive data until 'str' appear or time limit expired
+static int  recv_until (SOCKET fd, char* buf, int size, const char* str)
+{
+	int  length = 0;
+	int  count;
+	int  n;
+
+	buf[0] = 0;
+	for (count = 0;  count < 40 && strstr (buf, str) == NULL;  count++) {
+		ug_sleep (50);
+		n = recv (fd, buf + length, size - length - 1, MSG_DONTWAIT);
+		if (n > 0) {
+			length += n;
+			buf[length] = 0;
+		}
+	}
+	return length;
+}
+
+// main thread of uGet call uget_rpc_update() periodically.
+static UgetRpc*  idle_urpc;
+static UgetApp*  idle_app;
+
+static UgThreadResult  update_later (void* data)
+{
+	ug_sleep (300);
+	uget_rpc_update (idle_urpc, idle_app);
+	return UG_THREAD_RESULT;
+}
+
+void test_uget_rpc_query (void)
+{
+	UgetApp*         app;
+	UgetRpc*         urpc;
+	UgetNode*        cnode;
+	UgetNode*        dnode;
+	UgetCommon*      common;
+	UgetProgress*    progress;
+	UgJsonrpcObject* request;
+	UgJsonrpcObject* response;
+	UgJsonrpcSocket* jclient;
+	UgValue*         value;
+	UgThread         thread;
+	SOCKET           subscriber;
+	char*            buf;
+	const char*      subscribe = "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"uget.subscribe\"}";
+	int              index;
+
+	puts ("----- test_uget_rpc_query()");
+
+	app = ug_malloc0 (sizeof (UgetApp));
+	uget_app_init (app);
+	cnode = uget_node_new (NULL);
+	uget_app_add_category (app, cnode, FALSE);
+	for (index = 0;  index < 3;  index++) {
+		dnode = uget_node_new (NULL);
+		common = ug_info_realloc (dnode->info, UgetCommonInfo);
+		common->uri = ug_strdup_printf ("http://example.com/%d.zip", index);
+		uget_app_add_download (app, dnode, cnode, FALSE);
+	}
+
+	urpc = uget_rpc_new (NULL);
+	if (uget_rpc_start_server (urpc, FALSE) == FALSE) {
+		puts ("failed to start UgetRpc server");
+		uget_rpc_free (urpc);
+		uget_app_final (app);
+		ug_free (app);
+		return;
+	}
+	ug_sleep (100);
+	uget_rpc_update (urpc, app);
+
+	// query
+	jclient = ug_malloc (sizeof (UgJsonrpcSocket));
+	ug_jsonrpc_socket_init (jclient);
+	ug_jsonrpc_socket_connect (jclient, "127.0.0.1", "14777");
+	request = ug_jsonrpc_object_new ();
+	response = ug_jsonrpc_object_new ();
+	request->method_static = "uget.listDownloads";
+	ug_value_init_object (&request->params, 1);
+	value = ug_value_alloc (&request->params, 1);
+	value->name = "limit";
+	value->type = UG_VALUE_INT;
+	value->c.integer = 2;
+	ug_jsonrpc_call (&jclient->rpc, request, response);
+	value = NULL;
+	if (response->result.type == UG_VALUE_OBJECT) {
+		ug_value_sort_name (&response->result);
+		value = ug_value_find_name (&response->result, "downloads");
+	}
+	printf ("uget.listDownloads get %d of %d (expect 2 of 3)\n",
+	        (value) ? value->c.array->length : -1,
+	        ug_value_get_int (ug_value_find_name (&response->result, "total")));
+	ug_value_foreach (&request->params, ug_value_set_name, NULL);
+	ug_jsonrpc_object_clear (request);
+	ug_jsonrpc_object_clear (response);
+
+	request->method_static = "uget.getSpeed";
+	ug_jsonrpc_call (&jclient->rpc, request, response);
+	if (response->result.type == UG_VALUE_OBJECT)
+		ug_value_sort_name (&response->result);
+	printf ("uget.getSpeed get queuing %d (expect 3)\n",
+	        (response->result.type == UG_VALUE_OBJECT) ?
+	        ug_value_get_int (ug_value_find_name (&response->result, "queuing")) : -1);
+	ug_jsonrpc_object_free (response);
+	ug_jsonrpc_object_free (request);
+	ug_jsonrpc_socket_close (jclient);
+	ug_jsonrpc_socket_final (jclient);
+	ug_free (jclient);
+
+	// subscription
+	buf = ug_malloc (8192);
+	subscriber = socket (AF_INET, SOCK_STREAM, 0);
+	ug_socket_connect (subscriber, "127.0.0.1", "14777");
+	send (subscriber, subscribe, strlen (subscribe), 0);
+	recv_until (subscriber, buf, 8192, "uget.onProgress");
+	printf ("subscriber get full %d, downloads %d (expect 1, 3)\n",
+	        count_string (buf, "\"full\":true"), count_string (buf, "\"uri\""));
+
+	progress = ug_info_realloc (dnode->info, UgetProgressInfo);
+	progress->complete = 100;
+	progress->generation++;
+	uget_rpc_update (urpc, app);
+	recv_until (subscriber, buf, 8192, "uget.onProgress");
+	printf ("subscriber get full %d, changed %d (expect 0, 1)\n",
+	        count_string (buf, "\"full\":true"), count_string (buf, "\"uri\""));
+
+	// new snapshot without changes, server doesn't send empty delta.
+	uget_rpc_update (urpc, app);
+	printf ("subscriber get %d bytes for unchanged downloads (expect 0)\n",
+	        recv_until (subscriber, buf, 8192, "uget.onProgress"));
+	closesocket (subscriber);
+	ug_free (buf);
+
+	// idle: nobody read snapshot, main thread doesn't rebuild it.
+	urpc->snapshot_read = ug_get_time_count () - UGET_RPC_SNAPSHOT_KEEP - 1;
+	dnode = uget_node_new (NULL);
+	uget_app_add_download (app, dnode, cnode, FALSE);
+	uget_rpc_update (urpc, app);
+	urpc->snapshot->built -= UGET_RPC_SNAPSHOT_AGE + 1;
+	// the first query after idle wait for new snapshot
+	idle_urpc = urpc;
+	idle_app = app;
+	ug_thread_create (&thread, update_later, NULL);
+	jclient = ug_malloc (sizeof (UgJsonrpcSocket));
+	ug_jsonrpc_socket_init (jclient);
+	ug_jsonrpc_socket_connect (jclient, "127.0.0.1", "14777");
+	request = ug_jsonrpc_object_new ();
+	response = ug_jsonrpc_object_new ();
+	request->method_static = "uget.listDownloads";
+	ug_jsonrpc_call (&jclient->rpc, request, response);
+	if (response->result.type == UG_VALUE_OBJECT)
+		ug_value_sort_name (&response->result);
+	printf ("uget.listDownloads after idle get total %d (expect 4)\n",
+	        (response->result.type == UG_VALUE_OBJECT) ?
+	        ug_value_get_int (ug_value_find_name (&response->result, "total")) : -1);
+	ug_thread_join (&thread);
+	ug_jsonrpc_object_free (response);
+	ug_jsonrpc_object_free (request);
+	ug_jsonrpc_socket_close (jclient);
+	ug_jsonrpc_socket_final (jclient);
+	ug_free (jclient);
+
+	uget_rpc_free (urpc);
+	ug_sleep (1100);
+	uget_app_final (app);
+	ug_free (app);
+}
+
 // ----------------------------------------------------------------------------
 // test_uget_aria2
 
@@ -424,6 +763,95 @@ void test_uget_aria2 (void)
 	ug_sleep (2000);
 }
 
+#if !(defined _WIN32 || defined _WIN64)
+// aria2 behind local Unix socket proxy. It answer one HTTP request.
+#define ARIA2_UNIX_SOCKET    "/tmp/test-aria2-unix"
+
+static UgThreadResult  aria2_unix_responder (void* data)
+{
+	SOCKET  server_fd = (SOCKET)(intptr_t) data;
+	SOCKET  client_fd;
+	char    buf[4096];
+	char    body[128];
+	char*   id;
+	int     length = 0;
+	int     n;
+
+	client_fd = accept (server_fd, NULL, NULL);
+	if (client_fd == INVALID_SOCKET)
+		return UG_THREAD_RESULT;
+	buf[0] = 0;
+	while ((id = strstr (buf, "\"id\":")) == NULL || strchr (id, ',') == NULL) {
+		n = recv (client_fd, buf + length, sizeof (buf) - length - 1, 0);
+		if (n <= 0)
+			break;
+		length += n;
+		buf[length] = 0;
+	}
+	if (id) {
+		n = snprintf (body, sizeof (body),
+		              "[{\"jsonrpc\":\"2.0\",\"id\":%d,"
+		              "\"result\":{\"version\":\"1.37.0\"}}]", atoi (id + 5));
+		length = snprintf (buf, sizeof (buf),
+		                   "HTTP/1.1 200 OK\r\n"
+		                   "Content-Type: application/json\r\n"
+		                   "Content-Length: %d\r\n"
+		                   "Connection: close\r\n\r\n%s", n, body);
+		send (client_fd, buf, length, 0);
+	}
+	closesocket (client_fd);
+	return UG_THREAD_RESULT;
+}
+
+void test_uget_aria2_unix_socket (void)
+{
+	UgetAria2*        uaria2;
+	UgJsonrpcObject*  request;
+	UgJsonrpcObject*  response;
+	UgValue*          value;
+	UgThread          thread;
+	SOCKET            server_fd;
+
+	puts ("----- test_uget_aria2_unix_socket()");
+
+	ug_unlink (ARIA2_UNIX_SOCKET);
+	server_fd = socket (AF_UNIX, SOCK_STREAM, 0);
+	if (ug_socket_listen_unix (server_fd, ARIA2_UNIX_SOCKET, -1, 5) == SOCKET_ERROR) {
+		puts ("failed to listen Unix socket");
+		closesocket (server_fd);
+		return;
+	}
+	ug_thread_create (&thread, aria2_unix_responder, (void*)(intptr_t) server_fd);
+
+	// host in URI is ignored, HTTP go through Unix socket.
+	uaria2 = uget_aria2_new ();
+	uget_aria2_set_uri (uaria2, "http://localhost:1/jsonrpc");
+	uget_aria2_set_unix_socket (uaria2, ARIA2_UNIX_SOCKET);
+	uget_aria2_start_thread (uaria2);
+
+	request = uget_aria2_alloc (uaria2, TRUE, TRUE);
+	request->method_static = "aria2.getVersion";
+	uget_aria2_request (uaria2, request);
+	response = uget_aria2_respond (uaria2, request);
+	value = NULL;
+	if (response && response->result.type == UG_VALUE_OBJECT) {
+		ug_value_sort_name (&response->result);
+		value = ug_value_find_name (&response->result, "version");
+	}
+	printf ("aria2.getVersion through Unix socket get %s (expect 1.37.0)\n",
+	        (value && value->type == UG_VALUE_STRING) ? value->c.string : "nothing");
+	uget_aria2_recycle (uaria2, request);
+	uget_aria2_recycle (uaria2, response);
+
+	ug_thread_join (&thread);
+	closesocket (server_fd);
+	ug_unlink (ARIA2_UNIX_SOCKET);
+	uget_aria2_stop_thread (uaria2);
+	uget_aria2_unref (uaria2);
+	ug_sleep (1000);
+}
+#endif // ! (_WIN32 || _WIN64)
+
 // ----------------------------------------------------------------------------
 // main
 
@@ -440,7 +868,15 @@ int   main (void)
 	test_socket ();
 	test_rpc_parser ();
 	test_jsonrpc_socket ();
+	test_jsonrpc_socket_poll ();
+#ifdef __linux__
+	test_socket_server_fallback ();
+#endif
+	test_uget_rpc_query ();
 	test_jsonrpc_curl ();
+#if !(defined _WIN32 || defined _WIN64)
+	test_uget_aria2_unix_socket ();
+#endif
 	test_uget_aria2 ();
 
 	// libcurl
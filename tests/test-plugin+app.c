@@ -154,7 +154,7 @@ void  test_download(void)
 	// http options
 	http = ug_info_realloc(info, UgetHttpInfo);
 	if (referrer)
-		http->referrer = ug_strdup(referrer);
+		http->referrer = ug_str_intern(referrer);
 
 //	download_by_plugin(info, UgetPluginCurlInfo);
 //	download_by_plugin(info, UgetPluginAria2Info);
@@ -289,7 +289,7 @@ void  start_app (UgetApp* app)
 	common = ug_info_realloc (dnode->info, UgetCommonInfo);
 	common->name = ug_strdup ("Download");
 	common->uri = ug_strdup ("http://www.utorrent.com/scripts/dl.php?track=stable&build=29812&client=utorrent");
-	common->folder = ug_strdup ("D:\\Downloads");
+	common->folder = ug_str_intern ("D:\\Downloads");
 	common->debug_level = 1;
 //	common->keeping.enable = TRUE;
 //	common->keeping.uri = TRUE;
@@ -328,7 +328,7 @@ void  test_app_node (UgetApp* app)
 		dnode[count] = uget_node_new (NULL);
 		common = ug_info_realloc (dnode[count]->info, UgetCommonInfo);
 		common->uri = ug_strdup ("ftp://127.0.0.1/");
-		common->folder = ug_strdup ("D:\\Downloads");
+		common->folder = ug_str_intern ("D:\\Downloads");
 		common->keeping.enable = TRUE;
 		common->keeping.uri = FALSE;
 		common->keeping.folder = FALSE;
@@ -35,9 +35,13 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <UgArray.h>
 #include <UgetNode.h>
+#include <UgetSearch.h>
+#include <UgetApp.h>
 
 #include <UgString.h>
 #include <UgData.h>
@@ -249,6 +253,422 @@ void test_uget_node ()
 	write_node_to_file (root, "test-UgetNode.json");
 }
 
+static int  n_destroyed;
+
+static void on_node_destroy (UgetNode* node)
+{
+	n_destroyed++;
+	node->data = NULL;
+}
+
+void test_node_destroy ()
+{
+	UgetNode* root;
+	UgetNode* child;
+	UgetNode* fake;
+
+	uget_node_default_notifier.destroy = (UgNotifyFunc) on_node_destroy;
+	n_destroyed = 0;
+
+	root  = uget_node_new (NULL);
+	child = uget_node_new (NULL);
+	uget_node_append (root, child);
+	fake  = uget_node_new (child);
+	// only nodes that have user data notify destroy
+	child->data = child;
+	fake->data = fake;
+
+	uget_node_free (root);
+	printf ("destroy notified %d (expect 2)\n", n_destroyed);
+
+	uget_node_default_notifier.destroy = NULL;
+}
+
+void test_node_resort ()
+{
+	struct UgetNodeControl  control;
+	UgetNode*      root;
+	UgetNode*      child;
+	UgetProgress*  progress;
+	int            keys[] = {5, 1, 4, 2, 3};
+	int            index;
+
+	control = uget_node_default_control;
+	control.sort.compare = (UgCompareFunc) uget_node_compare_complete;
+	control.sort.reverse = FALSE;
+
+	root = uget_node_new (NULL);
+	root->control = &control;
+	for (index = 0;  index < 5;  index++) {
+		child = uget_node_new (NULL);
+		progress = ug_info_realloc (child->info, UgetProgressInfo);
+		progress->complete = keys[index];
+		uget_node_insert_sorted (root, child);
+	}
+	// change key of first node and move it to sorted position
+	child = root->children;
+	progress = ug_info_get (child->info, UgetProgressInfo);
+	progress->complete = 9;
+	index = uget_node_resort (child);
+
+	printf ("resort moved %d (expect 1), order", index);
+	for (child = root->children;  child;  child = child->next) {
+		progress = ug_info_get (child->info, UgetProgressInfo);
+		printf (" %d", (int) progress->complete);
+	}
+	printf (" (expect 2 3 4 5 9)\n");
+
+	uget_node_free (root);
+}
+
+void test_node_sort ()
+{
+	UgetNode*    root;
+	UgetNode*    child;
+	UgetCommon*  common;
+	const char*  names[] = {"b.zip", "abcdefghij", NULL, "abcdefghi", "a.zip"};
+	int          index;
+
+	root = uget_node_new (NULL);
+	for (index = 0;  index < 5;  index++) {
+		child = uget_node_new (NULL);
+		common = ug_info_realloc (child->info, UgetCommonInfo);
+		if (names[index])
+			common->name = ug_strdup (names[index]);
+		uget_node_append (root, child);
+	}
+	uget_node_sort (root, (UgCompareFunc) uget_node_compare_name, FALSE);
+
+	printf ("sorted by name:");
+	for (child = root->children;  child;  child = child->next) {
+		common = ug_info_get (child->info, UgetCommonInfo);
+		printf (" %s", (common->name) ? common->name : "(null)");
+	}
+	printf ("\n");
+
+	uget_node_free (root);
+}
+
+void test_node_compare ()
+{
+	UgetNode*      nodes[3];
+	UgetProgress*  progress;
+	const int64_t  totals[] = {5000000000LL, 1, 5000000001LL};
+	const double   ratios[] = {0.2, 0.7, 0.2};
+	int            index;
+
+	for (index = 0;  index < 3;  index++) {
+		nodes[index] = uget_node_new (NULL);
+		progress = ug_info_realloc (nodes[index]->info, UgetProgressInfo);
+		progress->total = totals[index];
+		progress->ratio = ratios[index];
+	}
+
+	// differences that don't fit in int must keep their sign
+	printf ("compare size: %d %d %d (expect 1 -1 -1)\n",
+	        uget_node_compare_size (nodes[0], nodes[1]),
+	        uget_node_compare_size (nodes[1], nodes[2]),
+	        uget_node_compare_size (nodes[0], nodes[2]));
+	printf ("compare ratio: %d %d %d (expect -1 1 0)\n",
+	        uget_node_compare_ratio (nodes[0], nodes[1]),
+	        uget_node_compare_ratio (nodes[1], nodes[2]),
+	        uget_node_compare_ratio (nodes[0], nodes[2]));
+
+	for (index = 0;  index < 3;  index++)
+		uget_node_free (nodes[index]);
+}
+
+// ----------------------------------------------------------------------------
+// UgetSearch
+
+void test_search ()
+{
+	UgetSearch*  search;
+	UgetNode*    nodes[4];
+	UgetCommon*  common;
+	UgArrayPtr   result;
+	const char*  names[] = {"Ubuntu.iso", "song.MP3", "ubuntu-src.tar.gz", "readme.txt"};
+	int          index;
+
+	search = uget_search_new ();
+	for (index = 0;  index < 4;  index++) {
+		nodes[index] = uget_node_new (NULL);
+		common = ug_info_realloc (nodes[index]->info, UgetCommonInfo);
+		common->name = ug_strdup (names[index]);
+		common->uri = ug_strdup_printf ("http://example.com/%s", names[index]);
+		uget_search_add (search, nodes[index]);
+	}
+	ug_array_init (&result, sizeof (void*), 4);
+
+	printf ("search \"ubuntu\" found %d (expect 2)\n",
+	        uget_search_find (search, "ubuntu", &result));
+	result.length = 0;
+	printf ("search \"tx\" found %d (expect 1)\n",
+	        uget_search_find (search, "tx", &result));
+
+	// rename and remove
+	common = ug_info_get (nodes[3]->info, UgetCommonInfo);
+	ug_free (common->name);
+	common->name = ug_strdup ("ubuntu-notes.txt");
+	uget_search_update (search, nodes[3]);
+	uget_search_remove (search, nodes[0]);
+	result.length = 0;
+	printf ("search \"UBUNTU-\" found %d (expect 2)\n",
+	        uget_search_find (search, "UBUNTU-", &result));
+	result.length = 0;
+	printf ("search \"example.com/ubuntu.iso\" found %d (expect 0)\n",
+	        uget_search_find (search, "example.com/ubuntu.iso", &result));
+
+	ug_array_clear (&result);
+	uget_search_free (search);
+	for (index = 0;  index < 4;  index++)
+		uget_node_free (nodes[index]);
+}
+
+// ----------------------------------------------------------------------------
+// UgetLog
+
+void test_log ()
+{
+	UgetNode*     node;
+	UgetLog*      log;
+	UgetEvent*    event;
+	unsigned int  generation;
+	int           index;
+
+	node = uget_node_new (NULL);
+	log = ug_info_realloc (node->info, UgetLogInfo);
+	generation = log->generation;
+	for (index = 0;  index < 100;  index++)
+		uget_log_add_message (log, uget_event_new_normal (0, "retry"));
+	event = uget_event_new_normal (0, "newest");
+	uget_log_add_message (log, event);
+	printf ("log messages %d (expect %d), newest at head %d (expect 1), "
+	        "generation advanced %u (expect 101)\n",
+	        (int) log->messages.size, UGET_LOG_MAX_MESSAGES,
+	        log->messages.head == (UgLink*) event,
+	        log->generation - generation);
+
+	generation = log->generation;
+	uget_log_clear_messages (log);
+	printf ("cleared messages %d, empty head %d (expect 0, 1), "
+	        "generation advanced %u (expect 1)\n",
+	        (int) log->messages.size, log->messages.head == NULL,
+	        log->generation - generation);
+
+	// list loaded from old file may be longer than limit.
+	for (index = 0;  index < UGET_LOG_MAX_MESSAGES + 5;  index++)
+		ug_list_append (&log->messages, (UgLink*) uget_event_new_normal (0, "old"));
+	event = uget_event_new_normal (0, "newest");
+	uget_log_add_message (log, event);
+	printf ("trimmed old list %d (expect %d), newest at head %d (expect 1), "
+	        "tail is old %d (expect 1)\n",
+	        (int) log->messages.size, UGET_LOG_MAX_MESSAGES,
+	        log->messages.head == (UgLink*) event,
+	        strcmp (((UgetEvent*) log->messages.tail)->string, "old") == 0);
+	uget_node_free (node);
+}
+
+// ----------------------------------------------------------------------------
+// UgetApp
+
+static int  n_inserted;
+
+static void on_node_inserted (UgetNode* node, UgetNode* sibling, UgetNode* child)
+{
+	n_inserted++;
+}
+
+static UgetNode* new_category (const char* name, const char* file_ext)
+{
+	UgetNode*      cnode;
+	UgetCategory*  category;
+	UgetCommon*    common;
+
+	cnode = uget_node_new (NULL);
+	category = ug_info_realloc (cnode->info, UgetCategoryInfo);
+	if (file_ext)
+		*(char**)ug_array_alloc (&category->file_exts, 1) = ug_strdup (file_ext);
+	common = ug_info_realloc (cnode->info, UgetCommonInfo);
+	common->name = ug_strdup (name);
+	return cnode;
+}
+
+void test_app_add_downloads ()
+{
+	UgetApp*     app;
+	UgetNode*    cnodes[2];
+	UgetNode**   dnodes;
+	UgetCommon*  common;
+	int          index, count, n_dnodes = 100000;
+
+	app = calloc (1, sizeof (UgetApp));
+	uget_app_init (app);
+	uget_app_use_uri_hash (app);
+	cnodes[0] = new_category ("Home", NULL);
+	cnodes[1] = new_category ("Archive", "zip");
+	uget_app_add_category (app, cnodes[0], FALSE);
+	uget_app_add_category (app, cnodes[1], FALSE);
+	uget_app_set_notification (app, NULL, on_node_inserted, NULL, NULL, NULL);
+
+	// every 4th URI is duplicated, 1/3 of others are *.zip
+	dnodes = ug_malloc (sizeof (UgetNode*) * n_dnodes);
+	for (index = 0;  index < n_dnodes;  index++) {
+		count = ((index & 3) == 3) ? index - 1 : index;
+		dnodes[index] = uget_node_new (NULL);
+		common = ug_info_realloc (dnodes[index]->info, UgetCommonInfo);
+		common->uri = ug_strdup_printf ("http://example.com/%d.%s",
+				count, (count & 1) ? "zip" : "iso");
+	}
+	n_inserted = 0;
+	count = uget_app_add_downloads (app, dnodes, n_dnodes, NULL, NULL,
+	                                FALSE, TRUE);
+	printf ("add downloads %d (expect %d), notified %d (expect 0)\n",
+	        count, n_dnodes / 4 * 3, n_inserted);
+	printf ("category Home %d, Archive %d (expect %d, %d)\n",
+	        cnodes[0]->n_children, cnodes[1]->n_children,
+	        n_dnodes / 2, n_dnodes / 4);
+
+	uget_app_set_notification (app, NULL, NULL, NULL, NULL, NULL);
+	ug_free (dnodes);
+	uget_app_final (app);
+	free (app);
+}
+
+static int  match_category (UgetApp* app, const char* uri, const char* file)
+{
+	UgetNode*  cnode;
+	UgUri      uuri;
+
+	ug_uri_init (&uuri, uri);
+	cnode = uget_app_match_category (app, &uuri, file);
+	if (cnode == NULL)
+		return -1;
+	return uget_node_child_position (&app->real, cnode);
+}
+
+void test_app_match_category ()
+{
+	UgetApp*       app;
+	UgetNode*      cnode;
+	UgetCategory*  category;
+	char           name[16];
+	int            index;
+
+	app = calloc (1, sizeof (UgetApp));
+	uget_app_init (app);
+	// 40 categories use 2 words of mask
+	for (index = 0;  index < 40;  index++) {
+		sprintf (name, "e%d", index);
+		cnode = new_category (name, name);
+		uget_app_add_category (app, cnode, FALSE);
+	}
+	category = ug_info_realloc (cnode->info, UgetCategoryInfo);
+	*(char**)ug_array_alloc (&category->hosts, 1) = ug_strdup ("example.com");
+	*(char**)ug_array_alloc (&category->schemes, 1) = ug_strdup ("ftp");
+
+	printf ("match %d (expect 5)\n",
+	        match_category (app, "http://www.example.com/a.e5", NULL));
+	printf ("match %d (expect 39)\n",
+	        match_category (app, "ftp://www.example.com/a.e5", NULL));
+	printf ("match %d (expect 39)\n",
+	        match_category (app, "FTP://Example.COM/a.E39", NULL));
+	printf ("match %d (expect 7)\n",
+	        match_category (app, "http://other.org/a", "b.e7"));
+	printf ("match %d (expect -1)\n",
+	        match_category (app, "http://other.org/a.e", "b.e400"));
+
+	*(char**)ug_array_alloc (&category->file_exts, 1) = ug_strdup ("e5");
+	uget_app_update_category (app, cnode);
+	printf ("match %d (expect 39)\n",
+	        match_category (app, "http://www.example.com/a.e5", NULL));
+	uget_app_move_category (app, cnode, app->real.children);
+	printf ("match %d (expect 0)\n",
+	        match_category (app, "http://www.example.com/a.e5", NULL));
+
+	uget_app_final (app);
+	free (app);
+}
+
+static UgetNode* new_download (const char* name)
+{
+	UgetNode*    dnode;
+	UgetCommon*  common;
+
+	dnode = uget_node_new (NULL);
+	common = ug_info_realloc (dnode->info, UgetCommonInfo);
+	common->name = ug_strdup (name);
+	common->uri = ug_strdup ("http://example.com/download");
+	return dnode;
+}
+
+static void print_searched (UgetApp* app)
+{
+	UgetNode*    node;
+	UgetCommon*  common;
+
+	for (node = app->searched.children;  node;  node = node->next) {
+		common = ug_info_get (node->info, UgetCommonInfo);
+		printf (" %s", common->name);
+	}
+	printf ("\n");
+}
+
+void test_app_search ()
+{
+	UgetApp*     app;
+	UgetNode*    cnodes[2];
+	UgetNode*    dnodes[3];
+	UgetCommon*  common;
+
+	app = calloc (1, sizeof (UgetApp));
+	uget_app_init (app);
+	uget_app_use_search (app);
+	cnodes[0] = new_category ("Home", NULL);
+	cnodes[1] = new_category ("Archive", NULL);
+	uget_app_add_category (app, cnodes[0], FALSE);
+	uget_app_add_category (app, cnodes[1], FALSE);
+	uget_app_add_download (app, new_download ("xubuntu.iso"), cnodes[1], FALSE);
+	dnodes[0] = new_download ("ubuntu.iso");
+	dnodes[1] = new_download ("readme.txt");
+	uget_app_add_download (app, dnodes[0], cnodes[0], FALSE);
+	uget_app_add_download (app, dnodes[1], cnodes[0], FALSE);
+
+	printf ("search \"ubuntu\" found %d (expect 2),",
+	        uget_app_search (app, "ubuntu"));
+	print_searched (app);
+	// new download and renamed download
+	dnodes[2] = new_download ("ubuntu-src.tar.gz");
+	uget_app_add_download (app, dnodes[2], cnodes[0], FALSE);
+	common = ug_info_get (dnodes[0]->info, UgetCommonInfo);
+	common->file = ug_strdup ("notes.txt");
+	uget_app_reset_download_name (app, dnodes[0]);
+	printf ("live result %d (expect 2),", app->searched.n_children);
+	print_searched (app);
+	// relinked download stays in result
+	uget_app_move_download_to (app, dnodes[2], cnodes[1]);
+	uget_app_set_sorting (app, (UgCompareFunc) uget_node_compare_name, FALSE);
+	printf ("sorted %d (expect 2),", app->searched.n_children);
+	print_searched (app);
+	uget_app_set_sorting (app, NULL, FALSE);
+	printf ("unsorted %d (expect 2),", app->searched.n_children);
+	print_searched (app);
+	// matched again, it must be in front of results of later category
+	common = ug_info_get (dnodes[0]->info, UgetCommonInfo);
+	ug_free (common->file);
+	common->file = ug_strdup ("ubuntu-live.iso");
+	uget_app_reset_download_name (app, dnodes[0]);
+	printf ("rematched first %s (expect 1),",
+	        (app->searched.children->base == dnodes[0]) ? "1" : "0");
+	print_searched (app);
+	uget_app_search (app, NULL);
+	uget_app_add_download (app, new_download ("ubuntu.txt"), cnodes[0], FALSE);
+	printf ("cleared %d (expect 0)\n", app->searched.n_children);
+
+	uget_app_final (app);
+	free (app);
+}
+
 // ----------------------------------------------------------------------------
 // UgetA2cf
 
@@ -562,6 +982,15 @@ int main (void)
 {
 //	test_uget_node ();
 //	test_fake_path ();
+	test_node_destroy ();
+	test_node_resort ();
+	test_node_sort ();
+	test_node_compare ();
+	test_search ();
+	test_log ();
+	test_app_add_downloads ();
+	test_app_match_category ();
+	test_app_search ();
 
 //	test_uget_a2cf ();
 //	test_uget_curl ();
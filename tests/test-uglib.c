@@ -44,6 +44,8 @@
 #include <UgOption.h>
 #include <UgList.h>
 #include <UgSLink.h>
+#include <UgSlab.h>
+#include <UgRankTree.h>
 #include <UgString.h>
 #include <UgHtml.h>
 
@@ -120,6 +122,13 @@ void  test_uri (void)
 		query = uquery.field_next;
 	}
 
+	// IPv6 address in square brackets
+	ug_uri_init (&uuri, "ws://[::1]:6800/jsonrpc");
+	index = ug_uri_part_host (&uuri, &query);
+	printf ("ug_uri_part_host() return '%.*s', ", index, query);
+	index = ug_uri_get_port (&uuri);
+	printf ("ug_uri_get_port() return %d\n", index);
+
 	temp = ug_strdup ("file%2020%%20100%2f%20.jpg");
 	index = ug_decode_uri (temp, -1, temp);
 	printf ("ug_decode_uri() return %d, output - '%s'\n", index, temp);
@@ -290,6 +299,121 @@ void test_slink ()
 	ug_slinks_final (&slinks);
 }
 
+// ----------------------------------------------------------------------------
+// UgSlab
+
+void  test_slab ()
+{
+	void**  objects;
+	int     index;
+	int     n_errors = 0;
+
+	puts ("\n--- test_slab:");
+	objects = ug_malloc (sizeof (void*) * 10000);
+	// fill several chunks
+	for (index = 0;  index < 10000;  index++) {
+		objects[index] = ug_slab_alloc0 (56);
+		*(int*)objects[index] = index;
+	}
+	// free every other object and allocate them again
+	for (index = 0;  index < 10000;  index += 2)
+		ug_slab_free (56, objects[index]);
+	for (index = 0;  index < 10000;  index += 2) {
+		objects[index] = ug_slab_alloc (56);
+		*(int*)objects[index] = index;
+	}
+	for (index = 0;  index < 10000;  index++) {
+		if (*(int*)objects[index] != index)
+			n_errors++;
+		ug_slab_free (56, objects[index]);
+	}
+	// larger than UG_SLAB_MAX_SIZE
+	objects[0] = ug_slab_alloc (UG_SLAB_MAX_SIZE + 1);
+	ug_slab_free (UG_SLAB_MAX_SIZE + 1, objects[0]);
+	ug_free (objects);
+	printf ("ug_slab_alloc() %d errors\n", n_errors);
+}
+
+void  test_rank_tree ()
+{
+	UgRankTree   tree;
+	UgRankNode** rnodes;
+	int          length = 0;
+	int          index;
+	int          pos;
+	int          n_errors = 0;
+
+	puts ("\n--- test_rank_tree:");
+	ug_rank_tree_init (&tree);
+	rnodes = ug_malloc (sizeof (UgRankNode*) * 3000);
+	// compare with plain array
+	for (index = 0;  index < 3000;  index++) {
+		pos = (index * 7919) % (length + 1);
+		memmove (rnodes + pos + 1, rnodes + pos, sizeof (UgRankNode*) * (length - pos));
+		if (pos < length && (index & 1))
+			rnodes[pos] = ug_rank_tree_insert (&tree, rnodes[pos+1], (void*)(intptr_t) index);
+		else
+			rnodes[pos] = ug_rank_tree_insert_at (&tree, pos, (void*)(intptr_t) index);
+		length++;
+	}
+	for (index = 0;  index < 1000;  index++) {
+		pos = (index * 104729) % length;
+		ug_rank_tree_remove (&tree, rnodes[pos]);
+		memmove (rnodes + pos, rnodes + pos + 1, sizeof (UgRankNode*) * (length - pos - 1));
+		length--;
+	}
+	if (ug_rank_tree_length (&tree) != length)
+		n_errors++;
+	for (index = 0;  index < length;  index++) {
+		if (ug_rank_tree_nth (&tree, index) != rnodes[index])
+			n_errors++;
+		if (ug_rank_node_position (rnodes[index]) != index)
+			n_errors++;
+	}
+	ug_rank_tree_clear (&tree);
+	ug_free (rnodes);
+	printf ("ug_rank_tree %d errors\n", n_errors);
+}
+
+// ----------------------------------------------------------------------------
+// UgString
+
+void  test_intern ()
+{
+	char**  interned;
+	char*   string;
+	char    buffer[16];
+	int     index;
+	int     n_errors = 0;
+
+	puts ("\n--- test_intern:");
+	string = ug_strdup ("/home/user/Downloads");
+	interned = ug_malloc (sizeof (char*) * 1000);
+	// equal strings share one copy
+	interned[0] = ug_str_intern (string);
+	interned[1] = ug_str_intern ("/home/user/Downloads");
+	interned[2] = ug_str_intern_ref (interned[0]);
+	if (interned[0] == string || interned[0] != interned[1] || interned[1] != interned[2])
+		n_errors++;
+	for (index = 0;  index < 3;  index++)
+		ug_str_unintern (interned[index]);
+	// grow the table
+	for (index = 0;  index < 1000;  index++) {
+		sprintf (buffer, "host%d", index);
+		interned[index] = ug_str_intern (buffer);
+	}
+	for (index = 0;  index < 1000;  index++) {
+		sprintf (buffer, "host%d", index);
+		if (interned[index] != ug_str_intern (buffer))
+			n_errors++;
+		ug_str_unintern (interned[index]);
+		ug_str_unintern (interned[index]);
+	}
+	ug_free (interned);
+	ug_free (string);
+	printf ("ug_str_intern() %d errors\n", n_errors);
+}
+
 // ----------------------------------------------------------------------------
 // UgUtil
 
@@ -484,6 +608,9 @@ int   main (void)
 	test_uri ();
 	test_buffer ();
 	test_slink ();
+	test_slab ();
+	test_intern ();
+	test_rank_tree ();
 //	test_launch ();
 	test_base64 ();
 	test_utility ();
@@ -18,6 +18,8 @@ LOCAL_SRC_FILES  := \
 	UgetNode-filter.c   \
 	UgetTask.c    \
 	UgetHash.c    \
+	UgetSearch.c  \
+	UgetMatcher.c \
 	UgetSite.c    \
 	UgetApp.c     \
 	UgetEvent.c   \
@@ -62,6 +62,9 @@
 #define _(x)   x
 #endif
 
+// max number of threads that parse category files in uget_app_load_categories()
+#define UGET_APP_LOADING_THREADS    4
+
 static struct UgetNodeControl  control_real =
 {
 //	NULL,                           // struct UgetNodeControl*  children;
@@ -110,12 +113,51 @@ static struct UgetNodeControl  control_mix_split =
 	uget_node_filter_mix_split,     // UgetNodeFunc             filter;
 };
 
+// uget_app_search() add fake nodes to app->searched.
+static struct UgetNodeControl  control_searched =
+{
+//	NULL,                           // struct UgetNodeControl*  children;
+	&uget_node_default_notifier,    // struct UgetNodeNotifier* notifier;
+	{NULL, FALSE},                  // struct UgetNodeSort      sort;
+	NULL,                           // UgetNodeFunc             filter;
+};
+
+// categories in app->searching add matched downloads to app->searched.
+static void  uget_app_filter_searched (UgetNode* node, UgetNode* sibling, UgetNode* child);
+static struct UgetNodeControl  control_searching =
+{
+//	NULL,                           // struct UgetNodeControl*  children;
+	&uget_node_default_notifier,    // struct UgetNodeNotifier* notifier;
+	{NULL, FALSE},                  // struct UgetNodeSort      sort;
+	uget_app_filter_searched,       // UgetNodeFunc             filter;
+};
+
+// Categories parsed by loading threads use this before they linked to UgetApp.
+// It doesn't notify user and doesn't filter anything.
+static struct UgetNodeNotifier  notifier_detached =
+{
+	NULL,   // UgetNodeFunc    inserted;
+	NULL,   // UgetNodeFunc    removed;
+	NULL,   // UgNotifyFunc    updated;
+	NULL,   // UgNotifyFunc    destroy;
+	NULL,   // void*           data;
+};
+
+static struct UgetNodeControl  control_detached =
+{
+//	NULL,                           // struct UgetNodeControl*  children;
+	&notifier_detached,             // struct UgetNodeNotifier* notifier;
+	{NULL, FALSE},                  // struct UgetNodeSort      sort;
+	NULL,                           // UgetNodeFunc             filter;
+};
+
 
 void  uget_app_init (UgetApp* app)
 {
 	UgetCommon* common;
 	UgetNode*   node;
 
+	uget_data_register_slots ();
 	// real and virtual root nodes
 	uget_node_init (&app->real, NULL);
 	uget_node_init (&app->split, &app->real);
@@ -129,6 +171,11 @@ void  uget_app_init (UgetApp* app)
 	app->sorted_split.control = &control_sorted_split;
 	app->mix.control = &control_mix;
 	app->mix_split.control = &control_mix_split;
+	// app->searching must be fake of app->real after app->split,
+	// filter of app->split should add state nodes to the front of cnode->fake
+	uget_node_init (&app->searching, &app->real);
+	app->searching.control = &control_searching;
+	app->searched.control = &control_searched;
 	// add virtual category - "All Category"
 	node = uget_node_new (NULL);
 	common = ug_info_realloc(node->info, UgetCommonInfo);
@@ -138,6 +185,8 @@ void  uget_app_init (UgetApp* app)
 	uget_task_init (&app->task);
 	ug_array_init (&app->nodes, sizeof (void*), 32);
 	app->uri_hash = NULL;
+	app->search = NULL;
+	app->matcher = uget_matcher_new ();
 	app->config_dir = NULL;
 
 	// plug-in registry
@@ -169,6 +218,8 @@ void  uget_app_final (UgetApp* app)
 	uget_task_final (&app->task);
 	uget_app_clear_plugins (app);    // clear app->plugins
 
+	uget_node_clear_children (&app->searched);
+	uget_node_clear_children (&app->searching);
 	uget_node_clear_children (&app->mix_split);
 	uget_node_clear_children (&app->mix);
 	uget_node_clear_children (&app->sorted_split);
@@ -181,6 +232,10 @@ void  uget_app_final (UgetApp* app)
 
 	uget_uri_hash_free (app->uri_hash);
 	app->uri_hash = NULL;
+	uget_search_free (app->search);
+	app->search = NULL;
+	uget_matcher_free (app->matcher);
+	app->matcher = NULL;
 	ug_free(app->config_dir);
 	app->config_dir = NULL;
 }
@@ -221,16 +276,13 @@ static int  uget_app_activate (UgetApp* app, UgetNode* cnode, UgetCategory* cate
 	for (index = 0;  index < array->length;  index++) {
 		dnode = array->at[index];
 		uget_node_updated (dnode);
+		// plug-in may change name of active download
+		uget_app_update_search (app, dnode);
 		relation = ug_info_realloc(dnode->info, UgetRelationInfo);
 		if (relation->group & UGET_GROUP_ACTIVE) {
-			// remove node and insert it again to sort node
-			if (app->mix.control->sort.compare) {
-				sibling = dnode->next;
-				uget_node_remove (cnode, dnode);
-				uget_node_clear_fake (dnode);
-				uget_node_insert (cnode, sibling, dnode);
-				app->n_moved++;
-			}
+			// move fake nodes whose sort key changed to sorted position
+			if (app->mix.control->sort.compare)
+				app->n_moved += uget_node_resort (dnode);
 			continue;
 		}
 
@@ -329,6 +381,7 @@ int   uget_app_trim(UgetApp* app, UgArrayPtr* deleted_nodes)
 		while (category->finished->n_children > category->finished_limit) {
 			dnode = category->finished->last->real;
 			uget_uri_hash_remove_download(app->uri_hash, dnode->info);
+			uget_search_remove(app->search, dnode);
 			uget_node_remove(cnode, dnode);
 			uget_node_free(dnode);
 			app->n_deleted++;
@@ -339,6 +392,7 @@ int   uget_app_trim(UgetApp* app, UgArrayPtr* deleted_nodes)
 		while (category->recycled->n_children > category->recycled_limit) {
 			dnode = category->recycled->last->real;
 			uget_uri_hash_remove_download(app->uri_hash, dnode->info);
+			uget_search_remove(app->search, dnode);
 			uget_node_remove(cnode, dnode);
 			uget_node_free(dnode);
 			app->n_deleted++;
@@ -364,27 +418,31 @@ void  uget_app_set_sorting (UgetApp* app, UgCompareFunc compare, int reversed)
 	node = app->mix.children;
 	if (app->mix.control->sort.reverse != reversed) {
 		app->mix.control->sort.reverse  = reversed;
+		app->searched.control->sort.reverse = reversed;
 		app->mix_split.control->sort.reverse = reversed;
 		app->sorted.control->sort.reverse = reversed;
 		app->sorted_split.control->sort.reverse = reversed;
 		if (app->mix.control->sort.compare == compare && compare) {
 			// reverse first category in app->mix
-			ug_node_reverse ((UgNode*) node);
+			uget_node_reverse (node);
 			// reverse each category in app->mix_split
 			for (node = app->mix_split.children;  node;  node = node->next)
-				ug_node_reverse ((UgNode*) node);
+				uget_node_reverse (node);
 			// reverse each category in app->sorted
 			for (node = app->sorted.children;  node;  node = node->next)
-				ug_node_reverse ((UgNode*) node);
+				uget_node_reverse (node);
 			// reverse each category in app->sorted_split
 			for (node = app->sorted_split.children;  node;  node = node->next)
-				ug_node_reverse ((UgNode*) node);
+				uget_node_reverse (node);
+			// reverse result of uget_app_search()
+			uget_node_reverse (&app->searched);
 			return;
 		}
 	}
 
 	if (app->mix.control->sort.compare != compare) {
 		app->mix.control->sort.compare  = compare;
+		app->searched.control->sort.compare = compare;
 		app->mix_split.control->sort.compare = compare;
 		app->sorted.control->sort.compare = compare;
 		app->sorted_split.control->sort.compare = compare;
@@ -404,6 +462,9 @@ void  uget_app_set_sorting (UgetApp* app, UgCompareFunc compare, int reversed)
 			// reorder each category in app->sorted_split
 			for (node = app->sorted_split.children;  node;  node = node->next)
 				uget_node_reorder_by_real (node, NULL);
+			// reorder result of uget_app_search()
+			for (real = app->real.last;  real;  real = real->prev)
+				uget_node_reorder_by_real (&app->searched, real);
 		}
 		else {
 			// sort first category in app->mix
@@ -417,6 +478,8 @@ void  uget_app_set_sorting (UgetApp* app, UgCompareFunc compare, int reversed)
 			// reorder each category in app->sorted_split
 			for (node = app->sorted_split.children;  node;  node = node->next)
 				uget_node_reorder_by_real (node, NULL);
+			// sort result of uget_app_search()
+			uget_node_sort (&app->searched, compare, reversed);
 		}
 	}
 }
@@ -424,11 +487,13 @@ void  uget_app_set_sorting (UgetApp* app, UgCompareFunc compare, int reversed)
 void  uget_app_set_notification (UgetApp* app, void* data,
                                  UgetNodeFunc inserted,
                                  UgetNodeFunc removed,
-                                 UgNotifyFunc updated)
+                                 UgNotifyFunc updated,
+                                 UgNotifyFunc destroy)
 {
 	uget_node_default_notifier.inserted = inserted;
 	uget_node_default_notifier.removed  = removed;
 	uget_node_default_notifier.updated  = updated;
+	uget_node_default_notifier.destroy  = destroy;
 	uget_node_default_notifier.data     = data;
 }
 
@@ -441,6 +506,8 @@ void  uget_app_add_category (UgetApp* app, UgetNode* cnode, int save_file)
 
 	uget_node_append (&app->real, cnode);
 	uget_uri_hash_add_category (app->uri_hash, cnode);
+	uget_search_add_category (app->search, cnode);
+	uget_matcher_reset (app->matcher);
 	category = ug_info_realloc (cnode->info, UgetCategoryInfo);
 	for (node = cnode->fake;  node;  node = node->peer) {
 		switch (uget_node_get_group(node)) {
@@ -498,6 +565,7 @@ int  uget_app_move_category (UgetApp* app, UgetNode* cnode, UgetNode* position)
 	if (from_nth == -1 || to_nth == -1)
 		return FALSE;
 	uget_node_move (&app->real, position, cnode);
+	uget_matcher_reset (app->matcher);
 
 	if (app->config_dir == NULL)
 		path_base = ug_strdup ("category");
@@ -539,8 +607,10 @@ void  uget_app_delete_category (UgetApp* app, UgetNode* cnode)
 
 	uget_app_stop_category (app, cnode);
 	uget_uri_hash_remove_category (app->uri_hash, cnode);
+	uget_search_remove_category (app->search, cnode);
 	uget_node_remove (&app->real, cnode);
 	uget_node_free (cnode);
+	uget_matcher_reset (app->matcher);
 
 	if (app->config_dir == NULL)
 		path_base = ug_strdup ("category");
@@ -648,74 +718,20 @@ void  uget_app_resume_category (UgetApp* app, UgetNode* cnode)
 	uget_app_clear_nodes (app);    // clear stored nodes
 }
 
-static int  ug_match_file_exts (const char* file, char** exts)
+void  uget_app_update_category (UgetApp* app, UgetNode* cnode)
 {
-	const char* beg = NULL;
-	const char* end;
-	int         index;
-
-	// get file ext
-	for (end = file + strlen (file) - 1;  end >= file;  end--) {
-		if (end[0] == '.') {
-			beg = end + 1;   // + '.'
-			break;
-		}
-	}
-
-	if (beg == NULL)
-		return -1;
-
-	for (index = 0;  *exts;  exts++, index++) {
-		if (strcasecmp (beg, *exts) == 0)
-			return index;
-	}
-	return -1;
+	// hosts, schemes, or file_exts may be changed
+	uget_matcher_reset (app->matcher);
 }
 
 UgetNode* uget_app_match_category (UgetApp* app, UgUri* uuri, const char* file)
 {
-	UgetCategory* category;
-	UgetNode*     cnode;
-	int           count;
-	struct {
-		UgetNode* cnode;
-		int       count;
-	} matched;
+	int  nth;
 
-	matched.cnode = NULL;
-	matched.count = 0;
-
-	for (cnode = app->real.children;  cnode;  cnode = cnode->next) {
-		category = ug_info_realloc (cnode->info, UgetCategoryInfo);
-		if (category == NULL)
-			continue;
-		// null-terminated
-		*(char**)ug_array_alloc (&category->hosts, 1) = NULL;
-		*(char**)ug_array_alloc (&category->schemes, 1) = NULL;
-		*(char**)ug_array_alloc (&category->file_exts, 1) = NULL;
-		category->hosts.length--;
-		category->schemes.length--;
-		category->file_exts.length--;
-		// match download and category
-		count = 0;
-		if (ug_uri_match_hosts (uuri, category->hosts.at) >= 0)
-			count++;
-		if (ug_uri_match_schemes (uuri, category->schemes.at) >= 0)
-			count++;
-		if (ug_uri_match_file_exts (uuri, category->file_exts.at) >= 0)
-			count++;
-		else if (file && ug_match_file_exts (file, category->file_exts.at) >= 0)
-			count++;
-
-		if (matched.count < count) {
-			matched.count = count;
-			matched.cnode = cnode;
-			if (matched.count == 3)
-				break;
-		}
-	}
-
-	return matched.cnode;
+	nth = uget_matcher_match (app->matcher, &app->real, uuri, file);
+	if (nth == -1)
+		return NULL;
+	return uget_node_nth_child (&app->real, nth);
 }
 
 int  uget_app_add_download_uri (UgetApp* app, const char* uri, UgetNode* cnode, int apply)
@@ -729,11 +745,15 @@ int  uget_app_add_download_uri (UgetApp* app, const char* uri, UgetNode* cnode,
 	return uget_app_add_download (app, dnode, cnode, apply);
 }
 
-int  uget_app_add_download (UgetApp* app, UgetNode* dnode, UgetNode* cnode, int apply)
+// decode name, filename, and category of new download.
+// return category that download will be added to, or NULL if no category.
+// If category doesn't match download, 'cnode_default' or first category is used.
+static UgetNode* uget_app_prepare_download (UgetApp* app, UgetNode* dnode,
+                                            UgetNode* cnode, UgetNode* cnode_default,
+                                            int apply)
 {
 	UgetRelation* relation;
 	UgetRelation* relation_c;
-	UgetNode*     sibling;
 	UgetLog*      log;
 	UgUri*        uuri;
 	char*         fattch;
@@ -758,6 +778,9 @@ int  uget_app_add_download (UgetApp* app, UgetNode* dnode, UgetNode* cnode, int
 			else
 				temp.common->name = uget_name_from_uri(uuri);
 		}
+		// match category before URI is replaced by attachment
+		if (cnode == NULL)
+			cnode = uget_app_match_category (app, uuri, temp.common->file);
 		// backup file
 		if (ug_uri_is_file(uuri)) {
 			fattch = uget_app_save_attachment(app, dnode->info,
@@ -769,11 +792,10 @@ int  uget_app_add_download (UgetApp* app, UgetNode* dnode, UgetNode* cnode, int
 			}
 		}
 		ug_free(uuri);
-		//
-		if (cnode == NULL)
-			cnode = uget_app_match_category (app, uuri, temp.common->file);
 	}
 
+	if (cnode == NULL)
+		cnode = cnode_default;
 	if (cnode == NULL)
 		cnode = app->real.children;
 	if (cnode) {
@@ -792,21 +814,102 @@ int  uget_app_add_download (UgetApp* app, UgetNode* dnode, UgetNode* cnode, int
 			if (relation_c->group & UGET_GROUP_PAUSED)
 				relation->group |= UGET_GROUP_PAUSED;
 		}
-		temp.category = ug_info_realloc (cnode->info, UgetCategoryInfo);
-		// try to insert download before finished and recycled
-		sibling = temp.category->finished->children;
-		if (sibling == NULL)
-			sibling = temp.category->recycled->children;
-		// get real sibling
-		if (sibling)
-			sibling = sibling->real;
-		uget_node_insert (cnode, sibling, dnode);
-		uget_uri_hash_add_download(app->uri_hash, dnode->info);
+	}
+	return cnode;
+}
+
+static void  uget_app_insert_download (UgetApp* app, UgetNode* dnode, UgetNode* cnode)
+{
+	UgetCategory* category;
+	UgetNode*     sibling;
+
+	category = ug_info_realloc (cnode->info, UgetCategoryInfo);
+	// try to insert download before finished and recycled
+	sibling = category->finished->children;
+	if (sibling == NULL)
+		sibling = category->recycled->children;
+	// get real sibling
+	if (sibling)
+		sibling = sibling->real;
+	// index it before app->searching filter it
+	uget_search_add(app->search, dnode);
+	uget_node_insert (cnode, sibling, dnode);
+	uget_uri_hash_add_download(app->uri_hash, dnode->info);
+}
+
+int  uget_app_add_download (UgetApp* app, UgetNode* dnode, UgetNode* cnode, int apply)
+{
+	cnode = uget_app_prepare_download (app, dnode, cnode, NULL, apply);
+	if (cnode) {
+		uget_app_insert_download (app, dnode, cnode);
 		return TRUE;
 	}
 	return FALSE;
 }
 
+int   uget_app_add_downloads (UgetApp* app, UgetNode** dnodes, int n_dnodes,
+                              UgetNode* cnode, UgetNode* cnode_default,
+                              int apply, int skip_existing)
+{
+	UgetNodeFunc  inserted;
+	UgetNode*     dnode;
+	UgetNode*     node;
+	int           index;
+	int           count;
+#ifndef NO_URI_HASH
+	UgetCommon*   common;
+	void*         uri_hash;
+
+	// UgetApp.uri_hash contains added downloads, it can filter duplicated
+	// URIs in 'dnodes'. Otherwise use temporary hash table to do this.
+	uri_hash = app->uri_hash;
+	if (skip_existing && uri_hash == NULL)
+		uri_hash = uget_uri_hash_new ();
+#endif
+
+	// inserted downloads are not notified one by one
+	inserted = uget_node_default_notifier.inserted;
+	uget_node_default_notifier.inserted = NULL;
+
+	for (count = 0, index = 0;  index < n_dnodes;  index++) {
+		dnode = dnodes[index];
+		if (dnode == NULL)
+			continue;
+#ifndef NO_URI_HASH
+		if (skip_existing) {
+			common = ug_info_get (dnode->info, UgetCommonInfo);
+			if (common && common->uri &&
+			    uget_uri_hash_find (uri_hash, common->uri))
+			{
+				uget_node_free (dnode);
+				dnodes[index] = NULL;
+				continue;
+			}
+		}
+#endif
+		node = uget_app_prepare_download (app, dnode, cnode,
+		                                  cnode_default, apply);
+		if (node == NULL) {
+			uget_node_free (dnode);
+			dnodes[index] = NULL;
+			continue;
+		}
+		uget_app_insert_download (app, dnode, node);
+#ifndef NO_URI_HASH
+		if (uri_hash != app->uri_hash)
+			uget_uri_hash_add_download (uri_hash, dnode->info);
+#endif
+		count++;
+	}
+
+	uget_node_default_notifier.inserted = inserted;
+#ifndef NO_URI_HASH
+	if (uri_hash && uri_hash != app->uri_hash)
+		uget_uri_hash_free (uri_hash);
+#endif
+	return count;
+}
+
 int   uget_app_move_download (UgetApp* app, UgetNode* dnode, UgetNode* dnode_position)
 {
 	UgetNode*  cnode;
@@ -915,6 +1018,7 @@ int  uget_app_delete_download (UgetApp* app, UgetNode* dnode, int delete_file)
 	is_active = TRUE;  // delete files in thread if program use Android SAF
 #endif
 	uget_uri_hash_remove_download(app->uri_hash, dnode->info);
+	uget_search_remove(app->search, dnode);
 	files = ug_info_set(dnode->info, UgetFilesInfo, NULL);
 	uget_node_free(dnode);
 
@@ -987,19 +1091,15 @@ int   uget_app_activate_download (UgetApp* app, UgetNode* dnode)
 		// no plug-in support
 		uget_app_queue_download (app, dnode);
 		relation->group |= UGET_GROUP_ERROR;
-		ug_list_prepend (&log->messages,
-				(UgLink*) uget_event_new_error (
+		uget_log_add_message (log,
+				uget_event_new_error (
 						UGET_EVENT_ERROR_UNSUPPORTED_SCHEME, NULL));
 		uget_node_updated (dnode);
 		return FALSE;
 	}
 	else {
 		// clear event message before starting
-		ug_list_foreach (&log->messages,
-		                 (UgForeachFunc) uget_event_free, NULL);
-		log->messages.size = 0;
-		log->messages.head = NULL;
-		log->messages.tail = NULL;
+		uget_log_clear_messages (log);
 	}
 	// start node with plug-in
 	cnode = dnode->parent;
@@ -1145,6 +1245,7 @@ void  uget_app_reset_download_name (UgetApp* app, UgetNode* dnode)
 
 	// reinsert && resort fake nodes
 	if (cnode) {
+		uget_search_update (app->search, dnode);
 //		cnode   = dnode->parent;
 		sibling = dnode->next;
 		uget_node_remove(cnode, dnode);
@@ -1153,6 +1254,118 @@ void  uget_app_reset_download_name (UgetApp* app, UgetNode* dnode)
 	}
 }
 
+// ----------------------------------------------------------------------------
+// search
+
+void  uget_app_use_search (UgetApp* app)
+{
+	UgetNode*  cnode;
+
+	if (app->search)
+		return;
+	app->search = uget_search_new ();
+	for (cnode = app->real.children;  cnode;  cnode = cnode->next)
+		uget_search_add_category (app->search, cnode);
+}
+
+// insert fake node of download to app->searched
+static void  uget_app_insert_searched (UgetApp* app, UgetNode* sibling, UgetNode* dnode)
+{
+	UgetNode*  cnode;
+	UgetNode*  fake;
+
+	if (app->searched.control->sort.compare) {
+		uget_node_insert_sorted (&app->searched, uget_node_new (dnode));
+		return;
+	}
+	// original order: find next download that has fake node in app->searched.
+	// It may be in the following categories.
+	for (cnode = dnode->parent;  ;  sibling = cnode->children) {
+		for (;  sibling;  sibling = sibling->next) {
+			for (fake = sibling->fake;  fake;  fake = fake->peer) {
+				if (fake->parent == &app->searched)
+					break;
+			}
+			if (fake) {
+				uget_node_insert (&app->searched, fake, uget_node_new (dnode));
+				return;
+			}
+		}
+		if (cnode == NULL || (cnode = cnode->next) == NULL)
+			break;
+	}
+	uget_node_append (&app->searched, uget_node_new (dnode));
+}
+
+static void  uget_app_filter_searched (UgetNode* node, UgetNode* sibling, UgetNode* child)
+{
+	UgetApp*  app;
+
+	if (node->parent == NULL) {
+		// node is root. child is category
+		uget_node_append (node, uget_node_new (child));
+	}
+	else if (node->parent->parent == NULL) {
+		// node is category. child is download
+		// node->parent is UgetApp.searching, UgetNode.data belong to UI.
+		app = (UgetApp*) ((char*) node->parent - offsetof (UgetApp, searching));
+		if (uget_search_match (app->search, child))
+			uget_app_insert_searched (app, sibling, child);
+	}
+}
+
+int   uget_app_search (UgetApp* app, const char* pattern)
+{
+	UgetNode*  dnode;
+	UgetNode*  real;
+	int        index;
+
+	uget_node_clear_children (&app->searched);
+	uget_search_set_pattern (app->search, pattern);
+	if (app->search == NULL)
+		return 0;
+
+	app->nodes.length = 0;
+	uget_search_find (app->search, pattern, &app->nodes);
+	for (index = 0;  index < app->nodes.length;  index++) {
+		dnode = app->nodes.at[index];
+		uget_node_append (&app->searched, uget_node_new (dnode));
+	}
+	uget_app_clear_nodes (app);
+
+	if (app->searched.control->sort.compare) {
+		uget_node_sort (&app->searched, app->searched.control->sort.compare,
+		                app->searched.control->sort.reverse);
+	}
+	else {
+		// the same order as categories and downloads
+		for (real = app->real.last;  real;  real = real->prev)
+			uget_node_reorder_by_real (&app->searched, real);
+	}
+	return app->searched.n_children;
+}
+
+int   uget_app_update_search (UgetApp* app, UgetNode* dnode)
+{
+	UgetNode*  fake;
+
+	dnode = dnode->base;
+	if (uget_search_update (app->search, dnode) == FALSE)
+		return FALSE;
+
+	for (fake = dnode->fake;  fake;  fake = fake->peer) {
+		if (fake->parent == &app->searched)
+			break;
+	}
+	if (uget_search_match (app->search, dnode)) {
+		if (fake == NULL)
+			uget_app_insert_searched (app, dnode->next, dnode);
+	}
+	else if (fake)
+		uget_node_free (fake);
+	return TRUE;
+}
+
 #ifndef NO_URI_HASH
 void  uget_app_use_uri_hash (UgetApp* app)
 {
@@ -1482,7 +1695,8 @@ int   uget_app_save_category_fd (UgetApp* app, UgetNode* cnode, int fd, void* js
 	else
 		jfile = jsonfile;
 
-	if (ug_json_file_begin_write_fd (jfile, fd, UG_JSON_FORMAT_ALL) == FALSE) {
+	// category file may be very large, don't indent it.
+	if (ug_json_file_begin_write_fd (jfile, fd, UG_JSON_FORMAT_UTF8) == FALSE) {
 		if (jsonfile == NULL)
 			ug_json_file_free (jfile);
 		return FALSE;
@@ -1498,47 +1712,68 @@ int   uget_app_save_category_fd (UgetApp* app, UgetNode* cnode, int fd, void* js
 	return TRUE;
 }
 
-UgetNode* uget_app_load_category_fd (UgetApp* app, int fd, void* jsonfile)
+// parse category file to detached UgetNode. It doesn't touch UgetApp,
+// so it can be called by loading threads.
+static UgetNode* uget_app_parse_category_fd (int fd, UgJsonFile* jfile)
 {
-	UgJsonFile*  jfile;
-	UgJsonError  error;
 	UgetNode*    cnode;
 
-	if (jsonfile == NULL)
-		jfile = ug_json_file_new (4096);
-	else
-		jfile = jsonfile;
-
-	if (ug_json_file_begin_parse_fd (jfile, fd) == FALSE) {
-		if (jsonfile == NULL)
-			ug_json_file_free (jfile);
-		return FALSE;
-	}
+	if (ug_json_file_begin_parse_fd (jfile, fd) == FALSE)
+		return NULL;
 
 	cnode = uget_node_new (NULL);
+	cnode->control = &control_detached;
 	ug_json_push (&jfile->json, ug_json_parse_entry,
 			cnode, (void*)UgetNodeEntry);
 	ug_json_push (&jfile->json, ug_json_parse_object,
 			NULL, NULL);
 
-	error = ug_json_file_end_parse (jfile);
-	if (jsonfile == NULL)
-		ug_json_file_free (jfile);
-
-	if (error == UG_JSON_ERROR_NONE) {
-		uget_app_add_category (app, cnode, FALSE);
-		// create fake node
-		uget_node_make_fake (cnode);
-		// move all downloads from active to queuing in this category
-		uget_app_stop_category (app, cnode);
-		// convert old format to new
-		remove_file_node(cnode);
-		return cnode;
-	}
-	else {
+	if (ug_json_file_end_parse (jfile) != UG_JSON_ERROR_NONE) {
 		uget_node_free (cnode);
 		return NULL;
 	}
+	return cnode;
+}
+
+// link parsed category to UgetApp. This must run in main thread.
+static void  uget_app_attach_category (UgetApp* app, UgetNode* cnode)
+{
+	UgetNode*  dnode;
+	UgetNode*  fnode;
+
+	// children use default control after they linked to UgetApp
+	for (dnode = cnode->children;  dnode;  dnode = dnode->next) {
+		dnode->control = &uget_node_default_control;
+		for (fnode = dnode->children;  fnode;  fnode = fnode->next)
+			fnode->control = &uget_node_default_control;
+	}
+
+	uget_app_add_category (app, cnode, FALSE);
+	// create fake node
+	uget_node_make_fake (cnode);
+	// move all downloads from active to queuing in this category
+	uget_app_stop_category (app, cnode);
+	// convert old format to new
+	remove_file_node(cnode);
+}
+
+UgetNode* uget_app_load_category_fd (UgetApp* app, int fd, void* jsonfile)
+{
+	UgJsonFile*  jfile;
+	UgetNode*    cnode;
+
+	if (jsonfile == NULL)
+		jfile = ug_json_file_new (4096);
+	else
+		jfile = jsonfile;
+
+	cnode = uget_app_parse_category_fd (fd, jfile);
+	if (jsonfile == NULL)
+		ug_json_file_free (jfile);
+
+	if (cnode)
+		uget_app_attach_category (app, cnode);
+	return cnode;
 }
 
 int   uget_app_save_categories (UgetApp* app, const char* folder)
@@ -1580,19 +1815,55 @@ int   uget_app_save_categories (UgetApp* app, const char* folder)
 		ug_free (path_new);
 		ug_free (path);
 	}
+	// flush renamed files to disk
+	ug_sync_dir (path_base);
 
 	ug_free (path_base);
 	ug_json_file_free (jfile);
 	return count;
 }
 
+// used by uget_app_load_categories()
+struct UgetAppLoading
+{
+	UgMutex     mutex;
+	int         index;     // next file to parse
+	int         length;
+	struct {
+		int        fd;
+		UgetNode*  cnode;
+	} *at;
+};
+
+// used by uget_app_load_categories()
+static UgThreadResult  uget_app_loading_thread (struct UgetAppLoading* loading)
+{
+	UgJsonFile*  jfile;
+	int          index;
+
+	jfile = ug_json_file_new (4096);
+	for (;;) {
+		ug_mutex_lock (&loading->mutex);
+		index = loading->index++;
+		ug_mutex_unlock (&loading->mutex);
+		if (index >= loading->length)
+			break;
+		loading->at[index].cnode = uget_app_parse_category_fd (
+				loading->at[index].fd, jfile);
+	}
+	ug_json_file_free (jfile);
+	return UG_THREAD_RESULT;
+}
+
 int   uget_app_load_categories (UgetApp* app, const char* folder)
 {
 	int             count, fd;
+	int             n_threads;
 	char*           path;
 	char*           path_base;
 	char*           path_temp;
-	UgJsonFile*     jfile;
+	UgThread        threads[UGET_APP_LOADING_THREADS];
+	struct UgetAppLoading  loading;
 
 	if (folder)
 		path_base = ug_build_filename (folder, "category", NULL);
@@ -1601,8 +1872,10 @@ int   uget_app_load_categories (UgetApp* app, const char* folder)
 	else
 		path_base = ug_strdup ("category");
 
-	jfile = ug_json_file_new (4096);
-
+	// open all category files first. Files must be attached in order.
+	loading.at = NULL;
+	loading.index = 0;
+	loading.length = 0;
 	for (count = 0;  ;  count++) {
 #if defined _WIN32 || defined _WIN64
 		path = ug_strdup_printf ("%s%c%.4d.json", path_base, '\\', count);
@@ -1623,11 +1896,35 @@ int   uget_app_load_categories (UgetApp* app, const char* folder)
 		if (fd == -1)
 			break;
 
-		uget_app_load_category_fd (app, fd, jfile);
+		if ((count & 15) == 0)
+			loading.at = ug_realloc (loading.at, sizeof (*loading.at) * (count + 16));
+		loading.at[count].fd = fd;
+		loading.at[count].cnode = NULL;
+		loading.length++;
 	}
-
-	ug_json_file_free (jfile);
 	ug_free (path_base);
+
+	// parse categories in loading threads and current thread
+	ug_mutex_init (&loading.mutex);
+	for (n_threads = 0;  n_threads < UGET_APP_LOADING_THREADS;  n_threads++) {
+		if (n_threads >= loading.length - 1)
+			break;
+		if (ug_thread_create (&threads[n_threads],
+				(UgThreadFunc) uget_app_loading_thread, &loading) != UG_THREAD_OK)
+			break;
+	}
+	uget_app_loading_thread (&loading);
+	while (n_threads > 0)
+		ug_thread_join (&threads[--n_threads]);
+	ug_mutex_clear (&loading.mutex);
+
+	// attach categories in order
+	for (count = 0;  count < loading.length;  count++) {
+		if (loading.at[count].cnode)
+			uget_app_attach_category (app, loading.at[count].cnode);
+	}
+
+	ug_free (loading.at);
 	return count;
 }
 
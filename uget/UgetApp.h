@@ -43,6 +43,8 @@
 #include <UgetTask.h>
 #include <UgetPlugin.h>
 #include <UgetHash.h>
+#include <UgetSearch.h>
+#include <UgetMatcher.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -60,12 +62,16 @@ typedef struct  UgetApp          UgetApp;
 	UgetNode        sorted_split;   \
 	UgetNode        mix;            \
 	UgetNode        mix_split;      \
+	UgetNode        searched;       \
+	UgetNode        searching;      \
 	UgRegistry      infos;          \
 	UgRegistry      plugins;        \
 	UgetPluginInfo* plugin_default; \
 	UgetTask        task;           \
 	UgArrayPtr      nodes;          \
 	void*           uri_hash;       \
+	UgetSearch*     search;         \
+	UgetMatcher*    matcher;        \
 	char*           config_dir;     \
 	int             n_error;        \
 	int             n_moved;        \
@@ -82,12 +88,16 @@ struct UgetApp
 	UgetNode        sorted_split;   // virtual root
 	UgetNode        mix;            // virtual root
 	UgetNode        mix_split;      // virtual root
+	UgetNode        searched;       // virtual root for uget_app_search()
+	UgetNode        searching;      // virtual root, filter downloads to searched
 	UgRegistry      infos;
 	UgRegistry      plugins;
 	UgetPluginInfo* plugin_default;
 	UgetTask        task;
 	UgArrayPtr      nodes;
 	void*           uri_hash;
+	UgetSearch*     search;         // index for uget_app_search()
+	UgetMatcher*    matcher;        // for uget_app_match_category()
 	char*           config_dir;
 	int             n_error;        // uget_app_grow() will count these value:
 	int             n_moved;        // n_error, n_moved, n_deleted, and
@@ -111,7 +121,8 @@ void  uget_app_set_sorting (UgetApp* app, UgCompareFunc func, int reversed);
 void  uget_app_set_notification (UgetApp* app, void* data,
                                  UgetNodeFunc inserted,
                                  UgetNodeFunc removed,
-                                 UgNotifyFunc updated);
+                                 UgNotifyFunc updated,
+                                 UgNotifyFunc destroy);
 
 // category functions
 // uget_app_move_category() return TRUE or FALSE
@@ -121,11 +132,25 @@ void  uget_app_delete_category (UgetApp* app, UgetNode* cnode);
 void  uget_app_stop_category (UgetApp* app, UgetNode* cnode);
 void  uget_app_pause_category (UgetApp* app, UgetNode* cnode);
 void  uget_app_resume_category (UgetApp* app, UgetNode* cnode);
+// call this after hosts, schemes, or file_exts of category was changed.
+void  uget_app_update_category (UgetApp* app, UgetNode* cnode);
 UgetNode* uget_app_match_category (UgetApp* app, UgUri* uuri, const char* file);
 
 // download functions: return TRUE or FALSE
 int   uget_app_add_download_uri (UgetApp* app, const char* uri, UgetNode* cnode, int apply);
 int   uget_app_add_download (UgetApp* app, UgetNode* dnode, UgetNode* cnode, int apply);
+// add many downloads at once. If 'cnode' is NULL, category of download is
+// matched by URI and file; unmatched downloads are added to 'cnode_default'
+// (or first category if it is NULL).
+// If 'skip_existing' is TRUE, skip downloads whose URI has been added or
+// appears earlier in 'dnodes'.
+// Skipped downloads are freed and replaced by NULL in 'dnodes'.
+// Inserted downloads are not notified one by one, user must sync views after
+// this function return.
+// return number of added downloads.
+int   uget_app_add_downloads (UgetApp* app, UgetNode** dnodes, int n_dnodes,
+                              UgetNode* cnode, UgetNode* cnode_default,
+                              int apply, int skip_existing);
 int   uget_app_move_download (UgetApp* app, UgetNode* dnode, UgetNode* dnode_position);
 int   uget_app_move_download_to (UgetApp* app, UgetNode* dnode, UgetNode* cnode);
 int   uget_app_delete_download (UgetApp* app, UgetNode* dnode, int delete_file);
@@ -135,6 +160,17 @@ int   uget_app_pause_download (UgetApp* app, UgetNode* dnode);
 int   uget_app_queue_download (UgetApp* app, UgetNode* dnode);
 void  uget_app_reset_download_name (UgetApp* app, UgetNode* dnode);
 
+// search functions
+// uget_app_use_search() create index of name, URI, and folder.
+// uget_app_search() replace children of app->searched by fake nodes of
+// downloads that contain 'pattern' and return number of them. Inserted or
+// relinked downloads that contain 'pattern' will be added to app->searched.
+// uget_app_update_search() re-index download if it's name, URI, or folder
+// changed without relinking, it return TRUE if download was re-indexed.
+void  uget_app_use_search (UgetApp* app);
+int   uget_app_search (UgetApp* app, const char* pattern);
+int   uget_app_update_search (UgetApp* app, UgetNode* dnode);
+
 #ifdef NO_URI_HASH
 #define uget_app_use_uri_hash(app)
 #define uget_app_save_attachment(app, info, file, rename)
@@ -204,8 +240,8 @@ struct AppMethod
 		{ uget_app_set_config_dir((UgetApp*)this, dir); }
 	inline void  setSorting(UgCompareFunc func, int reversed)
 		{ uget_app_set_sorting((UgetApp*)this, func, reversed); }
-	inline void  setNotification(void* data, UgetNodeFunc inserted, UgetNodeFunc removed, UgNotifyFunc updated)
-		{ uget_app_set_notification((UgetApp*)this, data, inserted, removed, updated); }
+	inline void  setNotification(void* data, UgetNodeFunc inserted, UgetNodeFunc removed, UgNotifyFunc updated, UgNotifyFunc destroy = NULL)
+		{ uget_app_set_notification((UgetApp*)this, data, inserted, removed, updated, destroy); }
 
 	inline void  addCategory(UgetNode* cnode, int saveFile)
 		{ uget_app_add_category((UgetApp*)this, cnode, saveFile); }
@@ -219,6 +255,8 @@ struct AppMethod
 		{ uget_app_pause_category((UgetApp*)this, cnode); }
 	inline void  resumeCategory(UgetNode* cnode)
 		{ uget_app_resume_category((UgetApp*)this, cnode); }
+	inline void  updateCategory(UgetNode* cnode)
+		{ uget_app_update_category((UgetApp*)this, cnode); }
 	inline UgetNode*  matchCategory(UgUri* uuri, const char* file)
 		{ return uget_app_match_category((UgetApp*)this, uuri, file); }
 
@@ -226,6 +264,10 @@ struct AppMethod
 		{ return uget_app_add_download_uri((UgetApp*)this, uri, cnode, apply); }
 	inline int   addDownload(UgetNode* dnode, UgetNode* cnode, int apply)
 		{ return uget_app_add_download((UgetApp*)this, dnode, cnode, apply); }
+	inline int   addDownloads(UgetNode** dnodes, int n_dnodes, UgetNode* cnode,
+	                          UgetNode* cnode_default, int apply, int skip_existing)
+		{ return uget_app_add_downloads((UgetApp*)this, dnodes, n_dnodes, cnode,
+		                                cnode_default, apply, skip_existing); }
 	inline int   moveDownload(UgetNode* dnode, UgetNode* dnode_position)
 		{ return uget_app_move_download((UgetApp*)this, dnode, dnode_position); }
 	inline int   moveDownloadTo(UgetNode* dnode, UgetNode* cnode)
@@ -245,6 +287,10 @@ struct AppMethod
 
 	inline void  useUriHash(void)
 		{ uget_app_use_uri_hash((UgetApp*)this); }
+	inline void  useSearch(void)
+		{ uget_app_use_search((UgetApp*)this); }
+	inline int   search(const char* pattern)
+		{ return uget_app_search((UgetApp*)this, pattern); }
 	inline void  clearAttachment(void)
 		{ uget_app_clear_attachment((UgetApp*)this); }
 
@@ -39,6 +39,8 @@
 #include <UgUri.h>
 #include <UgUtil.h>
 #include <UgJsonrpcCurl.h>
+#include <UgJsonrpcWebsocket.h>
+#include <UgSocket.h>     // INVALID_SOCKET
 #include <UgetAria2.h>
 #include <curl/curl.h>
 
@@ -54,15 +56,13 @@
 #define RPC_URI              "http://localhost:6800/jsonrpc"
 #define RPC_BATCH_LEN        5
 #define RPC_INTERVAL         500
+#define RPC_STATUS_NUM       1000    // num of aria2.tellWaiting, aria2.tellStopped
+#define RPC_WEBSOCKET_RETRY  5000    // millisecond interval between connecting
+#define RPC_WAIT_SLICE       50      // millisecond
+#define RPC_LIMIT_LEN        16      // "%dK" of int needs 13 bytes
 #define ARIA2_PATH           "aria2c"
 #define ARIA2_ARGS           "--enable-rpc=true -D --check-certificate=false"
 
-#if defined _WIN32 || defined _WIN64
-#define  ug_sleep                 Sleep
-#else
-#define  ug_sleep(millisecond)    usleep (millisecond * 1000)
-#endif
-
 #ifdef _MSC_VER
 #define strcasecmp   stricmp
 #define strncasecmp  strnicmp
@@ -78,11 +78,25 @@ struct UgetAria2Thread
 	UgJsonrpcArray   queuing;
 	UgJsonrpcArray   request;
 	UgJsonrpcArray   response;
+	UgJsonrpcArray   spare;     // cleared objects for parser of responses
+	UgJsonrpcArray   status;    // status requests, they are reused.
+	UgJsonrpcObject* limit;     // aria2.changeGlobalOption, it is reused.
+	UgJsonrpcObject* speed;     // aria2.getGlobalStat, it is reused.
 	UgJsonrpcCurl    json;
 	int              finalized;
+	// aria2 serves WebSocket on the same port and path as HTTP. It pushes
+	// notifications when download start, stop, complete...etc
+	UgJsonrpcWebsocket  websocket;
+	uint64_t         websocket_time;    // last time of connecting
+	UgJsonrpc*       rpc;               // &json.rpc or &websocket.rpc
+	char*            uri;
+	// watchers that are called by uget_aria2_thread_status()
+	UG_ARRAY (UgetAria2Watch)  watches;
 };
 
 static UgThreadResult  uget_aria2_thread (UgetAria2Thread* uathread);
+static void  uget_aria2_thread_set_uri (UgetAria2Thread* uathread, const char* uri);
+static void  uget_aria2_clear_status_request (UgJsonrpcObject* req);
 
 static UgetAria2Thread* uget_aria2_thread_new (UgetAria2* uaria2)
 {
@@ -94,9 +108,21 @@ static UgetAria2Thread* uget_aria2_thread_new (UgetAria2* uaria2)
 	ug_jsonrpc_array_init (&uat->queuing, 16);
 	ug_jsonrpc_array_init (&uat->request, 16);
 	ug_jsonrpc_array_init (&uat->response, 16);
+	ug_jsonrpc_array_init (&uat->spare, 16);
+	ug_jsonrpc_array_init (&uat->status, 3);
+	uat->limit = NULL;
+	uat->speed = NULL;
 	ug_jsonrpc_curl_init (&uat->json);
-	ug_jsonrpc_curl_set_url (&uat->json, uaria2->uri);
+	ug_jsonrpc_websocket_init (&uat->websocket);
+	uat->json.rpc.spare = &uat->spare;
+	uat->websocket.rpc.spare = &uat->spare;
+	uat->uri = NULL;
+	ug_mutex_lock (&uaria2->mutex);
+	ug_jsonrpc_curl_set_unix_socket (&uat->json, uaria2->unix_socket);
+	uget_aria2_thread_set_uri (uat, uaria2->uri);
+	ug_mutex_unlock (&uaria2->mutex);
 	uat->finalized = FALSE;
+	ug_array_init (&uat->watches, sizeof (UgetAria2Watch), 16);
 
 	uget_aria2_ref (uaria2);
 	ug_thread_create (&thread, (UgThreadFunc) uget_aria2_thread, uat);
@@ -110,10 +136,94 @@ static void uget_aria2_thread_free (UgetAria2Thread* uat)
 	ug_jsonrpc_array_clear (&uat->queuing, TRUE);
 	ug_jsonrpc_array_clear (&uat->request, TRUE);
 	ug_jsonrpc_array_clear (&uat->response, TRUE);
+	ug_array_foreach_ptr (&uat->status,
+			(UgForeachFunc) uget_aria2_clear_status_request, NULL);
+	ug_array_foreach_ptr (&uat->status,
+			(UgForeachFunc) ug_jsonrpc_object_free, NULL);
+	ug_array_clear (&uat->status);
+	if (uat->limit) {
+		ug_value_foreach (&uat->limit->params, ug_value_set_name, NULL);
+		ug_jsonrpc_object_free (uat->limit);
+	}
+	if (uat->speed)
+		ug_jsonrpc_object_free (uat->speed);
+	ug_array_foreach_ptr (&uat->spare,
+			(UgForeachFunc) ug_jsonrpc_object_free, NULL);
+	ug_array_clear (&uat->spare);
 	ug_jsonrpc_curl_final (&uat->json);
+	ug_jsonrpc_websocket_final (&uat->websocket);
+	ug_array_clear (&uat->watches);
+	ug_free (uat->uri);
 	ug_free (uat);
 }
 
+static void  uget_aria2_thread_set_uri (UgetAria2Thread* uathread, const char* uri)
+{
+	char*  http_uri;
+
+	ug_free (uathread->uri);
+	uathread->uri = ug_strdup (uri);
+	// HTTP is used before WebSocket connected. "ws://" to "http://",
+	// "wss://" to "https://"
+	if (strncasecmp (uri, "ws:", 3) == 0 || strncasecmp (uri, "wss:", 4) == 0) {
+		http_uri = ug_strdup_printf ("http%s", uri + 2);
+		ug_jsonrpc_curl_set_url (&uathread->json, http_uri);
+		ug_free (http_uri);
+	}
+	else
+		ug_jsonrpc_curl_set_url (&uathread->json, uri);
+
+	ug_jsonrpc_websocket_close (&uathread->websocket);
+	uathread->websocket_time = 0;
+	uathread->rpc = &uathread->json.rpc;
+}
+
+static void  uget_aria2_thread_connect (UgetAria2Thread* uathread)
+{
+	uint64_t  time_count;
+
+	if (uathread->rpc == &uathread->websocket.rpc) {
+		if (uathread->websocket.socket != INVALID_SOCKET)
+			return;
+		// WebSocket was disconnected, use HTTP until it reconnect.
+		uathread->rpc = &uathread->json.rpc;
+	}
+	// UgJsonrpcWebsocket doesn't support "wss://" (TLS) and Unix socket.
+	if (uathread->json.unix_socket)
+		return;
+	if (strncasecmp (uathread->uri, "ws:", 3)   != 0 &&
+	    strncasecmp (uathread->uri, "http:", 5) != 0)
+	{
+		return;
+	}
+
+	time_count = ug_get_time_count ();
+	if (uathread->websocket_time &&
+	    time_count - uathread->websocket_time < RPC_WEBSOCKET_RETRY)
+	{
+		return;
+	}
+	uathread->websocket_time = time_count;
+	if (ug_jsonrpc_websocket_connect (&uathread->websocket, uathread->uri))
+		uathread->rpc = &uathread->websocket.rpc;
+}
+
+// return number of notifications from aria2, e.g. "aria2.onDownloadStart",
+// "aria2.onDownloadComplete", "aria2.onDownloadError"...etc
+static int  uget_aria2_thread_notified (UgetAria2Thread* uathread)
+{
+	UgJsonrpcArray*  notifications;
+	int  index;
+	int  counts;
+
+	notifications = &uathread->websocket.notifications;
+	counts = notifications->length;
+	for (index = 0;  index < counts;  index++)
+		ug_jsonrpc_object_free (notifications->at[index]);
+	notifications->length = 0;
+	return counts;
+}
+
 static int  uget_aria2_thread_queuing (UgetAria2Thread* uathread)
 {
 	UgetAria2*  uaria2;
@@ -165,7 +275,10 @@ static void  uget_aria2_match_response (UgetAria2Thread* uathread)
 		}
 	}
 	uathread->request.length = 0;
-	uaria2->completed_changed++;
+	// wake up threads that are waiting in uget_aria2_respond()
+	ug_mutex_lock (&uaria2->completed_mutex);
+	ug_cond_broadcast (&uaria2->completed_cond);
+	ug_mutex_unlock (&uaria2->completed_mutex);
 
 	length = uathread->response.length;
 	for (index_res = 0;  index_res < length;  index_res++) {
@@ -176,6 +289,21 @@ static void  uget_aria2_match_response (UgetAria2Thread* uathread)
 	uathread->response.length = 0;
 }
 
+// move recycled objects to UgetAria2Thread.spare, parser of batch response
+// takes objects from it instead of allocating new one.
+static void  uget_aria2_thread_reserve (UgetAria2Thread* uathread, int n_objects)
+{
+	UgetAria2*  uaria2;
+
+	uaria2 = uathread->uaria2;
+	ug_mutex_lock (&uaria2->mutex);
+	while (uathread->spare.length < n_objects && uaria2->recycled.length > 0) {
+		*(UgJsonrpcObject**) ug_array_alloc (&uathread->spare, 1) =
+				uaria2->recycled.at[--uaria2->recycled.length];
+	}
+	ug_mutex_unlock (&uaria2->mutex);
+}
+
 static int  uget_aria2_thread_request (UgetAria2Thread* uathread)
 {
 	UgJsonrpcObject*  ujobj;
@@ -184,30 +312,33 @@ static int  uget_aria2_thread_request (UgetAria2Thread* uathread)
 	int  length;
 	int  limit;
 	int  counts;
+	int  n_responses;
 
 	uaria2 = uathread->uaria2;
 	limit  = uaria2->batch_len + uaria2->batch_additional;
-	for (index = 0;  index < uathread->queuing.length;  index++) {
+	for (index = 0;  index < uathread->queuing.length;  ) {
 		length = uathread->queuing.length - index;
 		if (length > limit)
 			length = limit;
 		ug_array_alloc (&uathread->request, length);
 
-		for (counts = 0;  counts < length;  counts++) {
+		for (n_responses = 0, counts = 0;  counts < length;  counts++) {
 			ujobj = uathread->queuing.at[index++];
 			uathread->request.at[counts] = ujobj;
-			if (ujobj->id.type != UG_VALUE_NONE) {
-				ujobj = uget_aria2_alloc (uaria2, FALSE, FALSE);
-				*(void**) ug_array_alloc (&uathread->response, 1) = ujobj;
-			}
+			if (ujobj->id.type != UG_VALUE_NONE)
+				n_responses++;
 		}
+		uget_aria2_thread_reserve (uathread, n_responses);
 
 		// JSON-RPC
-		counts = ug_jsonrpc_call_batch (&uathread->json.rpc,
+		counts = ug_jsonrpc_call_batch (uathread->rpc,
 				&uathread->request, &uathread->response);
 		if (counts == -1) {
 			uaria2->error = TRUE;
 			uaria2->connect_fail = TRUE;
+			// WebSocket was disconnected, send other requests by HTTP.
+			if (uathread->rpc == &uathread->websocket.rpc)
+				uathread->rpc = &uathread->json.rpc;
 		}
 
 		uget_aria2_match_response (uathread);
@@ -217,32 +348,77 @@ static int  uget_aria2_thread_request (UgetAria2Thread* uathread)
 	return index;
 }
 
-static UgJsonrpcObject*  add_limit_request (UgetAria2* uaria2)
+// return TRUE if request has current secret token.
+static int  uget_aria2_has_token (UgetAria2* uaria2, UgJsonrpcObject* req)
+{
+	UgValue*  value;
+	char*     token = NULL;
+	int       result;
+
+	if (req->params.type == UG_VALUE_ARRAY && req->params.c.array->length > 0) {
+		value = req->params.c.array->at;
+		if (value->type == UG_VALUE_STRING && value->c.string != NULL &&
+		    strncmp (value->c.string, "token:", 6) == 0)
+		{
+			token = value->c.string;
+		}
+	}
+
+	ug_mutex_lock (&uaria2->mutex);
+	if (token && uaria2->token)
+		result = (strcmp (token, uaria2->token) == 0);
+	else
+		result = (token == uaria2->token);
+	ug_mutex_unlock (&uaria2->mutex);
+	return result;
+}
+
+// limit request stay allocated, it is rebuilt only if secret token was
+// changed. Otherwise limits are written to it's strings in place.
+static UgJsonrpcObject*  add_limit_request (UgetAria2Thread* uathread)
 {
+	UgetAria2*        uaria2;
 	UgJsonrpcObject*  jobj;
 	UgValue*          vobj;
 	UgValue*          value;
 
-	jobj = uget_aria2_alloc (uaria2, TRUE, TRUE);
-	jobj->method_static = "aria2.changeGlobalOption";
-	if (jobj->params.type == UG_VALUE_NONE)
-		ug_value_init_array (&jobj->params, 2);
-	vobj = ug_value_alloc (&jobj->params, 1);
-	ug_value_init_object (vobj, 2);
+	uaria2 = uathread->uaria2;
+	jobj = uathread->limit;
+	if (jobj && uget_aria2_has_token (uaria2, jobj) == FALSE) {
+		ug_value_foreach (&jobj->params, ug_value_set_name, NULL);
+		uget_aria2_recycle (uaria2, jobj);
+		jobj = NULL;
+	}
 
-	value = ug_value_alloc (vobj, 1);
-	value->name = "max-overall-download-limit";
-	value->type = UG_VALUE_STRING;
-	value->c.string = ug_strdup_printf ("%dK", uaria2->limit.download / 1024);
-	value = ug_value_alloc (vobj, 1);
-	value->name = "max-overall-upload-limit";
-	value->type = UG_VALUE_STRING;
-	value->c.string = ug_strdup_printf ("%dK", uaria2->limit.upload / 1024);
-	// max-concurrent-downloads must >= 1
-//	value = ug_value_alloc (vobj, 1);
-//	value->name = "max-concurrent-downloads";
-//	value->type = UG_VALUE_STRING;
-//	value->c.string = ug_strdup_printf ("%u", uaria2->limit.connections);
+	if (jobj == NULL) {
+		jobj = uget_aria2_alloc (uaria2, TRUE, TRUE);
+		jobj->method_static = "aria2.changeGlobalOption";
+		if (jobj->params.type == UG_VALUE_NONE)
+			ug_value_init_array (&jobj->params, 2);
+		vobj = ug_value_alloc (&jobj->params, 1);
+		ug_value_init_object (vobj, 2);
+
+		value = ug_value_alloc (vobj, 1);
+		value->name = "max-overall-download-limit";
+		value->type = UG_VALUE_STRING;
+		value->c.string = ug_malloc (RPC_LIMIT_LEN);
+		value = ug_value_alloc (vobj, 1);
+		value->name = "max-overall-upload-limit";
+		value->type = UG_VALUE_STRING;
+		value->c.string = ug_malloc (RPC_LIMIT_LEN);
+		// max-concurrent-downloads must >= 1
+//		value = ug_value_alloc (vobj, 1);
+//		value->name = "max-concurrent-downloads";
+//		value->type = UG_VALUE_STRING;
+//		value->c.string = ug_strdup_printf ("%u", uaria2->limit.connections);
+		uathread->limit = jobj;
+	}
+
+	// params = [secret, ]options
+	vobj = jobj->params.c.array->at + jobj->params.c.array->length - 1;
+	value = vobj->c.object->at;
+	snprintf (value[0].c.string, RPC_LIMIT_LEN, "%dK", uaria2->limit.download / 1024);
+	snprintf (value[1].c.string, RPC_LIMIT_LEN, "%dK", uaria2->limit.upload / 1024);
 
 	uget_aria2_request (uaria2, jobj);
 	return jobj;
@@ -252,18 +428,28 @@ static void recycle_limit_request (UgetAria2* uaria2, UgJsonrpcObject* jreq)
 {
 	UgJsonrpcObject*  jres;
 
+	// request is kept by UgetAria2Thread.limit
 	jres = uget_aria2_respond (uaria2, jreq);
-	ug_value_foreach (&jreq->params, ug_value_set_name, NULL);
-	uget_aria2_recycle (uaria2, jreq);
 	uget_aria2_recycle (uaria2, jres);
 }
 
-static UgJsonrpcObject*  add_speed_request (UgetAria2* uaria2)
+static UgJsonrpcObject*  add_speed_request (UgetAria2Thread* uathread)
 {
+	UgetAria2*        uaria2;
 	UgJsonrpcObject*  jobj;
 
-	jobj = uget_aria2_alloc (uaria2, TRUE, TRUE);
-	jobj->method_static = "aria2.getGlobalStat";
+	uaria2 = uathread->uaria2;
+	jobj = uathread->speed;
+	if (jobj && uget_aria2_has_token (uaria2, jobj) == FALSE) {
+		uget_aria2_recycle (uaria2, jobj);
+		jobj = NULL;
+	}
+
+	if (jobj == NULL) {
+		jobj = uget_aria2_alloc (uaria2, TRUE, TRUE);
+		jobj->method_static = "aria2.getGlobalStat";
+		uathread->speed = jobj;
+	}
 
 	uget_aria2_request (uaria2, jobj);
 	return jobj;
@@ -282,17 +468,284 @@ static void  recycle_speed_request (UgetAria2* uaria2, UgJsonrpcObject* jreq)
 		value = ug_value_find_name (&jres->result, "uploadSpeed");
 		uaria2->speed.upload = ug_value_get_int (value);
 	}
-	uget_aria2_recycle (uaria2, jreq);
+	// request is kept by UgetAria2Thread.speed
 	uget_aria2_recycle (uaria2, jres);
 }
 
+// ----------------------------------------------------------------------------
+// status poller
+
+static const char* status_methods[] =
+{
+	"aria2.tellActive",     // aria2.tellActive([secret, ]keys)
+	"aria2.tellWaiting",    // aria2.tellWaiting([secret, ]offset, num, keys)
+	"aria2.tellStopped",    // aria2.tellStopped([secret, ]offset, num, keys)
+};
+
+static void  uget_aria2_clear_status_request (UgJsonrpcObject* req)
+{
+	UgValueArray*  array;
+
+	// last parameter is keys array from UgetAria2.status_keys
+	if (req->params.type == UG_VALUE_ARRAY) {
+		array = req->params.c.array;
+		array->at[array->length - 1].type = UG_VALUE_NONE;
+		array->at[array->length - 1].c.array = NULL;
+	}
+	ug_jsonrpc_object_clear (req);
+}
+
+// status requests stay allocated between polling,
+// they are rebuilt only if secret token was changed.
+static void  uget_aria2_thread_prepare_status (UgetAria2Thread* uathread)
+{
+	UgetAria2*        uaria2;
+	UgJsonrpcObject*  req;
+	UgValue*          value;
+	char*             token = NULL;
+	int  index;
+
+	uaria2 = uathread->uaria2;
+	ug_mutex_lock (&uaria2->mutex);
+	if (uathread->status.length > 0) {
+		// aria2.tellActive([secret, ]keys)
+		req = uathread->status.at[0];
+		if (req->params.c.array->length == 2)
+			token = req->params.c.array->at[0].c.string;
+		if ((token && uaria2->token) ? strcmp (token, uaria2->token) == 0 :
+		                               token == uaria2->token)
+		{
+			ug_mutex_unlock (&uaria2->mutex);
+			return;
+		}
+	}
+
+	for (index = 0;  index < 3;  index++) {
+		if (index < uathread->status.length) {
+			req = uathread->status.at[index];
+			uget_aria2_clear_status_request (req);
+		}
+		else {
+			req = ug_jsonrpc_object_new ();
+			*(UgJsonrpcObject**) ug_array_alloc (&uathread->status, 1) = req;
+		}
+		req->method_static = status_methods[index];
+		req->id.type = UG_VALUE_INT;
+		ug_value_init_array (&req->params, 4);
+		if (uaria2->token) {
+			value = ug_value_alloc (&req->params, 1);
+			value->type = UG_VALUE_STRING;
+			value->c.string = ug_strdup (uaria2->token);
+		}
+		if (index > 0) {
+			value = ug_value_alloc (&req->params, 2);
+			// offset -1: stopped downloads are listed in reverse order,
+			//            newest one is the first.
+			value[0].type = UG_VALUE_INT;
+			value[0].c.integer = (index == 1) ? 0 : -1;
+			value[1].type = UG_VALUE_INT;
+			value[1].c.integer = RPC_STATUS_NUM;
+		}
+		// keys array from UgetAria2.status_keys
+		value = ug_value_alloc (&req->params, 1);
+		value->type = UG_VALUE_ARRAY;
+		value->c.array = uaria2->status_keys.c.array;
+	}
+	ug_mutex_unlock (&uaria2->mutex);
+}
+
+// add status in response of 'req' to UgetAria2.statuses.
+// return number of downloads in response, return -1 if no response.
+static int  uget_aria2_thread_add_status (UgetAria2Thread* uathread,
+                                          UgJsonrpcObject* req)
+{
+	UgetAria2Status*  status;
+	UgJsonrpcObject*  res;
+	UgValueArray*     array;
+	UgValue*          value;
+	int  index;
+
+	res = ug_jsonrpc_array_find (&uathread->response, &req->id, NULL);
+	if (res == NULL || res->error.code != 0 ||
+	    res->result.type != UG_VALUE_ARRAY)
+	{
+		return -1;
+	}
+	array = res->result.c.array;
+	for (index = 0;  index < array->length;  index++) {
+		ug_value_sort_name (array->at + index);
+		value = ug_value_find_name (array->at + index, "gid");
+		if (value == NULL || value->type != UG_VALUE_STRING)
+			continue;
+		status = ug_array_alloc (&uathread->uaria2->statuses, 1);
+		status->gid = value->c.string;
+		status->value = array->at + index;
+	}
+	return array->length;
+}
+
+// aria2.tellWaiting and aria2.tellStopped return at most RPC_STATUS_NUM
+// downloads. If list is full, get next pages until it is not full, otherwise
+// watchers will take missing downloads as removed.
+// return FALSE if connection failed.
+static int  uget_aria2_thread_status_pages (UgetAria2Thread* uathread,
+                                            UgJsonrpcObject* req)
+{
+	UgJsonrpcObject*  res;
+	UgValueArray*     array;
+	UgValue*          offset;
+	int  origin;
+	int  result = TRUE;
+
+	// params: [secret, ]offset, num, keys
+	array = req->params.c.array;
+	offset = array->at + array->length - 3;
+	origin = offset->c.integer;
+	do {
+		// negative offset: stopped downloads are listed in reverse order.
+		offset->c.integer += (origin < 0) ? -RPC_STATUS_NUM : RPC_STATUS_NUM;
+		uget_aria2_thread_reserve (uathread, 1);
+		if (uathread->spare.length > 0)
+			res = uathread->spare.at[--uathread->spare.length];
+		else
+			res = ug_jsonrpc_object_new ();
+		// responses are recycled after watchers were called.
+		*(UgJsonrpcObject**) ug_array_alloc (&uathread->response, 1) = res;
+		if (ug_jsonrpc_call (uathread->rpc, req, res) == -1) {
+			result = FALSE;
+			break;
+		}
+	} while (uget_aria2_thread_add_status (uathread, req) == RPC_STATUS_NUM);
+	offset->c.integer = origin;
+	return result;
+}
+
+static void  uget_aria2_thread_status (UgetAria2Thread* uathread)
+{
+	UgetAria2*        uaria2;
+	UgetAria2Watch*   watch;
+	UgJsonrpcObject*  req;
+	UgJsonrpcObject*  res;
+	int  index;
+	int  counts;
+
+	uaria2 = uathread->uaria2;
+	ug_mutex_lock (&uaria2->watch_mutex);
+	counts = uaria2->watches.length;
+	ug_mutex_unlock (&uaria2->watch_mutex);
+	if (counts == 0)
+		return;
+
+	// one batch for all downloads instead of aria2.tellStatus for each gid
+	uget_aria2_thread_prepare_status (uathread);
+	uget_aria2_thread_reserve (uathread, uathread->status.length);
+	counts = ug_jsonrpc_call_batch (uathread->rpc,
+			&uathread->status, &uathread->response);
+	// status request can be sent again if WebSocket was disconnected.
+	if (counts == -1 && uathread->rpc == &uathread->websocket.rpc) {
+		uathread->rpc = &uathread->json.rpc;
+		counts = ug_jsonrpc_call_batch (uathread->rpc,
+				&uathread->status, &uathread->response);
+	}
+
+	uaria2->statuses.length = 0;
+	if (counts == -1) {
+		uaria2->error = TRUE;
+		uaria2->connect_fail = TRUE;
+	}
+	else {
+		uaria2->connect_fail = FALSE;
+		for (index = 0;  index < uathread->status.length;  index++) {
+			req = uathread->status.at[index];
+			counts = uget_aria2_thread_add_status (uathread, req);
+			// aria2.tellWaiting and aria2.tellStopped
+			if (index > 0 && counts == RPC_STATUS_NUM &&
+			    uget_aria2_thread_status_pages (uathread, req) == FALSE)
+			{
+				uaria2->statuses.length = 0;
+				uaria2->error = TRUE;
+				uaria2->connect_fail = TRUE;
+				break;
+			}
+		}
+		qsort (uaria2->statuses.at, uaria2->statuses.length,
+		       sizeof (UgetAria2Status), ug_array_compare_string);
+	}
+
+	// take all watchers, other thread may add watcher while calling them.
+	ug_mutex_lock (&uaria2->watch_mutex);
+	ug_array_append (&uathread->watches, uaria2->watches.at,
+	                 uaria2->watches.length);
+	uaria2->watches.length = 0;
+	ug_mutex_unlock (&uaria2->watch_mutex);
+	// pass status to watchers, keep watcher if it return TRUE.
+	for (counts = 0, index = 0;  index < uathread->watches.length;  index++) {
+		watch = uathread->watches.at + index;
+		if (watch->func (watch->data, uaria2))
+			uathread->watches.at[counts++] = *watch;
+	}
+	uathread->watches.length = counts;
+	ug_mutex_lock (&uaria2->watch_mutex);
+	ug_array_append (&uaria2->watches, uathread->watches.at,
+	                 uathread->watches.length);
+	ug_mutex_unlock (&uaria2->watch_mutex);
+	uathread->watches.length = 0;
+	uaria2->statuses.length = 0;
+
+	// responses are reused by next polling
+	for (index = 0;  index < uathread->response.length;  index++) {
+		res = uathread->response.at[index];
+		ug_jsonrpc_object_clear (res);
+		*(UgJsonrpcObject**) ug_array_alloc (&uathread->spare, 1) = res;
+	}
+	uathread->response.length = 0;
+}
+
+// ----------------------------------------------------------------------------
+// thread of UgetAria2
+
+// wait for polling_interval, return early if request was queued or aria2 sent
+// notification.
+static void  uget_aria2_thread_wait (UgetAria2Thread* uathread)
+{
+	UgetAria2*  uaria2;
+	uint64_t    time_end;
+	int         queued;
+
+	uaria2 = uathread->uaria2;
+	if (uathread->rpc == &uathread->websocket.rpc) {
+		// select() can't be woken by condition variable, wait in slices.
+		time_end = ug_get_time_count () + uaria2->polling_interval;
+		do {
+			// notified or disconnected
+			if (ug_jsonrpc_websocket_wait (&uathread->websocket, RPC_WAIT_SLICE) != 0)
+				break;
+			ug_mutex_lock (&uaria2->mutex);
+			queued = uaria2->queuing.length;
+			ug_mutex_unlock (&uaria2->mutex);
+		} while (queued == 0 && ug_get_time_count () < time_end);
+		// avoid busy loop if WebSocket was disconnected
+		if (uathread->websocket.socket != INVALID_SOCKET)
+			return;
+	}
+
+	ug_mutex_lock (&uaria2->mutex);
+	if (uaria2->queuing.length == 0) {
+		ug_cond_wait_timeout (&uaria2->queuing_cond, &uaria2->mutex,
+		                      uaria2->polling_interval);
+	}
+	ug_mutex_unlock (&uaria2->mutex);
+}
+
 static UgThreadResult  uget_aria2_thread (UgetAria2Thread* uathread)
 {
 	UgetAria2*       uaria2;
 	UgJsonrpcObject* jreq = NULL;
 	UgJsonrpcObject* jobj = NULL;
 	UgJsonrpcObject* jreq_shutdown = NULL;
+	uint64_t  status_time = 0;
 	int  counts;
+	int  queued;
 
 	uaria2 = uathread->uaria2;
 //	temp.index = ug_jsonrpc_array_find_ptr (uaria2);
@@ -313,42 +766,56 @@ static UgThreadResult  uget_aria2_thread (UgetAria2Thread* uathread)
 		ug_mutex_lock (&uaria2->mutex);
 		if (uaria2->uri_changed) {
 			uaria2->uri_changed = FALSE;
-			ug_jsonrpc_curl_set_url (&uathread->json, uaria2->uri);
+			ug_jsonrpc_curl_set_unix_socket (&uathread->json,
+			                                 uaria2->unix_socket);
+			uget_aria2_thread_set_uri (uathread, uaria2->uri);
 		}
 		ug_mutex_unlock (&uaria2->mutex);
+		// use WebSocket if aria2 accept it.
+		uget_aria2_thread_connect (uathread);
 
 		// additional request
 		if (uaria2->limit_count_prev != uaria2->limit_count) {
 			uaria2->limit_count_prev  = uaria2->limit_count;
 			uaria2->limit_required = TRUE;
-			jreq = add_limit_request (uaria2);
+			jreq = add_limit_request (uathread);
 			uaria2->batch_additional++;
 		}
 		if (uaria2->speed_required && (counts & 2) == 2) {
-			jobj = add_speed_request (uaria2);
+			jobj = add_speed_request (uathread);
 			uaria2->batch_additional++;
 		}
 
 		// get requests from queue
-		if (uget_aria2_thread_queuing (uathread) == 0) {
-			// default: sleep 0.5 second
-			ug_sleep (uaria2->polling_interval);
-			continue;
+		queued = uget_aria2_thread_queuing (uathread);
+		if (queued > 0) {
+			// send requests & get responses
+			uget_aria2_thread_request (uathread);
+
+			// recycle additional request
+			if (uaria2->limit_required) {
+				uaria2->limit_required = FALSE;
+				recycle_limit_request (uaria2, jreq);
+				uaria2->batch_additional--;
+			}
+			if (uaria2->speed_required && (counts & 2) == 2) {
+				recycle_speed_request (uaria2, jobj);
+				uaria2->batch_additional--;
+			}
 		}
 
-		// send requests & get responses
-		uget_aria2_thread_request (uathread);
-
-		// recycle additional request
-		if (uaria2->limit_required) {
-			uaria2->limit_required = FALSE;
-			recycle_limit_request (uaria2, jreq);
-			uaria2->batch_additional--;
-		}
-		if (uaria2->speed_required && (counts & 2) == 2) {
-			recycle_speed_request (uaria2, jobj);
-			uaria2->batch_additional--;
+		// status of all downloads for watchers.
+		// Don't wait for polling interval if aria2 notified.
+		if (uget_aria2_thread_notified (uathread) > 0 ||
+		    ug_get_time_count () - status_time >= uaria2->polling_interval)
+		{
+			status_time = ug_get_time_count ();
+			uget_aria2_thread_status (uathread);
 		}
+
+		// default: wait 0.5 second
+		if (queued == 0)
+			uget_aria2_thread_wait (uathread);
 	}
 
 	// shutdown response
@@ -389,17 +856,24 @@ UgetAria2* uget_aria2_new (void)
 	uaria2->args = ug_strdup (ARIA2_ARGS);
 	ug_mutex_init (&uaria2->mutex);
 	ug_mutex_init (&uaria2->completed_mutex);
+	ug_cond_init (&uaria2->completed_cond);
+	ug_cond_init (&uaria2->queuing_cond);
+	ug_mutex_init (&uaria2->watch_mutex);
+	ug_array_init (&uaria2->watches, sizeof (UgetAria2Watch), 16);
+	ug_array_init (&uaria2->statuses, sizeof (UgetAria2Status), 64);
 
 	ug_jsonrpc_array_init (&uaria2->queuing,  16);
 	ug_jsonrpc_array_init (&uaria2->recycled, 16);
 	ug_slinks_init (&uaria2->requested, 16);
 	ug_slinks_init (&uaria2->responsed, 16);
-	uaria2->completed_changed = 0;
 
 	ug_value_init_array (&uaria2->status_keys, 16);
 	keys = &uaria2->status_keys;
 	value = ug_value_alloc (keys, 1);
 	value->type = UG_VALUE_STRING;
+	value->c.string = "gid";
+	value = ug_value_alloc (keys, 1);
+	value->type = UG_VALUE_STRING;
 	value->c.string = "status";
 	value = ug_value_alloc (keys, 1);
 	value->type = UG_VALUE_STRING;
@@ -447,11 +921,17 @@ void uget_aria2_unref (UgetAria2* uaria2)
 		ug_value_foreach (&uaria2->status_keys, ug_value_set_string, NULL);
 		ug_value_clear (&uaria2->status_keys);
 
+		ug_array_clear (&uaria2->watches);
+		ug_array_clear (&uaria2->statuses);
+		ug_mutex_clear (&uaria2->watch_mutex);
+		ug_cond_clear (&uaria2->queuing_cond);
+		ug_cond_clear (&uaria2->completed_cond);
 		ug_mutex_clear (&uaria2->completed_mutex);
 		ug_mutex_clear (&uaria2->mutex);
 		ug_free (uaria2->uri);
 		ug_free (uaria2->path);
 		ug_free (uaria2->args);
+		ug_free (uaria2->unix_socket);
 		ug_free (uaria2);
 
 		curl_global_cleanup ();
@@ -521,7 +1001,17 @@ void uget_aria2_set_token (UgetAria2* uaria2, const char* token)
 {
 	ug_mutex_lock (&uaria2->mutex);
 	ug_free (uaria2->token);
-	uaria2->token = (token) ? ug_strdup (token) : NULL;
+	uaria2->token = (token) ? ug_strdup_printf ("token:%s", token) : NULL;
+	ug_mutex_unlock (&uaria2->mutex);
+}
+
+void uget_aria2_set_unix_socket (UgetAria2* uaria2, const char* path)
+{
+	ug_mutex_lock (&uaria2->mutex);
+	ug_free (uaria2->unix_socket);
+	uaria2->unix_socket = (path) ? ug_strdup (path) : NULL;
+	// thread of UgetAria2 will apply it with URI.
+	uaria2->uri_changed = TRUE;
 	ug_mutex_unlock (&uaria2->mutex);
 }
 
@@ -699,10 +1189,7 @@ UgJsonrpcObject*  uget_aria2_alloc (UgetAria2* uaria2, int is_request, int has_r
 			ug_value_init_array (&result->params, 4);
 			rpc_token = ug_value_alloc (&result->params, 1);
 			rpc_token->type = UG_VALUE_STRING;
-			rpc_token->c.string = ug_malloc (strlen (uaria2->token) + 7); // "token:"
-			rpc_token->c.string[0] = 0;
-			strcat (rpc_token->c.string, "token:");
-			strcat (rpc_token->c.string, uaria2->token);
+			rpc_token->c.string = ug_strdup (uaria2->token);
 		}
 		ug_mutex_unlock (&uaria2->mutex);
 	}
@@ -716,45 +1203,63 @@ void  uget_aria2_request (UgetAria2* uaria2, UgJsonrpcObject* request)
 {
 	ug_mutex_lock (&uaria2->mutex);
 	*(UgJsonrpcObject**)ug_array_alloc (&uaria2->queuing, 1) = request;
+	// wake up thread of UgetAria2 if it is waiting for requests
+	ug_cond_signal (&uaria2->queuing_cond);
 	ug_mutex_unlock (&uaria2->mutex);
 }
 
-UgJsonrpcObject*  uget_aria2_respond (UgetAria2* uaria2, UgJsonrpcObject* request)
+// remove request and it's response from completed list.
+// return FALSE if request has not been responded.
+// caller must lock UgetAria2.completed_mutex
+static int  uget_aria2_take_response (UgetAria2* uaria2, UgJsonrpcObject* request,
+                                      UgJsonrpcObject** response)
 {
-	UgJsonrpcObject* response = NULL;
 	UgSLink*  prev_response;
 	UgSLink*  prev;
-	UgSLink*  link = NULL;
-	int       completed_changed = 0;
+	UgSLink*  link;
+
+	link = ug_slinks_find (&uaria2->requested, request, &prev);
+	if (link) {
+		// remove request
+		if (prev)
+			prev_response = uaria2->responsed.at + (prev - uaria2->requested.at);
+		else
+			prev_response = NULL;
+		// get response & remove it
+		response[0] = (UgJsonrpcObject*)
+				uaria2->responsed.at[link - uaria2->requested.at].data;
+		ug_slinks_remove (&uaria2->requested, request,  prev);
+		ug_slinks_remove (&uaria2->responsed, response[0], prev_response);
+	}
 
-	while (link == NULL) {
-		while (completed_changed == uaria2->completed_changed) {
-			// default: sleep 0.5 second
-			ug_sleep (uaria2->polling_interval);
-			continue;
-		}
+	return (link) ? TRUE : FALSE;
+}
 
-		ug_mutex_lock (&uaria2->completed_mutex);
-		link = ug_slinks_find (&uaria2->requested, request, &prev);
-		if (link) {
-			// remove request
-			if (prev)
-				prev_response = uaria2->responsed.at + (prev - uaria2->requested.at);
-			else
-				prev_response = NULL;
-			// get response & remove it
-			response = (UgJsonrpcObject*)
-					uaria2->responsed.at[link - uaria2->requested.at].data;
-			ug_slinks_remove (&uaria2->requested, request,  prev);
-			ug_slinks_remove (&uaria2->responsed, response, prev_response);
-		}
-		completed_changed = uaria2->completed_changed;
-		ug_mutex_unlock (&uaria2->completed_mutex);
-	}
+UgJsonrpcObject*  uget_aria2_respond (UgetAria2* uaria2, UgJsonrpcObject* request)
+{
+	UgJsonrpcObject* response = NULL;
+
+	// uget_aria2_match_response() broadcast after responses were added.
+	ug_mutex_lock (&uaria2->completed_mutex);
+	while (uget_aria2_take_response (uaria2, request, &response) == FALSE)
+		ug_cond_wait (&uaria2->completed_cond, &uaria2->completed_mutex);
+	ug_mutex_unlock (&uaria2->completed_mutex);
 
 	return response;
 }
 
+int  uget_aria2_try_respond (UgetAria2* uaria2, UgJsonrpcObject* request,
+                             UgJsonrpcObject** response)
+{
+	int  responded;
+
+	*response = NULL;
+	ug_mutex_lock (&uaria2->completed_mutex);
+	responded = uget_aria2_take_response (uaria2, request, response);
+	ug_mutex_unlock (&uaria2->completed_mutex);
+	return responded;
+}
+
 void  uget_aria2_recycle (UgetAria2* uaria2, UgJsonrpcObject* jobject)
 {
 	if (jobject) {
@@ -785,3 +1290,29 @@ UgValue*  uget_aria2_clear_token (UgJsonrpcObject* jobject)
 
 	return NULL;
 }
+
+// ----------------------------------------------------------------------------
+// status poller
+
+void  uget_aria2_watch (UgetAria2* uaria2, UgetAria2WatchFunc func, void* data)
+{
+	UgetAria2Watch*  watch;
+
+	ug_mutex_lock (&uaria2->watch_mutex);
+	watch = ug_array_alloc (&uaria2->watches, 1);
+	watch->func = func;
+	watch->data = data;
+	ug_mutex_unlock (&uaria2->watch_mutex);
+}
+
+UgValue*  uget_aria2_find_status (UgetAria2* uaria2, const char* gid)
+{
+	UgetAria2Status*  status;
+
+	if (gid == NULL)
+		return NULL;
+	status = ug_array_bsearch (&uaria2->statuses, &gid, ug_array_compare_string);
+	if (status)
+		return status->value;
+	return NULL;
+}
@@ -48,6 +48,25 @@ extern "C" {
 
 typedef struct UgetAria2          UgetAria2;
 typedef struct UgetAria2Thread    UgetAria2Thread;
+typedef struct UgetAria2Watch     UgetAria2Watch;
+typedef struct UgetAria2Status    UgetAria2Status;
+
+// UgetAria2WatchFunc is called by thread of UgetAria2 after status of all
+// downloads was polled. It can't wait for response in this function.
+// return FALSE to stop watching, data can be released before returning.
+typedef int  (*UgetAria2WatchFunc) (void* data, UgetAria2* uaria2);
+
+struct UgetAria2Watch
+{
+	UgetAria2WatchFunc  func;
+	void*               data;
+};
+
+struct UgetAria2Status
+{
+	const char*  gid;    // must be first member for ug_array_compare_string()
+	UgValue*     value;  // status object, members are sorted by name.
+};
 
 typedef enum {
 	UGET_ARIA2_ERROR_NONE,
@@ -77,10 +96,18 @@ struct UgetAria2
 	UgSLinks         requested;
 	UgSLinks         responsed;
 	UgMutex          completed_mutex;
-	int              completed_changed;
+	UgCond           completed_cond;    // signalled when responses added
+	UgCond           queuing_cond;      // signalled when request queued
 	// common data for status request
 	UgValue          status_keys;
 
+	// status poller sends aria2.tellActive, aria2.tellWaiting and
+	// aria2.tellStopped in one batch every polling_interval, then
+	// passes status to watchers.
+	UgMutex          watch_mutex;   // lock watches
+	UG_ARRAY (UgetAria2Watch)    watches;
+	UG_ARRAY (UgetAria2Status)   statuses;    // sorted by gid
+
 	unsigned int  error;
 	unsigned int  batch_len;
 	unsigned int  batch_additional;
@@ -98,7 +125,8 @@ struct UgetAria2
 	char*     uri;
 	char*     path;
 	char*     args;
-	char*     token;  // --rpc-secret=<TOKEN>
+	char*     token;  // "token:" + --rpc-secret=<TOKEN>
+	char*     unix_socket;    // HTTP through local Unix socket proxy
 
 	struct {
 		int   download;
@@ -120,6 +148,8 @@ void uget_aria2_set_uri  (UgetAria2* uaria2, const char* uri);
 void uget_aria2_set_path (UgetAria2* uaria2, const char* path);
 void uget_aria2_set_args (UgetAria2* uaria2, const char* args);
 void uget_aria2_set_token (UgetAria2* uaria2, const char* token);
+// send HTTP request to Unix domain socket (local proxy). path = NULL to disable.
+void uget_aria2_set_unix_socket (UgetAria2* uaria2, const char* path);
 void uget_aria2_set_speed (UgetAria2* uaria2, int dl_speed, int ul_speed);
 
 int  uget_aria2_launch   (UgetAria2* aria2);
@@ -130,9 +160,17 @@ void uget_aria2_shutdown (UgetAria2* aria2);
 UgJsonrpcObject*  uget_aria2_alloc   (UgetAria2* aria2, int is_request, int has_response);
 void              uget_aria2_request (UgetAria2* aria2, UgJsonrpcObject* request);
 UgJsonrpcObject*  uget_aria2_respond (UgetAria2* aria2, UgJsonrpcObject* request);
+// return FALSE if request has not been responded. This doesn't wait response.
+int               uget_aria2_try_respond (UgetAria2* aria2, UgJsonrpcObject* request,
+                                          UgJsonrpcObject** response);
 void              uget_aria2_recycle (UgetAria2* aria2, UgJsonrpcObject* jobject);
 UgValue*          uget_aria2_clear_token (UgJsonrpcObject* jobject);
 
+// status poller
+void      uget_aria2_watch (UgetAria2* uaria2, UgetAria2WatchFunc func, void* data);
+// call it in UgetAria2WatchFunc only. return NULL if gid was not found.
+UgValue*  uget_aria2_find_status (UgetAria2* uaria2, const char* gid);
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
@@ -38,6 +38,7 @@
 #include <UgString.h>
 #include <UgJson.h>
 #include <UgUtil.h>
+#include <UgInfo.h>
 #include <UgetData.h>
 #include <UgJson-custom.h>
 
@@ -58,7 +59,7 @@ static const UgEntry  UgetCommonEntry[] =
 	{"file",     offsetof(UgetCommon, file),     UG_ENTRY_STRING,
 			NULL, UG_ENTRY_NO_NULL},
 	{"folder",   offsetof(UgetCommon, folder),   UG_ENTRY_STRING,
-			NULL, UG_ENTRY_NO_NULL},
+			UG_ENTRY_INTERN, UG_ENTRY_NO_NULL},
 	{"user",     offsetof(UgetCommon, user),     UG_ENTRY_STRING,
 			NULL, UG_ENTRY_NO_NULL},
 	{"password", offsetof(UgetCommon, password), UG_ENTRY_STRING,
@@ -84,7 +85,8 @@ static const UgEntry  UgetCommonEntry[] =
 	{NULL}    // null-terminated
 };
 
-static const UgDataInfo  UgetCommonInfoStatic =
+// not const, ug_info_register_slot() set UgDataInfo.slot
+static UgDataInfo  UgetCommonInfoStatic =
 {
 	"common",              // name
 	sizeof(UgetCommon),    // size
@@ -115,7 +117,7 @@ static void uget_common_final(UgetCommon* common)
 	ug_free(common->uri);
 	ug_free(common->mirrors);
 	ug_free(common->file);
-	ug_free(common->folder);
+	ug_str_unintern(common->folder);
 	ug_free(common->user);
 	ug_free(common->password);
 }
@@ -145,8 +147,8 @@ static int  uget_common_assign(UgetCommon* common, UgetCommon* src)
 		common->keeping.file = src->keeping.file;
 	}
 	if (common->keeping.enable == FALSE || common->keeping.folder == FALSE) {
-		ug_free(common->folder);
-		common->folder = (src->folder) ? ug_strdup(src->folder) : NULL;
+		ug_str_unintern(common->folder);
+		common->folder = ug_str_intern_ref(src->folder);
 		common->keeping.folder = src->keeping.folder;
 	}
 	if (common->keeping.enable == FALSE || common->keeping.user == FALSE) {
@@ -259,7 +261,8 @@ static const UgEntry  UgetProgressEntry[] =
 	{NULL}		// null-terminated
 };
 
-static const UgDataInfo  UgetProgressInfoStatic =
+// not const, ug_info_register_slot() set UgDataInfo.slot
+static UgDataInfo  UgetProgressInfoStatic =
 {
 	"progress",            // name
 	sizeof(UgetProgress),  // size
@@ -294,7 +297,7 @@ static const UgEntry  UgetProxyPwmdEntry[] =
 static const UgEntry  UgetProxyEntry[] =
 {
 	{"host",     offsetof(UgetProxy, host),     UG_ENTRY_STRING,
-			NULL, UG_ENTRY_NO_NULL},
+			UG_ENTRY_INTERN, UG_ENTRY_NO_NULL},
 	{"port",     offsetof(UgetProxy, port),     UG_ENTRY_UINT,
 			NULL, NULL},
 	{"type",     offsetof(UgetProxy, type),     UG_ENTRY_UINT,
@@ -324,7 +327,7 @@ const UgDataInfo*  UgetProxyInfo = &UgetProxyInfoStatic;
 
 static void  uget_proxy_final(UgetProxy* proxy)
 {
-	ug_free(proxy->host);
+	ug_str_unintern(proxy->host);
 	ug_free(proxy->user);
 	ug_free(proxy->password);
 
@@ -339,8 +342,8 @@ static void  uget_proxy_final(UgetProxy* proxy)
 static int   uget_proxy_assign(UgetProxy* proxy, UgetProxy* src)
 {
 	if (proxy->keeping.enable == FALSE || proxy->keeping.host == FALSE) {
-		ug_free(proxy->host);
-		proxy->host = (src->host) ? ug_strdup(src->host) : NULL;
+		ug_str_unintern(proxy->host);
+		proxy->host = ug_str_intern_ref(src->host);
 		proxy->keeping.host = src->keeping.host;
 	}
 	if (proxy->keeping.enable == FALSE || proxy->keeping.port == FALSE) {
@@ -406,9 +409,9 @@ static const UgEntry  UgetHttpEntry[] =
 	{"password",          offsetof(UgetHttp, password),     UG_ENTRY_STRING,
 			NULL, UG_ENTRY_NO_NULL},
 	{"referrer",          offsetof(UgetHttp, referrer),     UG_ENTRY_STRING,
-			NULL, UG_ENTRY_NO_NULL},
+			UG_ENTRY_INTERN, UG_ENTRY_NO_NULL},
 	{"user-agent",        offsetof(UgetHttp, user_agent),   UG_ENTRY_STRING,
-			NULL, UG_ENTRY_NO_NULL},
+			UG_ENTRY_INTERN, UG_ENTRY_NO_NULL},
 	{"post-data",         offsetof(UgetHttp, post_data),    UG_ENTRY_STRING,
 			NULL, UG_ENTRY_NO_NULL},
 	{"post-file",         offsetof(UgetHttp, post_file),    UG_ENTRY_STRING,
@@ -443,8 +446,8 @@ static void  uget_http_final(UgetHttp* http)
 {
 	ug_free(http->user);
 	ug_free(http->password);
-	ug_free(http->referrer);
-	ug_free(http->user_agent);
+	ug_str_unintern(http->referrer);
+	ug_str_unintern(http->user_agent);
 	ug_free(http->post_data);
 	ug_free(http->post_file);
 	ug_free(http->cookie_data);
@@ -464,13 +467,13 @@ static int   uget_http_assign(UgetHttp* http, UgetHttp* src)
 		http->keeping.password = src->keeping.password;
 	}
 	if (http->keeping.enable == FALSE || http->keeping.referrer == FALSE) {
-		ug_free(http->referrer);
-		http->referrer = (src->referrer) ? ug_strdup(src->referrer) : NULL;
+		ug_str_unintern(http->referrer);
+		http->referrer = ug_str_intern_ref(src->referrer);
 		http->keeping.referrer = src->keeping.referrer;
 	}
 	if (http->keeping.enable == FALSE || http->keeping.user_agent == FALSE) {
-		ug_free(http->user_agent);
-		http->user_agent = (src->user_agent) ? ug_strdup(src->user_agent) : NULL;
+		ug_str_unintern(http->user_agent);
+		http->user_agent = ug_str_intern_ref(src->user_agent);
 		http->keeping.user_agent = src->keeping.user_agent;
 	}
 	if (http->keeping.enable == FALSE || http->keeping.post_data == FALSE) {
@@ -600,6 +603,27 @@ static void  uget_log_final(UgetLog* log)
 	ug_list_foreach(&log->messages, (UgForeachFunc) uget_event_free, NULL);
 }
 
+void  uget_log_add_message(UgetLog* log, UgetEvent* event)
+{
+	UgetEvent*  oldest;
+
+	ug_list_prepend(&log->messages, (UgLink*) event);
+	// list may be longer than limit after it was loaded from old file.
+	while (log->messages.size > UGET_LOG_MAX_MESSAGES) {
+		oldest = (UgetEvent*) log->messages.tail;
+		ug_list_remove(&log->messages, (UgLink*) oldest);
+		uget_event_free(oldest);
+	}
+	log->generation++;
+}
+
+void  uget_log_clear_messages(UgetLog* log)
+{
+	ug_list_foreach(&log->messages, (UgForeachFunc) uget_event_free, NULL);
+	ug_list_init(&log->messages);
+	log->generation++;
+}
+
 static UgJsonError ug_json_parse_list_message(UgJson* json, const char* name,
                                               const char* value,
                                               void* list, void* none)
@@ -649,7 +673,8 @@ static const UgEntry  UgetRelationEntry[] =
 	{NULL}		// null-terminated
 };
 
-static const UgDataInfo  UgetRelationInfoStatic =
+// not const, ug_info_register_slot() set UgDataInfo.slot
+static UgDataInfo  UgetRelationInfoStatic =
 {
 	"relation",            // name
 	sizeof(UgetRelation),  // size
@@ -766,3 +791,12 @@ static void ug_array_str_copy(UgArrayStr* dest, UgArrayStr* src)
 		*(char**) ug_array_alloc(dest, 1) = ug_strdup(src->at[index]);
 }
 
+// ----------------------------------------------------------------------------
+// UgInfo slots
+
+void  uget_data_register_slots(void)
+{
+	ug_info_register_slot(UgetRelationInfo);
+	ug_info_register_slot(UgetProgressInfo);
+	ug_info_register_slot(UgetCommonInfo);
+}
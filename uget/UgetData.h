@@ -66,6 +66,12 @@ extern const UgDataInfo*  UgetLogInfo;
 extern const UgDataInfo*  UgetRelationInfo;
 extern const UgDataInfo*  UgetCategoryInfo;
 
+// Register fixed UgInfo slots for data that every download node has.
+// Call it once at program startup, before creating any UgetNode.
+#define UGET_DATA_N_SLOTS    3
+
+void  uget_data_register_slots(void);
+
 /* ----------------------------------------------------------------------------
    UgetCommon: It derived from UgData and store in UgInfo.
 
@@ -85,7 +91,7 @@ struct UgetCommon
 	char*   uri;
 	char*   mirrors;
 	char*   file;
-	char*   folder;
+	char*   folder;     // ug_str_intern()
 	char*   user;
 	char*   password;
 
@@ -106,6 +112,10 @@ struct UgetCommon
 	// debug
 	int           debug_level;
 
+	// UgetTask and UI increase it when name, uri, file, or retry_count
+	// changed. UI can compare it with the value it saw last time.
+	unsigned int  generation;
+
 	// keeping flags used by ug_data_assign ()
 	// They works like read-only
 	struct {
@@ -163,6 +173,10 @@ struct UgetProgress
 	// other
 	int          download_speed;
 	int          percent;
+
+	// UgetTask increase it when above values changed. UI can compare it
+	// with the value it saw last time to skip unchanged download.
+	unsigned int generation;
 };
 
 /* ----------------------------------------------------------------------------
@@ -194,7 +208,7 @@ struct UgetProxy
 	UG_DATA_MEMBERS;
 //	const UgDataInfo*  info;    // UgData(UgType) member
 
-	char*          host;
+	char*          host;       // ug_str_intern()
 	unsigned int   port;
 	UgetProxyType  type;
 
@@ -246,8 +260,8 @@ struct UgetHttp
 
 	char*  user;
 	char*  password;
-	char*  referrer;
-	char*  user_agent;
+	char*  referrer;      // ug_str_intern()
+	char*  user_agent;    // ug_str_intern()
 
 	char*  post_data;
 	char*  post_file;
@@ -312,6 +326,9 @@ struct UgetFtp
        `-- UgetLog
  */
 
+// UgetLog keeps only the newest UGET_LOG_MAX_MESSAGES messages.
+#define UGET_LOG_MAX_MESSAGES    16
+
 struct UgetLog
 {
 	UG_DATA_MEMBERS;
@@ -320,9 +337,17 @@ struct UgetLog
 	time_t  added_time;
 	time_t  completed_time;
 
-	UgList  messages;          // List for UgetEvent
+	UgList  messages;          // List for UgetEvent, the newest is head.
+
+	// increased when messages changed. UI can compare it with the value
+	// it saw last time to skip unchanged log.
+	unsigned int  generation;
 };
 
+// prepend 'event' to messages and free the oldest if it is over limit.
+void  uget_log_add_message (UgetLog* log, UgetEvent* event);
+void  uget_log_clear_messages (UgetLog* log);
+
 /* ----------------------------------------------------------------------------
    UgetRelation: It derived from UgData and store in UgInfo.
 
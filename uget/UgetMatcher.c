@@ -0,0 +1,460 @@
+/*
+ *
+ *   Copyright (C) 2012-2020 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <UgDefine.h>
+#include <UgString.h>
+#include <UgetData.h>
+#include <UgetMatcher.h>
+
+#define UGET_MATCHER_LOWER(c)      \
+		(((c) >= 'A' && (c) <= 'Z') ? (c) + ('a' - 'A') : (c))
+
+// key of hash table
+#define UGET_MATCHER_SCHEME        's'
+#define UGET_MATCHER_FILE_EXT      'e'
+
+typedef struct UgetMatcherTrie  UgetMatcherTrie;
+typedef struct UgetMatcherSlot  UgetMatcherSlot;
+
+// trie of reversed host: "example.com" is stored as "moc.elpmaxe"
+struct UgetMatcherTrie
+{
+	int        child;     // index of first child, 0 if none
+	int        next;      // index of next sibling, 0 if none
+	int        mask;      // index of mask, 0 if no host end here
+	char       ch;
+};
+
+// hash table: scheme or file extension -> mask
+struct UgetMatcherSlot
+{
+	char*      key;       // kind + lowercase string, NULL if slot is empty
+	int        mask;
+};
+
+struct UgetMatcher
+{
+	int              stale;
+	int              n_categories;
+	int              n_words;       // number of uint32_t in each mask
+
+	// mask 0 is always empty
+	uint32_t*        masks;
+	int              n_masks;
+	int              masks_allocated;
+
+	// trie[0] is root
+	UgetMatcherTrie* trie;
+	int              n_trie;
+	int              trie_allocated;
+
+	UgetMatcherSlot* slots;
+	int              n_slots;       // power of 2
+	int              n_used_slots;
+
+	// masks of host, scheme, file extension, and result in uget_matcher_match()
+	uint32_t*        work;
+};
+
+UgetMatcher* uget_matcher_new (void)
+{
+	UgetMatcher* matcher;
+
+	matcher = ug_malloc0 (sizeof (UgetMatcher));
+	matcher->stale = TRUE;
+	return matcher;
+}
+
+static void  uget_matcher_clear (UgetMatcher* matcher)
+{
+	int  index;
+
+	for (index = 0;  index < matcher->n_slots;  index++)
+		ug_free (matcher->slots[index].key);
+	ug_free (matcher->slots);
+	matcher->slots = NULL;
+	matcher->n_slots = 0;
+	matcher->n_used_slots = 0;
+	matcher->n_trie = 0;
+	matcher->n_masks = 0;
+}
+
+void  uget_matcher_free (UgetMatcher* matcher)
+{
+	if (matcher == NULL)
+		return;
+	uget_matcher_clear (matcher);
+	ug_free (matcher->trie);
+	ug_free (matcher->masks);
+	ug_free (matcher->work);
+	ug_free (matcher);
+}
+
+void  uget_matcher_reset (UgetMatcher* matcher)
+{
+	if (matcher)
+		matcher->stale = TRUE;
+}
+
+// ------------------------------------
+// masks
+
+// return index of new empty mask
+static int  uget_matcher_alloc_mask (UgetMatcher* matcher)
+{
+	int  index;
+
+	if (matcher->n_masks == matcher->masks_allocated) {
+		matcher->masks_allocated = matcher->masks_allocated * 2 + 16;
+		matcher->masks = ug_realloc (matcher->masks, sizeof (uint32_t) *
+				matcher->n_words * matcher->masks_allocated);
+	}
+	index = matcher->n_masks++;
+	memset (matcher->masks + index * matcher->n_words, 0,
+	        sizeof (uint32_t) * matcher->n_words);
+	return index;
+}
+
+static void  uget_matcher_set_bit (UgetMatcher* matcher, int mask, int nth)
+{
+	matcher->masks[mask * matcher->n_words + nth / 32] |= (uint32_t)1 << (nth % 32);
+}
+
+// ------------------------------------
+// trie
+
+static int  uget_matcher_trie_alloc (UgetMatcher* matcher, char ch)
+{
+	UgetMatcherTrie*  trie;
+
+	if (matcher->n_trie == matcher->trie_allocated) {
+		matcher->trie_allocated = matcher->trie_allocated * 2 + 64;
+		matcher->trie = ug_realloc (matcher->trie,
+				sizeof (UgetMatcherTrie) * matcher->trie_allocated);
+	}
+	trie = matcher->trie + matcher->n_trie;
+	trie->child = 0;
+	trie->next = 0;
+	trie->mask = 0;
+	trie->ch = ch;
+	return matcher->n_trie++;
+}
+
+static int  uget_matcher_trie_find (UgetMatcher* matcher, int parent, char ch)
+{
+	int  index;
+
+	for (index = matcher->trie[parent].child;  index;  index = matcher->trie[index].next) {
+		if (matcher->trie[index].ch == ch)
+			return index;
+	}
+	return 0;
+}
+
+static void  uget_matcher_add_host (UgetMatcher* matcher, const char* host, int nth)
+{
+	const char* cur;
+	int         parent;
+	int         index;
+	char        ch;
+
+	parent = 0;
+	for (cur = host + strlen (host) - 1;  cur >= host;  cur--) {
+		ch = UGET_MATCHER_LOWER (*cur);
+		index = uget_matcher_trie_find (matcher, parent, ch);
+		if (index == 0) {
+			// trie may be reallocated, so nodes are linked by index.
+			index = uget_matcher_trie_alloc (matcher, ch);
+			matcher->trie[index].next = matcher->trie[parent].child;
+			matcher->trie[parent].child = index;
+		}
+		parent = index;
+	}
+
+	if (matcher->trie[parent].mask == 0) {
+		index = uget_matcher_alloc_mask (matcher);
+		matcher->trie[parent].mask = index;
+	}
+	uget_matcher_set_bit (matcher, matcher->trie[parent].mask, nth);
+}
+
+// ------------------------------------
+// hash table
+
+static unsigned int  uget_matcher_hash (int kind, const char* str, int len)
+{
+	unsigned int  hash = 2166136261u ^ kind;
+
+	for (;  len > 0;  len--, str++)
+		hash = (hash ^ (unsigned char) UGET_MATCHER_LOWER (*str)) * 16777619u;
+	return hash;
+}
+
+static UgetMatcherSlot* uget_matcher_find_slot (UgetMatcher* matcher,
+                                                int kind, const char* str, int len)
+{
+	UgetMatcherSlot*  slot;
+	unsigned int      index;
+
+	if (matcher->n_slots == 0)
+		return NULL;
+	index = uget_matcher_hash (kind, str, len) & (matcher->n_slots - 1);
+	for (;;  index = (index + 1) & (matcher->n_slots - 1)) {
+		slot = matcher->slots + index;
+		if (slot->key == NULL)
+			return slot;
+		// strncasecmp() stop at '\0' if key is shorter than 'len'
+		if (slot->key[0] == kind &&
+		    strncasecmp (slot->key + 1, str, len) == 0 &&
+		    slot->key[len + 1] == 0)
+		{
+			return slot;
+		}
+	}
+}
+
+static void  uget_matcher_grow_slots (UgetMatcher* matcher)
+{
+	UgetMatcherSlot*  old_slots;
+	UgetMatcherSlot*  slot;
+	int               old_n_slots;
+	int               index;
+
+	old_slots = matcher->slots;
+	old_n_slots = matcher->n_slots;
+	matcher->n_slots = (old_n_slots) ? old_n_slots * 2 : 64;
+	matcher->slots = ug_malloc0 (sizeof (UgetMatcherSlot) * matcher->n_slots);
+
+	for (index = 0;  index < old_n_slots;  index++) {
+		if (old_slots[index].key == NULL)
+			continue;
+		slot = uget_matcher_find_slot (matcher, old_slots[index].key[0],
+				old_slots[index].key + 1, strlen (old_slots[index].key + 1));
+		*slot = old_slots[index];
+	}
+	ug_free (old_slots);
+}
+
+static void  uget_matcher_add_key (UgetMatcher* matcher, int kind,
+                                   const char* str, int nth)
+{
+	UgetMatcherSlot*  slot;
+	int               len;
+	int               index;
+
+	len = strlen (str);
+	// empty scheme and file extension can't be matched
+	if (len == 0)
+		return;
+	// keep load factor under 0.5
+	if (matcher->n_used_slots * 2 >= matcher->n_slots)
+		uget_matcher_grow_slots (matcher);
+
+	slot = uget_matcher_find_slot (matcher, kind, str, len);
+	if (slot->key == NULL) {
+		slot->key = ug_malloc (len + 2);
+		slot->key[0] = kind;
+		for (index = 0;  index < len;  index++)
+			slot->key[index + 1] = UGET_MATCHER_LOWER (str[index]);
+		slot->key[len + 1] = 0;
+		slot->mask = uget_matcher_alloc_mask (matcher);
+		matcher->n_used_slots++;
+	}
+	uget_matcher_set_bit (matcher, slot->mask, nth);
+}
+
+static const uint32_t* uget_matcher_get_mask (UgetMatcher* matcher,
+                                              int kind, const char* str, int len)
+{
+	UgetMatcherSlot*  slot;
+
+	if (len == 0)
+		return NULL;
+	slot = uget_matcher_find_slot (matcher, kind, str, len);
+	if (slot == NULL || slot->key == NULL)
+		return NULL;
+	return matcher->masks + slot->mask * matcher->n_words;
+}
+
+// ------------------------------------
+// build and match
+
+void  uget_matcher_build (UgetMatcher* matcher, UgetNode* real)
+{
+	UgetCategory* category;
+	UgetNode*     cnode;
+	int           nth;
+	int           index;
+
+	uget_matcher_clear (matcher);
+	matcher->stale = FALSE;
+	matcher->n_categories = real->n_children;
+	matcher->n_words = (real->n_children + 31) / 32;
+	if (matcher->n_words == 0)
+		matcher->n_words = 1;
+	ug_free (matcher->work);
+	matcher->work = ug_malloc (sizeof (uint32_t) * matcher->n_words * 4);
+
+	uget_matcher_alloc_mask (matcher);     // mask 0 is empty
+	uget_matcher_trie_alloc (matcher, 0);  // root of trie
+
+	for (nth = 0, cnode = real->children;  cnode;  cnode = cnode->next, nth++) {
+		category = ug_info_get (cnode->info, UgetCategoryInfo);
+		if (category == NULL)
+			continue;
+		for (index = 0;  index < category->hosts.length;  index++) {
+			if (category->hosts.at[index])
+				uget_matcher_add_host (matcher, category->hosts.at[index], nth);
+		}
+		for (index = 0;  index < category->schemes.length;  index++) {
+			if (category->schemes.at[index]) {
+				uget_matcher_add_key (matcher, UGET_MATCHER_SCHEME,
+				                      category->schemes.at[index], nth);
+			}
+		}
+		for (index = 0;  index < category->file_exts.length;  index++) {
+			if (category->file_exts.at[index]) {
+				uget_matcher_add_key (matcher, UGET_MATCHER_FILE_EXT,
+				                      category->file_exts.at[index], nth);
+			}
+		}
+	}
+}
+
+// return position of the first bit or -1
+static int  uget_matcher_first_bit (uint32_t* mask, int n_words)
+{
+	uint32_t  word;
+	int       index;
+	int       nth;
+
+	for (index = 0;  index < n_words;  index++) {
+		word = mask[index];
+		if (word == 0)
+			continue;
+		for (nth = 0;  (word & 1) == 0;  nth++)
+			word >>= 1;
+		return index * 32 + nth;
+	}
+	return -1;
+}
+
+int   uget_matcher_match (UgetMatcher* matcher, UgetNode* real,
+                          UgUri* uuri, const char* file)
+{
+	const uint32_t* mask;
+	const char*     str;
+	uint32_t*       host;
+	uint32_t*       scheme;
+	uint32_t*       ext;
+	uint32_t*       result;
+	int             n_words;
+	int             index;
+	int             node;
+	int             len;
+
+	if (matcher->stale || matcher->n_categories != real->n_children)
+		uget_matcher_build (matcher, real);
+	if (matcher->n_categories == 0)
+		return -1;
+
+	n_words = matcher->n_words;
+	host   = matcher->work;
+	scheme = matcher->work + n_words;
+	ext    = matcher->work + n_words * 2;
+	result = matcher->work + n_words * 3;
+	memset (matcher->work, 0, sizeof (uint32_t) * n_words * 3);
+
+	// host: walk trie from the last character
+	len = ug_uri_part_host (uuri, &str);
+	if (len) {
+		node = 0;
+		for (;;) {
+			if (matcher->trie[node].mask) {
+				mask = matcher->masks + matcher->trie[node].mask * n_words;
+				for (index = 0;  index < n_words;  index++)
+					host[index] |= mask[index];
+			}
+			if (len == 0)
+				break;
+			len--;
+			node = uget_matcher_trie_find (matcher, node,
+			                               UGET_MATCHER_LOWER (str[len]));
+			if (node == 0)
+				break;
+		}
+	}
+
+	// scheme
+	len = ug_uri_part_scheme (uuri, NULL);
+	mask = uget_matcher_get_mask (matcher, UGET_MATCHER_SCHEME, uuri->uri, len);
+	if (mask)
+		memcpy (scheme, mask, sizeof (uint32_t) * n_words);
+
+	// file extension of URI and file
+	len = ug_uri_part_file_ext (uuri, &str);
+	mask = uget_matcher_get_mask (matcher, UGET_MATCHER_FILE_EXT, str, len);
+	if (mask)
+		memcpy (ext, mask, sizeof (uint32_t) * n_words);
+	if (file && (str = strrchr (file, '.'))) {
+		str++;    // + '.'
+		mask = uget_matcher_get_mask (matcher, UGET_MATCHER_FILE_EXT, str, strlen (str));
+		if (mask) {
+			for (index = 0;  index < n_words;  index++)
+				ext[index] |= mask[index];
+		}
+	}
+
+	// category that matched host, scheme, and file extension
+	for (index = 0;  index < n_words;  index++)
+		result[index] = host[index] & scheme[index] & ext[index];
+	if ((node = uget_matcher_first_bit (result, n_words)) >= 0)
+		return node;
+	// category that matched 2 of them
+	for (index = 0;  index < n_words;  index++) {
+		result[index] = (host[index] & scheme[index]) |
+		                (host[index] & ext[index]) |
+		                (scheme[index] & ext[index]);
+	}
+	if ((node = uget_matcher_first_bit (result, n_words)) >= 0)
+		return node;
+	// category that matched 1 of them
+	for (index = 0;  index < n_words;  index++)
+		result[index] = host[index] | scheme[index] | ext[index];
+	return uget_matcher_first_bit (result, n_words);
+}
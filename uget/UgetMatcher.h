@@ -0,0 +1,79 @@
+/*
+ *
+ *   Copyright (C) 2012-2020 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#ifndef UGET_MATCHER_H
+#define UGET_MATCHER_H
+
+#include <UgUri.h>
+#include <UgetNode.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// UgetMatcher: compiled hosts, schemes, and file_exts of all categories.
+//              It match URI with categories in O(URI length).
+//
+// Every pattern has a bit mask of categories that contain it. Hosts are stored
+// in a trie by reversed lowercase characters, schemes and file extensions are
+// stored in a hash table. Matcher pick the first category that matched most
+// of host, scheme, and file extension. This is the same as the old loop that
+// called ug_uri_match_hosts(), ug_uri_match_schemes(), and
+// ug_uri_match_file_exts() for each category, but host is case-insensitive
+// suffix and scheme/file extension must be equal (case-insensitive).
+
+typedef struct UgetMatcher      UgetMatcher;
+
+UgetMatcher* uget_matcher_new (void);
+void  uget_matcher_free (UgetMatcher* matcher);
+
+// mark matcher out of date after category was added, removed, moved, or it's
+// hosts, schemes, and file_exts were changed. uget_matcher_match() rebuild it.
+void  uget_matcher_reset (UgetMatcher* matcher);
+// compile children (category nodes) of 'real'
+void  uget_matcher_build (UgetMatcher* matcher, UgetNode* real);
+
+// return position of matched category in 'real' or -1 if nothing matched.
+// 'file' is filename of download, it can be NULL.
+int   uget_matcher_match (UgetMatcher* matcher, UgetNode* real,
+                          UgUri* uuri, const char* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // End of UGET_MATCHER_H
@@ -34,14 +34,26 @@
  *
  */
 
+#include <stdlib.h>
 #include <string.h>
 #include <UgDefine.h>
+#include <UgThread.h>
 #include <UgetNode.h>
 #include <UgetData.h>
 
+// uget_node_sort_keys() use one thread for each UGET_NODE_SORT_CHUNK keys
+#define UGET_NODE_SORT_CHUNK        16384
+#define UGET_NODE_SORT_MAX_THREADS  4
+
 // ----------------------------------------------------------------------------
 // compare functions for sorting
 
+// three-way compare. it must order values the same as uget_node_compare_key()
+#define UGET_NODE_COMPARE_VALUE(v1, v2)  (((v1) > (v2)) - ((v1) < (v2)))
+
+// ratio is compared in millionths, the same as uget_node_key_ratio()
+#define UGET_NODE_RATIO_VALUE(ratio)     ((int64_t) ((ratio) * 1000000.0))
+
 int   uget_node_compare_name (UgetNode* node1, UgetNode* node2)
 {
 	UgetCommon* common1;
@@ -51,7 +63,7 @@ int   uget_node_compare_name (UgetNode* node1, UgetNode* node2)
 	common2 = ug_info_get(node2->info, UgetCommonInfo);
 
 	if (common1 && common1->name) {
-		if (common2->name == NULL)
+		if (common2 == NULL || common2->name == NULL)
 			return 1;
 	}
 	else {
@@ -86,9 +98,9 @@ int   uget_node_compare_complete (UgetNode* node1, UgetNode* node2)
 	// if these are the same, compare name
 	if (progress1->complete == progress2->complete)
 		return uget_node_compare_name (node1, node2);
-	// return diff of complete
+	// return order of complete
 	else
-		return (int)(progress1->complete - progress2->complete);
+		return UGET_NODE_COMPARE_VALUE (progress1->complete, progress2->complete);
 }
 
 int   uget_node_compare_size (UgetNode* node1, UgetNode* node2)
@@ -114,9 +126,9 @@ int   uget_node_compare_size (UgetNode* node1, UgetNode* node2)
 	// if these are the same, compare name
 	if (progress1->total == progress2->total)
 		return uget_node_compare_name (node1, node2);
-	// return diff of total
+	// return order of total
 	else
-		return (int)(progress1->total - progress2->total);
+		return UGET_NODE_COMPARE_VALUE (progress1->total, progress2->total);
 }
 
 int   uget_node_compare_percent (UgetNode* node1, UgetNode* node2)
@@ -142,9 +154,9 @@ int   uget_node_compare_percent (UgetNode* node1, UgetNode* node2)
 	// if these are the same, compare name
 	if (progress1->percent == progress2->percent)
 		return uget_node_compare_name (node1, node2);
-	// return diff of percent
+	// return order of percent
 	else
-		return progress1->percent - progress2->percent;
+		return UGET_NODE_COMPARE_VALUE (progress1->percent, progress2->percent);
 }
 
 int   uget_node_compare_elapsed (UgetNode* node1, UgetNode* node2)
@@ -170,9 +182,9 @@ int   uget_node_compare_elapsed (UgetNode* node1, UgetNode* node2)
 	// if these are the same, compare name
 	if (progress1->elapsed == progress2->elapsed)
 		return uget_node_compare_name (node1, node2);
-	// return diff of elapsed (consume time)
+	// return order of elapsed (consume time)
 	else
-		return (int)(progress1->elapsed - progress2->elapsed);
+		return UGET_NODE_COMPARE_VALUE (progress1->elapsed, progress2->elapsed);
 }
 
 int   uget_node_compare_left (UgetNode* node1, UgetNode* node2)
@@ -198,9 +210,9 @@ int   uget_node_compare_left (UgetNode* node1, UgetNode* node2)
 	// if these are the same, compare name
 	if (progress1->left == progress2->left)
 		return uget_node_compare_name (node1, node2);
-	// return diff of left (remain time)
+	// return order of left (remain time)
 	else
-		return (int)(progress1->left - progress2->left);
+		return UGET_NODE_COMPARE_VALUE (progress1->left, progress2->left);
 }
 
 int   uget_node_compare_speed (UgetNode* node1, UgetNode* node2)
@@ -226,9 +238,9 @@ int   uget_node_compare_speed (UgetNode* node1, UgetNode* node2)
 	// if these are the same, compare name
 	if (progress1->download_speed == progress2->download_speed)
 		return uget_node_compare_name (node1, node2);
-	// return diff of download_speed
+	// return order of download_speed
 	else
-		return (int)(progress1->download_speed - progress2->download_speed);
+		return UGET_NODE_COMPARE_VALUE (progress1->download_speed, progress2->download_speed);
 }
 
 int   uget_node_compare_upload_speed (UgetNode* node1, UgetNode* node2)
@@ -254,9 +266,9 @@ int   uget_node_compare_upload_speed (UgetNode* node1, UgetNode* node2)
 	// if these are the same, compare name
 	if (progress1->upload_speed == progress2->upload_speed)
 		return uget_node_compare_name (node1, node2);
-	// return diff of upload_speed
+	// return order of upload_speed
 	else
-		return (int)(progress1->upload_speed - progress2->upload_speed);
+		return UGET_NODE_COMPARE_VALUE (progress1->upload_speed, progress2->upload_speed);
 }
 
 int   uget_node_compare_uploaded (UgetNode* node1, UgetNode* node2)
@@ -282,9 +294,9 @@ int   uget_node_compare_uploaded (UgetNode* node1, UgetNode* node2)
 	// if these are the same, compare name
 	if (progress1->uploaded == progress2->uploaded)
 		return uget_node_compare_name (node1, node2);
-	// return diff of uploaded
+	// return order of uploaded
 	else
-		return (int)(progress1->uploaded - progress2->uploaded);
+		return UGET_NODE_COMPARE_VALUE (progress1->uploaded, progress2->uploaded);
 }
 
 int   uget_node_compare_ratio (UgetNode* node1, UgetNode* node2)
@@ -308,11 +320,12 @@ int   uget_node_compare_ratio (UgetNode* node1, UgetNode* node2)
 	}
 
 	// if these are the same, compare name
-	if (progress1->ratio == progress2->ratio)
+	if (UGET_NODE_RATIO_VALUE (progress1->ratio) == UGET_NODE_RATIO_VALUE (progress2->ratio))
 		return uget_node_compare_name (node1, node2);
-	// return diff of ratio
+	// return order of ratio
 	else
-		return (int)(progress1->ratio - progress2->ratio);
+		return UGET_NODE_COMPARE_VALUE (UGET_NODE_RATIO_VALUE (progress1->ratio),
+		                                UGET_NODE_RATIO_VALUE (progress2->ratio));
 }
 
 int   uget_node_compare_retry (UgetNode* node1, UgetNode* node2)
@@ -338,9 +351,9 @@ int   uget_node_compare_retry (UgetNode* node1, UgetNode* node2)
 	// if these are the same, compare name
 	if (common1->retry_count == common2->retry_count)
 		return uget_node_compare_name (node1, node2);
-	// return diff of retry_count
+	// return order of retry_count
 	else
-		return common1->retry_count - common2->retry_count;
+		return UGET_NODE_COMPARE_VALUE (common1->retry_count, common2->retry_count);
 }
 
 int   uget_node_compare_parent_name (UgetNode* node1, UgetNode* node2)
@@ -393,9 +406,9 @@ int   uget_node_compare_added_time (UgetNode* node1, UgetNode* node2)
 	// if these added_time are the same, compare name
 	if (log1->added_time == log2->added_time)
 		return uget_node_compare_name (node1, node2);
-	// return diff of added_time
+	// return order of added_time
 	else
-		return (int)(log1->added_time - log2->added_time);
+		return UGET_NODE_COMPARE_VALUE (log1->added_time, log2->added_time);
 }
 
 int   uget_node_compare_completed_time (UgetNode* node1, UgetNode* node2)
@@ -421,8 +434,380 @@ int   uget_node_compare_completed_time (UgetNode* node1, UgetNode* node2)
 	// if these completed_time are the same, compare name
 	if (log1->completed_time == log2->completed_time)
 		return uget_node_compare_name (node1, node2);
-	// return diff of completed_time
+	// return order of completed_time
 	else
-		return (int)(log1->completed_time - log2->completed_time);
+		return UGET_NODE_COMPARE_VALUE (log1->completed_time, log2->completed_time);
+}
+
+// ----------------------------------------------------------------------------
+// sort keys
+
+static void  uget_node_key_set_string (UgetNodeKey* key, const char* string)
+{
+	int  index;
+
+	key->string = string;
+	key->prefix = 0;
+	if (string) {
+		for (index = 0;  index < 8 && string[index];  index++)
+			key->prefix |= (uint64_t)(uint8_t) string[index] << (56 - index * 8);
+	}
+}
+
+// set name of node to key->string. it is used if key->value are the same.
+static UgetCommon* uget_node_key_init (UgetNodeKey* key, UgetNode* node)
+{
+	UgetCommon* common;
+
+	common = ug_info_get (node->base->info, UgetCommonInfo);
+	key->node  = node;
+	key->group = 0;
+	key->value = 0;
+	uget_node_key_set_string (key, (common) ? common->name : NULL);
+	return common;
+}
+
+static void  uget_node_key_name (UgetNodeKey* key, UgetNode* node)
+{
+	uget_node_key_init (key, node);
+}
+
+static void  uget_node_key_complete (UgetNodeKey* key, UgetNode* node)
+{
+	UgetProgress*  progress;
+
+	uget_node_key_init (key, node);
+	progress = ug_info_get (node->base->info, UgetProgressInfo);
+	if (progress) {
+		key->group = 1;
+		key->value = progress->complete;
+	}
+}
+
+static void  uget_node_key_size (UgetNodeKey* key, UgetNode* node)
+{
+	UgetProgress*  progress;
+
+	uget_node_key_init (key, node);
+	progress = ug_info_get (node->base->info, UgetProgressInfo);
+	if (progress) {
+		key->group = 1;
+		key->value = progress->total;
+	}
+}
+
+static void  uget_node_key_percent (UgetNodeKey* key, UgetNode* node)
+{
+	UgetProgress*  progress;
+
+	uget_node_key_init (key, node);
+	progress = ug_info_get (node->base->info, UgetProgressInfo);
+	if (progress) {
+		key->group = 1;
+		key->value = progress->percent;
+	}
+}
+
+static void  uget_node_key_elapsed (UgetNodeKey* key, UgetNode* node)
+{
+	UgetProgress*  progress;
+
+	uget_node_key_init (key, node);
+	progress = ug_info_get (node->base->info, UgetProgressInfo);
+	if (progress) {
+		key->group = 1;
+		key->value = progress->elapsed;
+	}
+}
+
+static void  uget_node_key_left (UgetNodeKey* key, UgetNode* node)
+{
+	UgetProgress*  progress;
+
+	uget_node_key_init (key, node);
+	progress = ug_info_get (node->base->info, UgetProgressInfo);
+	if (progress) {
+		key->group = 1;
+		key->value = progress->left;
+	}
+}
+
+static void  uget_node_key_speed (UgetNodeKey* key, UgetNode* node)
+{
+	UgetProgress*  progress;
+
+	uget_node_key_init (key, node);
+	progress = ug_info_get (node->base->info, UgetProgressInfo);
+	if (progress) {
+		key->group = 1;
+		key->value = progress->download_speed;
+	}
+}
+
+static void  uget_node_key_upload_speed (UgetNodeKey* key, UgetNode* node)
+{
+	UgetProgress*  progress;
+
+	uget_node_key_init (key, node);
+	progress = ug_info_get (node->base->info, UgetProgressInfo);
+	if (progress) {
+		key->group = 1;
+		key->value = progress->upload_speed;
+	}
+}
+
+static void  uget_node_key_uploaded (UgetNodeKey* key, UgetNode* node)
+{
+	UgetProgress*  progress;
+
+	uget_node_key_init (key, node);
+	progress = ug_info_get (node->base->info, UgetProgressInfo);
+	if (progress) {
+		key->group = 1;
+		key->value = progress->uploaded;
+	}
+}
+
+static void  uget_node_key_ratio (UgetNodeKey* key, UgetNode* node)
+{
+	UgetProgress*  progress;
+
+	uget_node_key_init (key, node);
+	progress = ug_info_get (node->base->info, UgetProgressInfo);
+	if (progress) {
+		key->group = 1;
+		key->value = UGET_NODE_RATIO_VALUE (progress->ratio);
+	}
+}
+
+static void  uget_node_key_retry (UgetNodeKey* key, UgetNode* node)
+{
+	UgetCommon*  common;
+
+	common = uget_node_key_init (key, node);
+	if (common) {
+		key->group = 1;
+		key->value = common->retry_count;
+	}
+}
+
+static void  uget_node_key_parent_name (UgetNodeKey* key, UgetNode* node)
+{
+	UgetCommon*  common = NULL;
+
+	if (node->base->parent)
+		common = ug_info_get (node->base->parent->info, UgetCommonInfo);
+	key->node  = node;
+	key->group = 0;
+	key->value = 0;
+	uget_node_key_set_string (key, (common) ? common->name : NULL);
+}
+
+static void  uget_node_key_uri (UgetNodeKey* key, UgetNode* node)
+{
+	UgetCommon*  common;
+
+	common = uget_node_key_init (key, node);
+	if (common) {
+		key->group = 1;
+		uget_node_key_set_string (key, common->uri);
+	}
 }
 
+static void  uget_node_key_added_time (UgetNodeKey* key, UgetNode* node)
+{
+	UgetLog*  log;
+
+	uget_node_key_init (key, node);
+	log = ug_info_get (node->base->info, UgetLogInfo);
+	if (log) {
+		key->group = 1;
+		key->value = log->added_time;
+	}
+}
+
+static void  uget_node_key_completed_time (UgetNodeKey* key, UgetNode* node)
+{
+	UgetLog*  log;
+
+	uget_node_key_init (key, node);
+	log = ug_info_get (node->base->info, UgetLogInfo);
+	if (log) {
+		key->group = 1;
+		key->value = log->completed_time;
+	}
+}
+
+static const struct
+{
+	UgCompareFunc    compare;
+	UgetNodeKeyFunc  key;
+} uget_node_key_table[] =
+{
+	{(UgCompareFunc) uget_node_compare_name,           uget_node_key_name},
+	{(UgCompareFunc) uget_node_compare_complete,       uget_node_key_complete},
+	{(UgCompareFunc) uget_node_compare_size,           uget_node_key_size},
+	{(UgCompareFunc) uget_node_compare_percent,        uget_node_key_percent},
+	{(UgCompareFunc) uget_node_compare_elapsed,        uget_node_key_elapsed},
+	{(UgCompareFunc) uget_node_compare_left,           uget_node_key_left},
+	{(UgCompareFunc) uget_node_compare_speed,          uget_node_key_speed},
+	{(UgCompareFunc) uget_node_compare_upload_speed,   uget_node_key_upload_speed},
+	{(UgCompareFunc) uget_node_compare_uploaded,       uget_node_key_uploaded},
+	{(UgCompareFunc) uget_node_compare_ratio,          uget_node_key_ratio},
+	{(UgCompareFunc) uget_node_compare_retry,          uget_node_key_retry},
+	{(UgCompareFunc) uget_node_compare_parent_name,    uget_node_key_parent_name},
+	{(UgCompareFunc) uget_node_compare_uri,            uget_node_key_uri},
+	{(UgCompareFunc) uget_node_compare_added_time,     uget_node_key_added_time},
+	{(UgCompareFunc) uget_node_compare_completed_time, uget_node_key_completed_time},
+};
+
+UgetNodeKeyFunc  uget_node_get_key_func (UgCompareFunc compare)
+{
+	int  index;
+
+	for (index = 0;  index < sizeof (uget_node_key_table) / sizeof (uget_node_key_table[0]);  index++) {
+		if (uget_node_key_table[index].compare == compare)
+			return uget_node_key_table[index].key;
+	}
+	return NULL;
+}
+
+int   uget_node_compare_key (const void* key1, const void* key2)
+{
+	const UgetNodeKey*  k1 = key1;
+	const UgetNodeKey*  k2 = key2;
+
+	if (k1->group != k2->group)
+		return (k1->group < k2->group) ? -1 : 1;
+	if (k1->value != k2->value)
+		return (k1->value < k2->value) ? -1 : 1;
+	// compare string. NULL is less than others.
+	if (k1->string == NULL || k2->string == NULL) {
+		if (k1->string)
+			return 1;
+		if (k2->string)
+			return -1;
+		return 0;
+	}
+	if (k1->prefix != k2->prefix)
+		return (k1->prefix < k2->prefix) ? -1 : 1;
+	return strcmp (k1->string, k2->string);
+}
+
+// ----------------------------------------------------------------------------
+// sort keys by multiple threads
+
+typedef struct UgetNodeKeyRun   UgetNodeKeyRun;
+
+struct UgetNodeKeyRun
+{
+	UgetNodeKey*     keys;
+	UgetNode**       nodes;
+	int              n_keys;
+	UgetNodeKeyFunc  key_func;
+	UgThread         thread;
+	int              threaded;
+};
+
+static UgThreadResult  uget_node_key_run (UgetNodeKeyRun* run)
+{
+	int  index;
+
+	for (index = 0;  index < run->n_keys;  index++)
+		run->key_func (run->keys + index, run->nodes[index]);
+	qsort (run->keys, run->n_keys, sizeof (UgetNodeKey), uget_node_compare_key);
+	return UG_THREAD_RESULT;
+}
+
+static void  uget_node_key_merge (UgetNodeKey* dest,
+                                  UgetNodeKey* src1, int n_src1,
+                                  UgetNodeKey* src2, int n_src2)
+{
+	while (n_src1 && n_src2) {
+		if (uget_node_compare_key (src2, src1) < 0) {
+			*dest++ = *src2++;
+			n_src2--;
+		}
+		else {
+			*dest++ = *src1++;
+			n_src1--;
+		}
+	}
+	memcpy (dest, src1, sizeof (UgetNodeKey) * n_src1);
+	memcpy (dest + n_src1, src2, sizeof (UgetNodeKey) * n_src2);
+}
+
+void  uget_node_sort_keys (UgetNodeKey* keys, UgetNode** nodes, int n_nodes,
+                           UgetNodeKeyFunc key_func)
+{
+	UgetNodeKeyRun  runs[UGET_NODE_SORT_MAX_THREADS];
+	UgetNodeKey*    buffer;
+	UgetNodeKey*    temp;
+	UgetNodeKey*    src;
+	UgetNodeKey*    dest;
+	int             n_runs;
+	int             index;
+	int             offset;
+
+	n_runs = n_nodes / UGET_NODE_SORT_CHUNK;
+	if (n_runs > UGET_NODE_SORT_MAX_THREADS)
+		n_runs = UGET_NODE_SORT_MAX_THREADS;
+	if (n_runs < 2) {
+		runs[0].keys = keys;
+		runs[0].nodes = nodes;
+		runs[0].n_keys = n_nodes;
+		runs[0].key_func = key_func;
+		uget_node_key_run (runs);
+		return;
+	}
+
+	// extract and sort each run. the first run use current thread.
+	for (offset = 0, index = 0;  index < n_runs;  index++) {
+		runs[index].keys = keys + offset;
+		runs[index].nodes = nodes + offset;
+		runs[index].n_keys = (index == n_runs - 1) ?
+				n_nodes - offset : n_nodes / n_runs;
+		runs[index].key_func = key_func;
+		runs[index].threaded = FALSE;
+		offset += runs[index].n_keys;
+		if (index > 0 && ug_thread_create (&runs[index].thread,
+				(UgThreadFunc) uget_node_key_run, runs + index) == UG_THREAD_OK)
+		{
+			runs[index].threaded = TRUE;
+		}
+	}
+	for (index = 0;  index < n_runs;  index++) {
+		if (runs[index].threaded)
+			ug_thread_join (&runs[index].thread);
+		else
+			uget_node_key_run (runs + index);
+	}
+
+	// merge adjacent runs until only one run left
+	buffer = ug_malloc (sizeof (UgetNodeKey) * n_nodes);
+	src  = keys;
+	dest = buffer;
+	while (n_runs > 1) {
+		for (offset = 0, index = 0;  index < n_runs;  index += 2) {
+			if (index + 1 < n_runs) {
+				uget_node_key_merge (dest + offset,
+						src + offset, runs[index].n_keys,
+						src + offset + runs[index].n_keys, runs[index+1].n_keys);
+				runs[index/2].n_keys = runs[index].n_keys + runs[index+1].n_keys;
+			}
+			else {
+				memcpy (dest + offset, src + offset,
+						sizeof (UgetNodeKey) * runs[index].n_keys);
+				runs[index/2].n_keys = runs[index].n_keys;
+			}
+			offset += runs[index/2].n_keys;
+		}
+		n_runs = (n_runs + 1) / 2;
+		temp = src;
+		src  = dest;
+		dest = temp;
+	}
+	if (src != keys)
+		memcpy (keys, src, sizeof (UgetNodeKey) * n_nodes);
+	ug_free (buffer);
+}
@@ -38,15 +38,15 @@
 #include <config.h>
 #endif
 
+#include <stdlib.h>    // qsort()
 #include <UgString.h>
 #include <UgetNode.h>
 #include <UgetData.h>
 
-#ifdef HAVE_GLIB
-#include <glib.h>    // g_slice_xxx
-#endif
+#include <UgSlab.h>
 
 static void  uget_node_call_fake_filter (UgetNode* parent, UgetNode* sibling, UgetNode* child);
+static void  uget_node_clear_index (UgetNode* node);
 static UgJsonError  ug_json_parse_state2group (UgJson* json,
                                 const char* name, const char* value,
                                 void* node, void* none);
@@ -61,6 +61,7 @@ struct UgetNodeNotifier  uget_node_default_notifier =
 	NULL,   // UgetNodeFunc    inserted;
 	NULL,   // UgetNodeFunc    removed;
 	NULL,   // UgNotifyFunc    updated;
+	NULL,   // UgNotifyFunc    destroy;
 	NULL,   // void*           data;      // extra data for user
 };
 
@@ -93,11 +94,7 @@ UgetNode*  uget_node_new (UgetNode* node_real)
 {
 	UgetNode*  node;
 
-#ifdef HAVE_GLIB
-	node = g_slice_alloc (sizeof (UgetNode));
-#else
-	node = ug_malloc (sizeof (UgetNode));
-#endif // HAVE_GLIB
+	node = ug_slab_alloc (sizeof (UgetNode));
 	uget_node_init (node, node_real);
 	return node;
 }
@@ -105,11 +102,7 @@ UgetNode*  uget_node_new (UgetNode* node_real)
 void  uget_node_free(UgetNode* node)
 {
 	uget_node_final(node);
-#ifdef HAVE_GLIB
-	g_slice_free1(sizeof(UgetNode), node);
-#else
-	ug_free(node);
-#endif // HAVE_GLIB
+	ug_slab_free(sizeof(UgetNode), node);
 }
 
 void  uget_node_init  (UgetNode* node, UgetNode* node_real)
@@ -120,9 +113,7 @@ void  uget_node_init  (UgetNode* node, UgetNode* node_real)
 
 	if (node_real == NULL) {
 		node->base = node;    // pointer to self
-		node->info = ug_info_new(8, 2);
-		node->info->at[0].key = (void*) UgetRelationInfo;
-		node->info->at[1].key = (void*) UgetProgressInfo;
+		node->info = ug_info_new(8, UGET_DATA_N_SLOTS);
 	}
 	else {
 		// this is a fake node.
@@ -138,6 +129,13 @@ void  uget_node_init  (UgetNode* node, UgetNode* node_real)
 
 void  uget_node_final(UgetNode* node)
 {
+	UgNotifyFunc destroy;
+
+	if (node->data) {
+		destroy = node->control->notifier->destroy;
+		if (destroy)
+			destroy (node);
+	}
 	if (node->parent)
 		uget_node_remove(node->parent, node);
 	if (node->real)
@@ -145,6 +143,7 @@ void  uget_node_final(UgetNode* node)
 
 	uget_node_clear_fake(node);
 	uget_node_clear_children(node);
+	uget_node_clear_index(node);
 //	ug_node_unlink((UgNode*)node);
 	ug_info_unref(node->info);
 }
@@ -174,13 +173,94 @@ void  uget_node_clear_fake (UgetNode* node)
 	node->fake = NULL;       // speed up uget_node_free()
 }
 
+// ----------------------------------------------------------------------------
+// index of children: UgRankTree in the same order as children list.
+
+static UgRankTree* uget_node_get_index (UgetNode* node)
+{
+	UgetNode*  cur;
+
+	if (node->index == NULL) {
+		node->index = ug_malloc (sizeof (UgRankTree));
+		ug_rank_tree_init (node->index);
+		for (cur = node->children;  cur;  cur = cur->next)
+			cur->rank = ug_rank_tree_insert (node->index, NULL, cur);
+	}
+	return node->index;
+}
+
+// call this after children were reordered without uget_node_link_child().
+static void  uget_node_clear_index (UgetNode* node)
+{
+	UgetNode*  cur;
+
+	if (node->index == NULL)
+		return;
+	for (cur = node->children;  cur;  cur = cur->next)
+		cur->rank = NULL;
+	ug_rank_tree_clear (node->index);
+	ug_free (node->index);
+	node->index = NULL;
+}
+
+// ug_node_insert() and update index
+static void  uget_node_link_child (UgetNode* node, UgetNode* sibling, UgetNode* child)
+{
+	ug_node_insert ((UgNode*) node, (UgNode*) sibling, (UgNode*) child);
+	if (node->index) {
+		child->rank = ug_rank_tree_insert (node->index,
+				(sibling) ? sibling->rank : NULL, child);
+	}
+}
+
+// ug_node_remove() and update index
+static void  uget_node_unlink_child (UgetNode* node, UgetNode* child)
+{
+	ug_node_remove ((UgNode*) node, (UgNode*) child);
+	if (child->rank) {
+		ug_rank_tree_remove (node->index, child->rank);
+		child->rank = NULL;
+	}
+}
+
+// return TRUE if 'child' should be placed before 'cur'
+static inline int  uget_node_is_before (UgetNode* node, UgetNode* child, UgetNode* cur)
+{
+	if (node->control->sort.reverse == FALSE)
+		return node->control->sort.compare (cur, child) > 0;
+	else
+		return node->control->sort.compare (child, cur) > 0;
+}
+
+// binary search sibling of 'child' in sorted children of 'node'.
+// 'child' must not be a child of 'node'.
+static UgetNode* uget_node_find_sorted (UgetNode* node, UgetNode* child)
+{
+	UgRankNode*  rnode;
+	UgetNode*    sibling;
+
+	sibling = NULL;
+	rnode = uget_node_get_index (node)->root;
+	while (rnode) {
+		if (uget_node_is_before (node, child, rnode->data)) {
+			sibling = rnode->data;
+			rnode = rnode->left;
+		}
+		else
+			rnode = rnode->right;
+	}
+	return sibling;
+}
+
+// ----------------------------------------------------------------------------
+
 void  uget_node_move (UgetNode* node, UgetNode* sibling, UgetNode* child)
 {
 	UgetNode*  fake_sibling;
 	UgetNode*  fake_child;
 
-	ug_node_remove ((UgNode*) node, (UgNode*) child);
-	ug_node_insert ((UgNode*) node, (UgNode*) sibling, (UgNode*) child);
+	uget_node_unlink_child (node, child);
+	uget_node_link_child (node, sibling, child);
 
 	fake_sibling = NULL;
 	for (fake_child = child->fake;  fake_child;  fake_child = fake_child->peer) {
@@ -205,7 +285,7 @@ void  uget_node_insert (UgetNode* node, UgetNode* sibling, UgetNode* child)
 {
 	UgetNodeFunc inserted;
 
-	ug_node_insert ((UgNode*) node, (UgNode*) sibling, (UgNode*) child);
+	uget_node_link_child (node, sibling, child);
 	child->control = node->control;
 //	child->control = node->control->children;
 
@@ -237,7 +317,7 @@ static void  uget_node_unlink_fake_parent (UgetNode* child)
 		if (parent == NULL)
 			continue;
 		sibling = child->next;
-		ug_node_remove ((UgNode*) parent, (UgNode*) child);
+		uget_node_unlink_child (parent, child);
 		// notify
 		removed = parent->control->notifier->removed;
 		if (removed)
@@ -251,7 +331,7 @@ void  uget_node_remove (UgetNode* node, UgetNode* child)
 	UgetNodeFunc removed;
 
 	sibling = child->next;
-	ug_node_remove ((UgNode*)node, (UgNode*)child);
+	uget_node_unlink_child (node, child);
 	uget_node_unlink_fake_parent (child);
 	uget_node_unlink_children_real (child);
 
@@ -264,7 +344,7 @@ void  uget_node_append (UgetNode* node, UgetNode* child)
 {
 	UgetNodeFunc inserted;
 
-	ug_node_append ((UgNode*) node, (UgNode*) child);
+	uget_node_link_child (node, NULL, child);
 	child->control = node->control;
 //	child->control = node->control->children;
 
@@ -281,7 +361,7 @@ void  uget_node_prepend (UgetNode* node, UgetNode* child)
 	UgetNodeFunc inserted;
 
 	sibling = node->children;
-	ug_node_prepend ((UgNode*) node, (UgNode*) child);
+	uget_node_link_child (node, sibling, child);
 	child->control = node->control;
 //	child->control = node->control->children;
 
@@ -326,27 +406,42 @@ void  uget_node_sort(UgetNode* node, UgCompareFunc compare, int reversed)
 	int        index;
 	UgetNode** array;
 	UgetNode*  cur;
+	UgetNode*  prev;
+	UgetNodeKey*    keys;
+	UgetNodeKeyFunc key_func;
 
 	if (node->n_children == 0)
 		return;
+	// index will be rebuilt when it is needed
+	uget_node_clear_index(node);
 	array = (UgetNode**) ug_malloc(sizeof(UgetNode*) * node->n_children);
 	for (index = 0, cur = node->children;  cur;  cur = cur->next, index++)
 		array[index] = cur;
 
-	uget_node_qsort(array, 0, node->n_children -1, compare);
-
-	if (reversed) {
-		for (index = node->n_children-1;  index >=0;  index--) {
-			uget_node_remove(node, array[index]);
-			uget_node_append(node, array[index]);
-		}
+	key_func = uget_node_get_key_func(compare);
+	if (key_func) {
+		// extract sort keys once and sort them
+		keys = (UgetNodeKey*) ug_malloc(sizeof(UgetNodeKey) * node->n_children);
+		uget_node_sort_keys(keys, array, node->n_children, key_func);
+		for (index = 0;  index < node->n_children;  index++)
+			array[index] = keys[index].node;
+		ug_free(keys);
 	}
-	else {
-		for (index = 0;  index < node->n_children;  index++) {
-			uget_node_remove(node, array[index]);
-			uget_node_append(node, array[index]);
-		}
+	else
+		uget_node_qsort(array, 0, node->n_children -1, compare);
+
+	// relink children in sorted order. fake nodes of children are kept.
+	for (prev = NULL, index = 0;  index < node->n_children;  index++) {
+		cur = array[(reversed) ? node->n_children - 1 - index : index];
+		cur->prev = prev;
+		if (prev)
+			prev->next = cur;
+		else
+			node->children = cur;
+		prev = cur;
 	}
+	prev->next = NULL;
+	node->last = prev;
 	ug_free(array);
 }
 
@@ -380,32 +475,47 @@ void  uget_node_sort (UgetNode* node, UgCompareFunc compare, int reversed)
 
 void  uget_node_insert_sorted (UgetNode* node, UgetNode* child)
 {
-	UgCompareFunc  compare;
-	UgetNode*      cur;
-	int            reverse;
-
-	compare = node->control->sort.compare;
-	reverse = node->control->sort.reverse;
-	if (compare == NULL)
+	if (node->control->sort.compare == NULL)
 		return;
+	uget_node_insert (node, uget_node_find_sorted (node, child), child);
+}
 
-	if (reverse == FALSE) {
-		for (cur = node->children;  cur;  cur = cur->next) {
-			if (compare (cur, child) > 0) {
-				uget_node_insert (node, cur, child);
-				return;
-			}
-		}
-	}
-	else {
-		for (cur = node->children;  cur;  cur = cur->next) {
-			if (compare (child, cur) > 0) {
-				uget_node_insert (node, cur, child);
-				return;
-			}
+void  uget_node_reverse (UgetNode* node)
+{
+	ug_node_reverse ((UgNode*) node);
+	uget_node_clear_index (node);
+}
+
+int   uget_node_resort (UgetNode* node)
+{
+	UgetNode*    parent;
+	UgetNode*    sibling;
+	UgetNodeFunc notify;
+	int          counts = 0;
+
+	parent = node->parent;
+	if (parent && parent->control->sort.compare) {
+		if ((node->prev && uget_node_is_before (parent, node, node->prev)) ||
+		    (node->next && uget_node_is_before (parent, node->next, node)))
+		{
+			sibling = node->next;
+			uget_node_unlink_child (parent, node);
+			notify = parent->control->notifier->removed;
+			if (notify)
+				notify (parent, sibling, node);
+
+			sibling = uget_node_find_sorted (parent, node);
+			uget_node_link_child (parent, sibling, node);
+			notify = parent->control->notifier->inserted;
+			if (notify)
+				notify (parent, sibling, node);
+			counts++;
 		}
 	}
-	uget_node_insert (node, NULL, child);
+
+	for (node = node->fake;  node;  node = node->peer)
+		counts += uget_node_resort (node);
+	return counts;
 }
 
 void  uget_node_reorder_by_real (UgetNode* node, UgetNode* real)
@@ -427,8 +537,8 @@ void  uget_node_reorder_by_real (UgetNode* node, UgetNode* real)
 				sibling = sibling->next;
 				break;
 			}
-			ug_node_remove ((UgNode*) node, (UgNode*) fake);
-			ug_node_insert ((UgNode*) node, (UgNode*) sibling, (UgNode*) fake);
+			uget_node_unlink_child (node, fake);
+			uget_node_link_child (node, sibling, fake);
 			break;
 		}
 	}
@@ -449,8 +559,8 @@ void  uget_node_reorder_by_fake (UgetNode* node, UgetNode* fake)
 			continue;
 		if (real == sibling)
 			sibling = sibling->next;
-		ug_node_remove ((UgNode*) node, (UgNode*) real);
-		ug_node_insert ((UgNode*) node, (UgNode*) sibling, (UgNode*) real);
+		uget_node_unlink_child (node, real);
+		uget_node_link_child (node, sibling, real);
 	}
 }
 
@@ -41,6 +41,7 @@
 #include <stdint.h>    // int16_t
 #include <UgNode.h>
 #include <UgInfo.h>
+#include <UgRankTree.h>
 #include <UgUri.h>
 
 #ifdef __cplusplus
@@ -127,7 +128,9 @@ struct UgetNodeNotifier
 	// notify when a child node has updated.
 	UgNotifyFunc    updated;
 
-//	UgNotifyFunc    destroy;
+	// notify before node is freed if UgetNode.data is not NULL.
+	// user must release UgetNode.data in this callback.
+	UgNotifyFunc    destroy;
 
 	void*           data;      // extra data for user
 };
@@ -170,8 +173,14 @@ void  uget_node_remove (UgetNode* node, UgetNode* child);
 void  uget_node_append (UgetNode* node, UgetNode* child);
 void  uget_node_prepend (UgetNode* node, UgetNode* child);
 
+// reorder children at once, it doesn't notify inserted/removed.
 void  uget_node_sort (UgetNode* node, UgCompareFunc cmp_func, int is_reversed);
 void  uget_node_insert_sorted (UgetNode* node, UgetNode* child);
+void  uget_node_reverse (UgetNode* node);
+// move 'node' and it's fake nodes to sorted position if their parent is
+// sorted (control->sort.compare) and they are out of order.
+// return number of moved nodes.
+int   uget_node_resort (UgetNode* node);
 void  uget_node_reorder_by_real (UgetNode* node, UgetNode* real);
 void  uget_node_reorder_by_fake (UgetNode* node, UgetNode* fake);
 
@@ -217,6 +226,33 @@ int   uget_node_compare_uri          (UgetNode* node1, UgetNode* node2);
 int   uget_node_compare_added_time   (UgetNode* node1, UgetNode* node2);
 int   uget_node_compare_completed_time (UgetNode* node1, UgetNode* node2);
 
+/* ----------------------------------------------------------------------------
+   UgetNodeKey: sort key of UgetNode. uget_node_sort() extract keys once and
+                sort them instead of calling compare function that get data
+                from UgInfo in each comparison.
+   these function implemented in UgetNode-compare.c
+ */
+typedef struct UgetNodeKey       UgetNodeKey;
+typedef void (*UgetNodeKeyFunc) (UgetNodeKey* key, UgetNode* node);
+
+struct UgetNodeKey
+{
+	UgetNode*    node;
+	int          group;   // 0 if node has no data for this key
+	int64_t      value;
+	uint64_t     prefix;  // first 8 bytes of 'string' in big-endian order
+	const char*  string;  // compare it if 'value' are the same
+};
+
+// return key function of compare function or NULL if it has no key function.
+UgetNodeKeyFunc  uget_node_get_key_func (UgCompareFunc compare);
+// compare function for qsort()
+int   uget_node_compare_key (const void* key1, const void* key2);
+// extract keys of 'nodes' by 'key_func' and sort them.
+// large array will be split, sorted by multiple threads, and merged.
+void  uget_node_sort_keys (UgetNodeKey* keys, UgetNode** nodes, int n_nodes,
+                           UgetNodeKeyFunc key_func);
+
 /* ----------------------------------------------------------------------------
    callback functions for UgetNode.control.filter (they are used by UgetApp)
    these function implemented in UgetNode-filter.c
@@ -273,6 +309,13 @@ struct UgetNode
 	UgInfo*       info;
 	struct UgetNodeControl*  control;
 
+	void*         data;    // extra data for user (released by notifier->destroy)
+
+	// position index of children, uget_node_insert_sorted() create it
+	// to find sorted position by binary search.
+	UgRankTree*   index;
+	UgRankNode*   rank;    // UgRankNode of this node in parent->index
+
 #ifdef __cplusplus
 	inline void* operator new(size_t size, UgetNode* node_real = NULL)
 		{ return uget_node_new(node_real); }
@@ -39,6 +39,7 @@
 #endif
 
 //#include <UgStdio.h>
+#include <UgString.h>
 #include <UgetOption.h>
 #include <UgetData.h>
 
@@ -112,9 +113,10 @@ int  uget_option_value_to_info (UgetOptionValue* ivalue, UgInfo* info)
 		temp.common = ug_info_realloc(info, UgetCommonInfo);
 		temp.common->keeping.enable = TRUE;
 		if (ivalue->common.folder) {
-			ug_free(temp.common->folder);
-			temp.common->folder = ivalue->common.folder;
+			ug_str_unintern(temp.common->folder);
+			temp.common->folder = ug_str_intern(ivalue->common.folder);
 			temp.common->keeping.folder = TRUE;
+			ug_free(ivalue->common.folder);
 			ivalue->common.folder = NULL;
 		}
 		if (ivalue->common.file) {
@@ -146,9 +148,10 @@ int  uget_option_value_to_info (UgetOptionValue* ivalue, UgInfo* info)
 			ivalue->proxy.type = 0;
 		}
 		if (ivalue->proxy.host) {
-			ug_free(temp.proxy->host);
-			temp.proxy->host = ivalue->proxy.host;
+			ug_str_unintern(temp.proxy->host);
+			temp.proxy->host = ug_str_intern(ivalue->proxy.host);
 			temp.proxy->keeping.host = TRUE;
+			ug_free(ivalue->proxy.host);
 			ivalue->proxy.host = NULL;
 		}
 		if (ivalue->proxy.port) {
@@ -186,15 +189,17 @@ int  uget_option_value_to_info (UgetOptionValue* ivalue, UgInfo* info)
 			ivalue->http.password = NULL;
 		}
 		if (ivalue->http.referrer) {
-			ug_free(temp.http->referrer);
-			temp.http->referrer = ivalue->http.referrer;
+			ug_str_unintern(temp.http->referrer);
+			temp.http->referrer = ug_str_intern(ivalue->http.referrer);
 			temp.http->keeping.referrer = TRUE;
+			ug_free(ivalue->http.referrer);
 			ivalue->http.referrer = NULL;
 		}
 		if (ivalue->http.user_agent) {
-			ug_free(temp.http->user_agent);
-			temp.http->user_agent = ivalue->http.user_agent;
+			ug_str_unintern(temp.http->user_agent);
+			temp.http->user_agent = ug_str_intern(ivalue->http.user_agent);
 			temp.http->keeping.user_agent = TRUE;
+			ug_free(ivalue->http.user_agent);
 			ivalue->http.user_agent = NULL;
 		}
 		if (ivalue->http.cookie_data) {
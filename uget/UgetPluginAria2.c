@@ -69,10 +69,10 @@ static gboolean	uget_plugin_aria2_set_proxy_pwmd (UgetPluginAria2 *plugin, UgInf
 #define  _(x)   x
 #endif
 
-static UgJsonrpcObject*  alloc_speed_request(UgetPluginAria2* plugin);
-static void              recycle_speed_request(UgJsonrpcObject* object);
-static UgJsonrpcObject*  alloc_status_request(UgValue** gid);
-static void              recycle_status_request(UgJsonrpcObject* object);
+static void  send_speed_request(UgetPluginAria2* plugin);
+
+// "%d" of int needs 12 bytes
+#define SPEED_LIMIT_LEN    16
 
 static void* ug_file_to_base64(const char* file, int* length);
 static int   decide_file_type(UgetPluginAria2* plugin);
@@ -162,8 +162,8 @@ static void  global_unref(void)
 
 	global.ref_count--;
 	if (global.ref_count == 0) {
-		if (global.data->shutdown)
-			uget_aria2_shutdown(global.data);
+		// thread of UgetAria2 will send "aria2.shutdown" if
+		// global.data->shutdown is TRUE. This may be called by that thread.
 		uget_aria2_stop_thread(global.data);
 		uget_aria2_unref(global.data);
 		global.data = NULL;
@@ -225,6 +225,10 @@ static UgetResult  global_set(int option, void* parameter)
 			uget_aria2_shutdown(global.data);
 		break;
 
+	case UGET_PLUGIN_ARIA2_GLOBAL_UNIX_SOCKET:
+		uget_aria2_set_unix_socket(global.data, (char*) parameter);
+		break;
+
 	case UGET_PLUGIN_GLOBAL_SETTING:
 		setting = parameter;
 		global.data->polling_interval = setting->polling_interval;
@@ -336,6 +340,7 @@ static void  plugin_final(UgetPluginAria2* plugin)
 		ug_value_foreach(&plugin->start_request->params, ug_value_set_name, NULL);
 		uget_aria2_recycle(global.data, plugin->start_request);
 	}
+	uget_aria2_recycle(global.data, plugin->speed_request);
 
 	global_unref();
 }
@@ -534,6 +539,8 @@ static int  plugin_sync(UgetPluginAria2* plugin, UgInfo* node_info)
 				temp.common->uri  = ug_strdup(file1->path);
 				temp.common->name = uget_name_from_uri_str(temp.common->uri);
 				temp.common->file = NULL;
+				uget_plugin_post((UgetPlugin*) plugin,
+						uget_event_new(UGET_EVENT_NAME));
 #ifndef NDEBUG
 				// debug
 				if (temp.common->debug_level)
@@ -641,7 +648,8 @@ static int  plugin_sync(UgetPluginAria2* plugin, UgInfo* node_info)
 }
 
 // ----------------------------------------------------------------------------
-// plugin_thread
+// plugin_watch: thread of UgetAria2 call it after status of all downloads
+//               was polled. It must not wait for response.
 
 static void  add_gids_by_value_array(UgArrayStr* gids, UgValueArray* varray)
 {
@@ -660,12 +668,14 @@ static void  add_gids_by_value_array(UgArrayStr* gids, UgValueArray* varray)
 	}
 }
 
-static int  send_start_request(UgetPluginAria2* plugin)
+static void  send_start_request(UgetPluginAria2* plugin)
 {
-	UgJsonrpcObject*  res;
-
+	plugin->starting = TRUE;
 	uget_aria2_request(global.data, plugin->start_request);
-	res = uget_aria2_respond(global.data, plugin->start_request);
+}
+
+static int  recv_start_response(UgetPluginAria2* plugin, UgJsonrpcObject* res)
+{
 	if (res == NULL) {
 #ifdef HAVE_GLIB
 		uget_plugin_post((UgetPlugin*) plugin,
@@ -695,206 +705,197 @@ static int  send_start_request(UgetPluginAria2* plugin)
 	return TRUE;
 }
 
-static int  plugin_delay(UgetPluginAria2* plugin)
+static void  send_remove_request(UgetPluginAria2* plugin)
 {
-	unsigned int  count;
+	UgJsonrpcObject*  req;
+	UgValue*          value;
+	int               count;
 
-	for (count = 0;  count < plugin->retry_delay;  count++) {
-		if (plugin->paused)
-			return FALSE;
-		// sleep 1 second every time
-		ug_sleep(1000);
+	// "aria2.remove" without response
+	req = uget_aria2_alloc(global.data, TRUE, FALSE);
+	req->method_static = "aria2.remove";
+	// if there is no secret token in params.
+	if (req->params.type == UG_VALUE_NONE)
+		ug_value_init_array(&req->params, plugin->gids.length);
+	// add gids to params.
+	value = ug_value_alloc(&req->params, plugin->gids.length);
+	for (count = 0;  count < plugin->gids.length;  count++, value++) {
+		value->type = UG_VALUE_STRING;
+		value->c.string = ug_strdup(plugin->gids.at[count]);
 	}
-	return TRUE;
+	uget_aria2_request(global.data, req);
 }
 
-static UgThreadResult  plugin_thread(UgetPluginAria2* plugin)
+static void  parse_status(UgetPluginAria2* plugin, UgValue* status)
 {
-	UgJsonrpcObject*  req;
-	UgJsonrpcObject*  res;
-	UgJsonrpcObject*  status_req;
-	UgValue*          status_gid;
-	UgValue*          value;
-	UgValue*          member;
-	int               count;
-
-	// create status_req and initialize status_gid
-	status_req = alloc_status_request(&status_gid);
-	// send start_request to server
-	plugin->restart = FALSE;
-	if (send_start_request(plugin) == FALSE)
-		goto exit;
+	UgValue*  value;
+	UgValue*  member;
+	int       count;
 
-	while (plugin->paused == FALSE) {
-		// retry
-		if (plugin->restart == TRUE) {
-			if (plugin_delay(plugin) == FALSE)
+	// members of status has been sorted by UgetAria2
+	value = ug_value_find_name(status, "status");
+	switch ((value && value->c.string) ? value->c.string[0] : 0) {
+	case 'a':
+		plugin->status = ARIA2_STATUS_ACTIVE;
+		break;
+	case 'w':
+		plugin->status = ARIA2_STATUS_WAITING;
+		break;
+	case 'p':
+		plugin->status = ARIA2_STATUS_PAUSED;
+		break;
+	case 'e':
+		plugin->status = ARIA2_STATUS_ERROR;
+		break;
+	case 'c':
+		plugin->status = ARIA2_STATUS_COMPLETE;
+		break;
+	case 'r':
+		plugin->status = ARIA2_STATUS_REMOVED;
+		break;
+	default:
+		plugin->status = ARIA2_N_STATUS;
+		break;
+	}
+	value = ug_value_find_name(status, "errorCode");
+	plugin->errorCode = (value) ? ug_value_get_int(value) : 0;
+	value = ug_value_find_name(status, "totalLength");
+	plugin->totalLength = ug_value_get_int64(value);
+	value = ug_value_find_name(status, "completedLength");
+	plugin->completedLength = ug_value_get_int64(value);
+	value = ug_value_find_name(status, "uploadLength");
+	plugin->uploadLength = ug_value_get_int64(value);
+	value = ug_value_find_name(status, "downloadSpeed");
+	plugin->downloadSpeed = ug_value_get_int(value);
+	value = ug_value_find_name(status, "uploadSpeed");
+	plugin->uploadSpeed = ug_value_get_int(value);
+	value = ug_value_find_name(status, "followedBy");
+	if (value)
+		add_gids_by_value_array(&plugin->gids, value->c.array);
+	value = ug_value_find_name(status, "files");
+	if (value && ug_value_length(value) != plugin->files_per_gid) {
+		UgValueArray*  array;
+		UgetFile*      ufile;
+		char*          string;
+
+		array = value->c.array;
+		plugin->files_per_gid = ug_value_length(value);
+		for (count = 0;  count < array->length;  count++) {
+			value = array->at + count;
+			ug_value_sort_name(value);
+			member = ug_value_find_name(value, "path");
+			if (member == NULL || member->c.string[0] == '\0') {
+				plugin->files_per_gid--;
 				continue;
-#ifndef NDEBUG
-			// debug
-			printf("retry\n");
-#endif
-			// send start_request to server again
-			plugin->restart = FALSE;
-			if (send_start_request(plugin) == FALSE)
-				goto exit;
-		}
-		// Don't update status until user call plugin_sync()
-		if (plugin->synced == FALSE) {
-			// sleep 0.5 second
-			ug_sleep(500);
-			continue;
+			}
+			uget_plugin_lock(plugin);
+			// add .aria2 control file first
+			if (plugin->files_per_gid == 1) {
+				string = ug_strdup_printf("%s.aria2", member->c.string);
+				ufile = uget_files_realloc(plugin->files, string);
+				ufile->type = UGET_FILE_TEMPORARY;
+				ug_free(string);
+			}
+			// add downloading file
+			ufile = uget_files_realloc(plugin->files, member->c.string);
+			member = ug_value_find_name(value, "completedLength");
+			ufile->complete = ug_value_get_int64(member);
+			member = ug_value_find_name(value, "length");
+			ufile->total = ug_value_get_int64(member);
+			uget_plugin_unlock(plugin);
 		}
+	}
+}
 
-		// set gid for status request
-//		status_req->params.c.array->at[0].c.string = plugin->gids.at[0];
-		status_gid->c.string = plugin->gids.at[0];
-		// status request
-		uget_aria2_request(global.data, status_req);
-		// speed control : speed request & response
-		if (plugin->limit_changed) {
-			plugin->limit_changed = FALSE;
-			// request & response
-			req = alloc_speed_request(plugin);
-			uget_aria2_request(global.data, req);
-			res = uget_aria2_respond(global.data, req);
-			// recycle
-			uget_aria2_recycle(global.data, res);
-			recycle_speed_request(req);
-		}
-		// status respond
-		res = uget_aria2_respond(global.data, status_req);
-		if (res == NULL) {
-#ifdef HAVE_GLIB
-			uget_plugin_post((UgetPlugin*) plugin,
-					uget_event_new_error(0, gettext(aria2_no_response)));
-#else
-			uget_plugin_post((UgetPlugin*) plugin,
-					uget_event_new_error(0, aria2_no_response));
-#endif
-			goto exit;
-		}
-		if (res->error.code) {
-			uget_plugin_post((UgetPlugin*)plugin,
-					uget_event_new_error(0, res->error.message));
-			uget_aria2_recycle(global.data, res);
+// return FALSE if plug-in stop watching.
+static int  plugin_watch(UgetPluginAria2* plugin, UgetAria2* uaria2)
+{
+	UgJsonrpcObject*  res;
+	UgValue*          status;
+
+	// response of start_request
+	if (plugin->starting) {
+		if (uget_aria2_try_respond(uaria2, plugin->start_request, &res) == FALSE)
+			return TRUE;
+		plugin->starting = FALSE;
+		if (recv_start_response(plugin, res) == FALSE)
 			goto exit;
+	}
+	// response of speed request
+	if (plugin->limiting) {
+		if (uget_aria2_try_respond(uaria2, plugin->speed_request, &res)) {
+			uget_aria2_recycle(uaria2, res);
+			plugin->limiting = FALSE;
 		}
+	}
+	// Don't update status until user call plugin_sync()
+	if (plugin->synced == FALSE)
+		return TRUE;
 
-		// parse status response --- start ---
-		ug_value_sort_name(&res->result);
-		value = ug_value_find_name(&res->result, "status");
-		switch (value->c.string[0]) {
-		case 'a':
-			plugin->status = ARIA2_STATUS_ACTIVE;
-			break;
-		case 'w':
-			plugin->status = ARIA2_STATUS_WAITING;
-			break;
-		case 'p':
-			plugin->status = ARIA2_STATUS_PAUSED;
-			break;
-		case 'e':
-			plugin->status = ARIA2_STATUS_ERROR;
-			break;
-		case 'c':
-			plugin->status = ARIA2_STATUS_COMPLETE;
-			break;
-		case 'r':
-			plugin->status = ARIA2_STATUS_REMOVED;
-			break;
-		default:
-			plugin->status = ARIA2_N_STATUS;
-			break;
-		}
-		value = ug_value_find_name(&res->result, "errorCode");
-		plugin->errorCode = (value) ? ug_value_get_int(value) : 0;
-		value = ug_value_find_name(&res->result, "totalLength");
-		plugin->totalLength = ug_value_get_int64(value);
-		value = ug_value_find_name(&res->result, "completedLength");
-		plugin->completedLength = ug_value_get_int64(value);
-		value = ug_value_find_name(&res->result, "uploadLength");
-		plugin->uploadLength = ug_value_get_int64(value);
-		value = ug_value_find_name(&res->result, "downloadSpeed");
-		plugin->downloadSpeed = ug_value_get_int(value);
-		value = ug_value_find_name(&res->result, "uploadSpeed");
-		plugin->uploadSpeed = ug_value_get_int(value);
-		value = ug_value_find_name(&res->result, "followedBy");
-		if (value)
-			add_gids_by_value_array(&plugin->gids, value->c.array);
-		value = ug_value_find_name(&res->result, "files");
-		if (value && ug_value_length(value) != plugin->files_per_gid) {
-			UgValueArray*  array;
-			UgetFile*      ufile;
-			char*          string;
-
-			array = value->c.array;
-			plugin->files_per_gid = ug_value_length(value);
-			for (count = 0;  count < array->length;  count++) {
-				value = array->at + count;
-				ug_value_sort_name(value);
-				member = ug_value_find_name(value, "path");
-				if (member == NULL || member->c.string[0] == '\0') {
-					plugin->files_per_gid--;
-					continue;
-				}
-				uget_plugin_lock(plugin);
-				// add .aria2 control file first
-				if (plugin->files_per_gid == 1) {
-					string = ug_strdup_printf("%s.aria2", member->c.string);
-					ufile = uget_files_realloc(plugin->files, string);
-					ufile->type = UGET_FILE_TEMPORARY;
-					ug_free(string);
-				}
-				// add downloading file
-				ufile = uget_files_realloc(plugin->files, member->c.string);
-				member = ug_value_find_name(value, "completedLength");
-				ufile->complete = ug_value_get_int64(member);
-				member = ug_value_find_name(value, "length");
-				ufile->total = ug_value_get_int64(member);
-				uget_plugin_unlock(plugin);
-			}
-		}
-		// parse status response --- end ---
-
-		// recycle status response
-		uget_aria2_recycle(global.data, res);
-		// plugin_sync() will exchange data
-		plugin->synced = FALSE;
+	// stopped by user or plugin_sync()
+	if (plugin->paused) {
+		// wait for response of speed request before stopping
+		if (plugin->limiting)
+			return TRUE;
+		if (plugin->gids.length)
+			send_remove_request(plugin);
+		goto exit;
 	}
 
-	if (plugin->gids.length) {
-		req = uget_aria2_alloc(global.data, TRUE, TRUE);
-		req->method_static = "aria2.remove";
-		// if there is no secret token in params.
-		if (req->params.type == UG_VALUE_NONE)
-			ug_value_init_array(&req->params, plugin->gids.length);
-		// add gids to params.
-		value = ug_value_alloc(&req->params, plugin->gids.length);
-		for (count = 0;  count < plugin->gids.length;  count++, value++) {
-			value->type = UG_VALUE_STRING;
-			value->c.string = ug_strdup(plugin->gids.at[count]);
-		}
-		// call "aria2.remove"
-		uget_aria2_request(global.data, req);
-		res = uget_aria2_respond(global.data, req);
+	// retry
+	if (plugin->restart == TRUE) {
+		if (plugin->retry_time == 0)
+			plugin->retry_time = time(NULL) + plugin->retry_delay;
+		if (time(NULL) < plugin->retry_time)
+			return TRUE;
 #ifndef NDEBUG
 		// debug
-		if (res->error.code) {
-			printf("aria2.remove() response error code = %d" "\n"
-			       "               message = \"%s\"." "\n",
-			       res->error.code, res->error.message);
-		}
+		printf("retry\n");
 #endif
-		uget_aria2_recycle(global.data, res);
-		uget_aria2_recycle(global.data, req);
+		// send start_request to server again
+		plugin->retry_time = 0;
+		plugin->restart = FALSE;
+		send_start_request(plugin);
+		return TRUE;
 	}
 
+	// speed control : speed request
+	if (plugin->limit_changed && plugin->limiting == FALSE) {
+		plugin->limit_changed = FALSE;
+		send_speed_request(plugin);
+	}
+
+	status = uget_aria2_find_status(uaria2, plugin->gids.at[0]);
+	if (status)
+		parse_status(plugin, status);
+	else if (uaria2->connect_fail) {
+#ifdef HAVE_GLIB
+		uget_plugin_post((UgetPlugin*) plugin,
+				uget_event_new_error(0, gettext(aria2_no_response)));
+#else
+		uget_plugin_post((UgetPlugin*) plugin,
+				uget_event_new_error(0, aria2_no_response));
+#endif
+		goto exit;
+	}
+	else {
+		// gid is not in active, waiting, and stopped list.
+		plugin->status = ARIA2_STATUS_REMOVED;
+	}
+
+	// plugin_sync() will exchange data
+	plugin->synced = FALSE;
+	return TRUE;
+
 exit:
-	recycle_status_request(status_req);
+	// wait for response of speed request before stopping
+	if (plugin->limiting) {
+		plugin->paused = TRUE;
+		return TRUE;
+	}
 	plugin->stopped = TRUE;
 	uget_plugin_unref((UgetPlugin*)plugin);
-	return UG_THREAD_RESULT;
+	return FALSE;
 }
 
 // ----------------------------------------------------------------------------
@@ -1083,7 +1084,7 @@ static int  plugin_accept(UgetPluginAria2* plugin, UgInfo* node_info)
 	temp.proxy = ug_info_get(node_info, UgetProxyInfo);
 #ifdef HAVE_LIBPWMD
 	if (temp.proxy && temp.proxy->type == UGET_PROXY_PWMD) {
-		if (uget_plugin_aria2_set_proxy_pwmd(plugin, node_info, member) == FALSE)
+		if (uget_plugin_aria2_set_proxy_pwmd(plugin, node_info, member) == FALSE)
 			return FALSE;
 	}
 	else
@@ -1188,27 +1189,15 @@ static int  plugin_accept(UgetPluginAria2* plugin, UgInfo* node_info)
 
 static int  plugin_start(UgetPluginAria2* plugin)
 {
-	UgThread  thread;
-	int       ok;
-
-	// try to start thread
 	plugin->paused = FALSE;
 	plugin->stopped = FALSE;
+	plugin->restart = FALSE;
+	plugin->retry_time = 0;
+	// send start_request to server, plugin_watch() will get response and
+	// status of download. UgetAria2 keep reference count until it return FALSE.
 	uget_plugin_ref((UgetPlugin*) plugin);
-	ok = ug_thread_create(&thread, (UgThreadFunc) plugin_thread, plugin);
-	if (ok == UG_THREAD_OK)
-		ug_thread_unjoin(&thread);
-	else {
-		// failed to start thread -----------------
-		plugin->paused = TRUE;
-		plugin->stopped = TRUE;
-		// post error message and decreases the reference count
-		uget_plugin_post((UgetPlugin*) plugin,
-				uget_event_new_error(UGET_EVENT_ERROR_THREAD_CREATE_FAILED,
-				                     NULL));
-		uget_plugin_unref((UgetPlugin*) plugin);
-		return FALSE;
-	}
+	send_start_request(plugin);
+	uget_aria2_watch(global.data, (UgetAria2WatchFunc) plugin_watch, plugin);
 	return TRUE;
 }
 
@@ -1216,90 +1205,53 @@ static int  plugin_start(UgetPluginAria2* plugin)
 // JSON-RPC request
 
 // speed control
-static UgJsonrpcObject*  alloc_speed_request(UgetPluginAria2* plugin)
+// speed_request is built once, gid and limits are patched before sending.
+static void  send_speed_request(UgetPluginAria2* plugin)
 {
 	UgJsonrpcObject*  object;
 	UgValue*          options;
 	UgValue*          value;
 
-	object = uget_aria2_alloc(global.data, TRUE, TRUE);
-	object->method_static = "aria2.changeOption";
-	if (object->params.type == UG_VALUE_NONE)
-		ug_value_init_array(&object->params, 2);
-	// gid
-	value = ug_value_alloc(&object->params, 1);
-	value->type = UG_VALUE_STRING;
-	value->c.string = plugin->gids.at[0];
-	// object
-	options = ug_value_alloc(&object->params, 1);
-	ug_value_init_object(options, 2);
-	// max-download-limit
-	value = ug_value_alloc(options, 1);
-	value->name = ug_strdup("max-download-limit");
-	value->type = UG_VALUE_STRING;
-	value->c.string = ug_strdup_printf("%d", plugin->limit[0]);
-	// max-upload-limit
-	value = ug_value_alloc(options, 1);
-	value->name = ug_strdup("max-upload-limit");
-	value->type = UG_VALUE_STRING;
-	value->c.string = ug_strdup_printf("%d", plugin->limit[1]);
-
-	return object;
-}
-
-static void  recycle_speed_request(UgJsonrpcObject* object)
-{
-	UgValue*  value;
-
-	value = uget_aria2_clear_token(object);
-	// params[0] is gid
-//	value = object->params.c.array->at;
-	value->type = UG_VALUE_NONE;
-	value->c.array = NULL;
-	// ready to recycle it
-	uget_aria2_recycle(global.data, object);
-}
-
-static UgJsonrpcObject*  alloc_status_request(UgValue** gid)
-{
-	UgJsonrpcObject*  object;
-	UgValue*  params;
-	UgValue*  keys;
-
-	// prepare JSON-RPC object for "aria2.tellStatus"
-	object = uget_aria2_alloc(global.data, TRUE, TRUE);
-	object->method_static = "aria2.tellStatus";
-	params = &object->params;
-	if (params->type == UG_VALUE_NONE)
-		ug_value_init_array(params, 2);
-	// gid
-	gid[0] = ug_value_alloc(params, 1);
-	gid[0]->type = UG_VALUE_STRING;
-	gid[0]->c.string = NULL;
-	// keys array from UgetAria2.status_keys
-	keys = ug_value_alloc(params, 1);
-	keys->type = UG_VALUE_ARRAY;
-	keys->c.array = global.data->status_keys.c.array;
-
-	return  object;
-}
+	object = plugin->speed_request;
+	if (object == NULL) {
+		object = uget_aria2_alloc(global.data, TRUE, TRUE);
+		object->method_static = "aria2.changeOption";
+		if (object->params.type == UG_VALUE_NONE)
+			ug_value_init_array(&object->params, 2);
+		// gid
+		value = ug_value_alloc(&object->params, 1);
+		value->type = UG_VALUE_STRING;
+		value->c.string = NULL;
+		// object
+		options = ug_value_alloc(&object->params, 1);
+		ug_value_init_object(options, 2);
+		// max-download-limit
+		value = ug_value_alloc(options, 1);
+		value->name = ug_strdup("max-download-limit");
+		value->type = UG_VALUE_STRING;
+		value->c.string = ug_malloc(SPEED_LIMIT_LEN);
+		// max-upload-limit
+		value = ug_value_alloc(options, 1);
+		value->name = ug_strdup("max-upload-limit");
+		value->type = UG_VALUE_STRING;
+		value->c.string = ug_malloc(SPEED_LIMIT_LEN);
+		plugin->speed_request = object;
+	}
 
-static void  recycle_status_request(UgJsonrpcObject* object)
-{
-	UgValue*  value;
+	// params = [secret, ]gid, options
+	value = object->params.c.array->at + object->params.c.array->length - 2;
+	// gid, plugin_sync() may remove gid before request is sent.
+	if (value->c.string == NULL || strcmp(value->c.string, plugin->gids.at[0]) != 0) {
+		ug_free(value->c.string);
+		value->c.string = ug_strdup(plugin->gids.at[0]);
+	}
+	options = value + 1;
+	value = options->c.object->at;
+	snprintf(value[0].c.string, SPEED_LIMIT_LEN, "%d", plugin->limit[0]);
+	snprintf(value[1].c.string, SPEED_LIMIT_LEN, "%d", plugin->limit[1]);
 
-	value = uget_aria2_clear_token(object);
-	// params[0] is gid
-//	value = object->params.c.array->at;
-	value->type = UG_VALUE_NONE;
-	value->c.array = NULL;
-	// params[1] is keys of status
-//	value = object->params.c.array->at + 1;
-	value++;
-	value->type = UG_VALUE_NONE;
-	value->c.array = NULL;
-	// ready to recycle it
-	uget_aria2_recycle(global.data, object);
+	plugin->limiting = TRUE;
+	uget_aria2_request(global.data, object);
 }
 
 // ----------------------------------------------------------------------------
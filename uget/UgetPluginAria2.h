@@ -61,6 +61,7 @@ typedef enum {
 	UGET_PLUGIN_ARIA2_GLOBAL_LAUNCH,    // get/set parameter = (intptr_t)
 	UGET_PLUGIN_ARIA2_GLOBAL_SHUTDOWN,  // set parameter = (intptr_t)
 	UGET_PLUGIN_ARIA2_GLOBAL_SHUTDOWN_NOW,  // set parameter = (intptr_t)
+	UGET_PLUGIN_ARIA2_GLOBAL_UNIX_SOCKET,   // set parameter = (char* )
 } UgetPluginAria2GlobalCode;
 
 typedef enum {
@@ -97,12 +98,15 @@ struct UgetPluginAria2
 	UgUri             uri_part;
 	int               uri_type;
 	unsigned int      retry_delay;
+	time_t            retry_time;
+	// aria2.changeOption, it is patched and sent again if limit changed.
+	UgJsonrpcObject*  speed_request;
 	// all gids and it's files
 	UgArrayStr        gids;
 	UgetFiles*        files;
 	int               files_per_gid;
 
-	// aria2.tellStatus
+	// status from aria2.tellActive, aria2.tellWaiting, aria2.tellStopped
 	int        status;
 	int        errorCode;
 	int64_t    totalLength;
@@ -124,6 +128,8 @@ struct UgetPluginAria2
 	uint8_t    stopped:1;   // download is stopped
 	uint8_t    restart:1;   // for retry
 	uint8_t    named:1;
+	uint8_t    starting:1;  // waiting for response of start_request
+	uint8_t    limiting:1;  // waiting for response of speed_request
 };
 
 // ----------------------------------------------------------------------------
@@ -133,7 +139,7 @@ struct UgetPluginAria2Setting
 	uint8_t    launch;
 	uint8_t    shutdown;
 
-	// millisecond interval between aria2.tellStatus()
+	// millisecond interval between status polling
 	int        polling_interval;
 
 	char*      uri;
@@ -218,6 +218,8 @@ static int  plugin_sync(UgetPluginMedia* plugin, UgInfo* node_info)
 		}
 		else
 			common->name = ug_strdup(plugin->title);
+		uget_plugin_post((UgetPlugin*) plugin,
+				uget_event_new(UGET_EVENT_NAME));
 	}
 
 	// sync common data (include speed limit) between foreign data and target_info
@@ -295,6 +297,7 @@ static UgThreadResult  plugin_thread(UgetPluginMedia* plugin)
 	UgetEvent*     msg;
 	const char*    type = NULL;
 	const char*    quality = NULL;
+	char*          referrer;
 
 	common = plugin->target_common;
 	umedia = uget_media_new(common->uri, 0);
@@ -336,8 +339,11 @@ static UgThreadResult  plugin_thread(UgetPluginMedia* plugin)
 
 	// set HTTP referrer
 	http = ug_info_realloc(plugin->target_info, UgetHttpInfo);
-	if (http->referrer == NULL)
-		http->referrer = ug_strdup_printf("%s%s", common->uri, "# ");
+	if (http->referrer == NULL) {
+		referrer = ug_strdup_printf("%s%s", common->uri, "# ");
+		http->referrer = ug_str_intern(referrer);
+		ug_free(referrer);
+	}
 	// clear copied common URI
 	ug_free(common->uri);
 	common->uri = NULL;
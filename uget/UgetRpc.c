@@ -58,9 +58,16 @@
 //#define UGET_RPC_LIMIT     50
 
 static void uget_rpc_on_destroy (void* data);
-static void on_accepted (UgJsonrpc* jrpc, UgetRpc* urpc, void* data);
+static void on_request (UgJsonrpc* jrpc, int type,
+                        UgJsonrpcObject* jobject, UgJsonrpcArray* jarray,
+                        UgetRpc* urpc);
 static void set_invalid_request (UgJsonrpcObject* jobj);
+static void set_error (UgJsonrpcObject* jobj, int code, const char* message);
 static void backup_data_file (UgetOptionValue* uoval, const char* dir);
+static int  do_query (UgetRpc* urpc, UgJsonrpcObject* jobj, const char* method);
+static int  do_subscription (UgetRpc* urpc, UgJsonrpc* jrpc, UgJsonrpcObject* jobj);
+static void on_push_timer (UgSocketWatch* watch, int events);
+static void uget_rpc_snapshot_unref (UgetRpc* urpc, UgetRpcSnapshot* snapshot);
 
 UgetRpc*  uget_rpc_new (const char* backup_dir)
 {
@@ -85,6 +92,19 @@ UgetRpc*  uget_rpc_new (const char* backup_dir)
 		urpc->backup_dir = ug_strdup (backup_dir);
 	else
 		urpc->backup_dir = NULL;
+
+	ug_mutex_init (&urpc->snapshot_lock);
+	ug_cond_init (&urpc->snapshot_cond);
+	urpc->snapshot = NULL;
+	urpc->snapshot_read = 0;
+	urpc->pushed = NULL;
+	ug_array_init (&urpc->subscribers, sizeof (void*), 8);
+	ug_array_init (&urpc->joining, sizeof (void*), 8);
+	memset (&urpc->push_timer, 0, sizeof (UgSocketWatch));
+	urpc->push_timer.socket = INVALID_SOCKET;
+	urpc->push_timer.timeout = UGET_RPC_PUSH_INTERVAL;
+	urpc->push_timer.func = on_push_timer;
+	urpc->push_timer.data = urpc;
 #ifdef USE_UNIX_DOMAIN_SOCKET
 	urpc->socket_path = NULL;
 	urpc->socket_path_len = 0;
@@ -137,6 +157,14 @@ static void uget_rpc_on_destroy (void* data)
 //	ug_list_clear (&urpc->queue, FALSE);
 	ug_mutex_clear (&urpc->queue_lock);
 
+	// server thread has been stopped, subscribers have been closed.
+	uget_rpc_snapshot_unref (urpc, urpc->pushed);
+	uget_rpc_snapshot_unref (urpc, urpc->snapshot);
+	ug_array_clear (&urpc->subscribers);
+	ug_array_clear (&urpc->joining);
+	ug_cond_clear (&urpc->snapshot_cond);
+	ug_mutex_clear (&urpc->snapshot_lock);
+
 #ifdef USE_UNIX_DOMAIN_SOCKET
 	// Don't delete file if path is abstract socket names (begin with 0)
 	if (urpc->server && urpc->socket_path[0])
@@ -155,6 +183,7 @@ int  uget_rpc_do_request (UgetRpc* urpc, UgJsonrpcObject* jobj)
 	UgLink*        urilink;
 	const char*    method;
 	int            index;
+	int            result;
 
 	if (jobj->method_static)
 		method = jobj->method_static;
@@ -227,6 +256,8 @@ int  uget_rpc_do_request (UgetRpc* urpc, UgJsonrpcObject* jobj)
 		jobj->result.c.boolean = TRUE;
 		return TRUE;
 	}
+	else if ((result = do_query (urpc, jobj, method)) != -1)
+		return result;
 
 	// {"jsonrpc": "2.0", "error": {"code": -32601, "message": "Method not found"}, "id": "1"}
 	ug_jsonrpc_object_clear_request (jobj);
@@ -398,10 +429,9 @@ int   uget_rpc_start_server (UgetRpc* urpc, int detect_server)
 		return FALSE;
 	urpc->server->destroy.func = uget_rpc_on_destroy;
 	urpc->server->destroy.data = urpc;
-	ug_jsonrpc_socket_use_server ((UgJsonrpcSocket*) urpc, urpc->server,
-	                              (UgJsonrpcServerFunc) on_accepted,
-	                              urpc, NULL);
-	ug_socket_server_start (urpc->server);
+	// handle all clients concurrently in server thread
+	ug_socket_server_poll_jsonrpc (urpc->server,
+	                               (UgJsonrpcRequestFunc) on_request, urpc);
 	return TRUE;
 }
 
@@ -431,31 +461,595 @@ UgetRpcReq* uget_rpc_get_request (UgetRpc* urpc)
 	return link;
 }
 
-static void on_accepted (UgJsonrpc* jrpc, UgetRpc* urpc, void* data)
+static void on_request (UgJsonrpc* jrpc, int type,
+                        UgJsonrpcObject* jobject, UgJsonrpcArray* jarray,
+                        UgetRpc* urpc)
 {
 	UgJsonrpcObject*  jobj;
-	UgJsonType  type;
 	int         index;
 
-	type = ug_jsonrpc_receive (jrpc, &urpc->jobject, &urpc->jarray);
 	if (type == UG_JSON_OBJECT) {
-		uget_rpc_do_request (urpc, &urpc->jobject);
-		if (urpc->jobject.id.type != UG_VALUE_NONE)
-			ug_jsonrpc_response (jrpc, &urpc->jobject);
-		ug_jsonrpc_object_clear (&urpc->jobject);
+		if (do_subscription (urpc, jrpc, jobject) == -1)
+			uget_rpc_do_request (urpc, jobject);
+		if (jobject->id.type != UG_VALUE_NONE)
+			ug_jsonrpc_response (jrpc, jobject);
+		ug_jsonrpc_object_clear (jobject);
 	}
 	else if (type == UG_JSON_ARRAY) {
-		for (index = 0;  index < urpc->jarray.length;  index++) {
-			jobj = urpc->jarray.at[index];
-			uget_rpc_do_request (urpc, jobj);
+		for (index = 0;  index < jarray->length;  index++) {
+			jobj = jarray->at[index];
+			if (do_subscription (urpc, jrpc, jobj) == -1)
+				uget_rpc_do_request (urpc, jobj);
 			if (jobj->id.type == UG_VALUE_NONE && jobj->error.code == 0) {
 				ug_jsonrpc_object_free (jobj);
-				urpc->jarray.at[index] = NULL;
+				jarray->at[index] = NULL;
+			}
+		}
+		ug_jsonrpc_response_batch (jrpc, jarray);
+		ug_jsonrpc_array_clear (jarray, TRUE);
+	}
+}
+
+// ----------------------------------------------------------------------------
+// snapshot
+
+static int  compare_status_id (const void* s1, const void* s2)
+{
+	uintptr_t  id1 = (*(UgetRpcStatus**) s1)->id;
+	uintptr_t  id2 = (*(UgetRpcStatus**) s2)->id;
+
+	if (id1 < id2)
+		return -1;
+	return (id1 > id2) ? 1 : 0;
+}
+
+static UgetRpcSnapshot* uget_rpc_snapshot_new (UgetApp* app)
+{
+	UgetRpcSnapshot* snapshot;
+	UgetRpcStatus*   status;
+	UgetProgress*    progress;
+	UgetRelation*    relation;
+	UgetCommon*      common;
+	UgetNode*        cnode;
+	UgetNode*        dnode;
+	int              length;
+	int              nth;
+
+	for (length = 0, cnode = app->real.children;  cnode;  cnode = cnode->next)
+		length += cnode->n_children;
+
+	snapshot = ug_malloc0 (sizeof (UgetRpcSnapshot));
+	snapshot->ref_count = 1;
+	snapshot->built = ug_get_time_count ();
+	snapshot->time = (int64_t) time (NULL);
+	snapshot->download_speed = app->task.speed.download;
+	snapshot->upload_speed = app->task.speed.upload;
+	snapshot->at = ug_malloc0 (sizeof (UgetRpcStatus) * (length + 1));
+	snapshot->sorted = ug_malloc (sizeof (UgetRpcStatus*) * (length + 1));
+	snapshot->n_categories = app->real.n_children;
+	snapshot->categories = ug_malloc (sizeof (int) * (app->real.n_children + 1));
+
+	status = snapshot->at;
+	cnode = app->real.children;
+	for (nth = 0;  cnode;  cnode = cnode->next, nth++) {
+		snapshot->categories[nth] = status - snapshot->at;
+		for (dnode = cnode->children;  dnode;  dnode = dnode->next, status++) {
+			status->id = (uintptr_t) dnode;
+			status->category = nth;
+			common = ug_info_get (dnode->info, UgetCommonInfo);
+			if (common) {
+				if (common->name)
+					status->name = ug_strdup (common->name);
+				if (common->uri)
+					status->uri = ug_strdup (common->uri);
+			}
+			relation = ug_info_get (dnode->info, UgetRelationInfo);
+			if (relation)
+				status->group = relation->group;
+			progress = ug_info_get (dnode->info, UgetProgressInfo);
+			if (progress) {
+				status->generation = progress->generation;
+				status->total = progress->total;
+				status->complete = progress->complete;
+				status->uploaded = progress->uploaded;
+				status->elapsed = progress->elapsed;
+				status->left = progress->left;
+				status->download_speed = progress->download_speed;
+				status->upload_speed = progress->upload_speed;
+				status->percent = progress->percent;
+			}
+			snapshot->sorted[status - snapshot->at] = status;
+		}
+	}
+	snapshot->categories[nth] = status - snapshot->at;
+	snapshot->length = status - snapshot->at;
+
+	qsort (snapshot->sorted, snapshot->length, sizeof (UgetRpcStatus*),
+	       compare_status_id);
+	return snapshot;
+}
+
+static void uget_rpc_snapshot_free (UgetRpcSnapshot* snapshot)
+{
+	int  index;
+
+	for (index = 0;  index < snapshot->length;  index++) {
+		ug_free (snapshot->at[index].name);
+		ug_free (snapshot->at[index].uri);
+	}
+	ug_free (snapshot->at);
+	ug_free (snapshot->sorted);
+	ug_free (snapshot->categories);
+	ug_free (snapshot);
+}
+
+// server thread get snapshot and release it by uget_rpc_snapshot_unref()
+static UgetRpcSnapshot* uget_rpc_snapshot_ref (UgetRpc* urpc)
+{
+	UgetRpcSnapshot* snapshot;
+	uint64_t         now;
+	int              wait;
+
+	now = ug_get_time_count ();
+	ug_mutex_lock (&urpc->snapshot_lock);
+	urpc->snapshot_read = now;
+	snapshot = urpc->snapshot;
+	// main thread doesn't rebuild snapshot while nobody read it.
+	// If it is too old, wait for main thread to build new one.
+	if (snapshot && now - snapshot->built > UGET_RPC_SNAPSHOT_AGE) {
+		for (wait = UGET_RPC_SNAPSHOT_WAIT;  wait > 0;  ) {
+			if (ug_cond_wait_timeout (&urpc->snapshot_cond,
+			                          &urpc->snapshot_lock, wait) == FALSE)
+				break;
+			if (urpc->snapshot != snapshot)
+				break;
+			wait = UGET_RPC_SNAPSHOT_WAIT - (int) (ug_get_time_count () - now);
+		}
+		snapshot = urpc->snapshot;
+	}
+	if (snapshot)
+		snapshot->ref_count++;
+	ug_mutex_unlock (&urpc->snapshot_lock);
+	return snapshot;
+}
+
+static void uget_rpc_snapshot_unref (UgetRpc* urpc, UgetRpcSnapshot* snapshot)
+{
+	int  ref_count;
+
+	if (snapshot == NULL)
+		return;
+	ug_mutex_lock (&urpc->snapshot_lock);
+	ref_count = --snapshot->ref_count;
+	ug_mutex_unlock (&urpc->snapshot_lock);
+	if (ref_count == 0)
+		uget_rpc_snapshot_free (snapshot);
+}
+
+static UgetRpcStatus* uget_rpc_snapshot_find (UgetRpcSnapshot* snapshot,
+                                              uintptr_t id)
+{
+	UgetRpcStatus   key;
+	UgetRpcStatus*  pkey = &key;
+	UgetRpcStatus** result;
+
+	key.id = id;
+	result = bsearch (&pkey, snapshot->sorted, snapshot->length,
+	                  sizeof (UgetRpcStatus*), compare_status_id);
+	return (result) ? *result : NULL;
+}
+
+void  uget_rpc_update (UgetRpc* urpc, UgetApp* app)
+{
+	UgetRpcSnapshot* snapshot;
+	UgetRpcSnapshot* old;
+	uint64_t         now;
+	uint64_t         read;
+
+	if (urpc->server == NULL)
+		return;
+
+	// only main thread replace urpc->snapshot, it can read it without lock.
+	snapshot = urpc->snapshot;
+	now = ug_get_time_count ();
+	ug_mutex_lock (&urpc->snapshot_lock);
+	read = urpc->snapshot_read;
+	ug_mutex_unlock (&urpc->snapshot_lock);
+	// Nobody query or subscribe, don't build snapshot. The first query after
+	// idle set 'snapshot_read' and wait for new one in uget_rpc_snapshot_ref().
+	if (snapshot && (read == 0 || now - read > UGET_RPC_SNAPSHOT_KEEP))
+		return;
+
+	old = snapshot;
+	snapshot = uget_rpc_snapshot_new (app);
+	snapshot->serial = (old) ? old->serial + 1 : 1;
+	ug_mutex_lock (&urpc->snapshot_lock);
+	urpc->snapshot = snapshot;
+	ug_cond_broadcast (&urpc->snapshot_cond);
+	ug_mutex_unlock (&urpc->snapshot_lock);
+	// server thread may be still reading old snapshot.
+	uget_rpc_snapshot_unref (urpc, old);
+}
+
+// ------------------------------------
+// query methods
+
+#define N_STATES    7
+
+static const char* state_names[N_STATES] = {
+	"recycled", "finished", "error", "paused", "completed", "active", "queuing",
+};
+
+// return index of state_names[]
+static int  status_state (int group)
+{
+	if (group & UGET_GROUP_RECYCLED)
+		return 0;
+	if (group & UGET_GROUP_FINISHED)
+		return 1;
+	if (group & UGET_GROUP_ERROR)
+		return 2;
+	if (group & UGET_GROUP_PAUSED)
+		return 3;
+	if (group & UGET_GROUP_COMPLETED)
+		return 4;
+	if (group & UGET_GROUP_ACTIVE)
+		return 5;
+	return 6;
+}
+
+static UgValue* add_member (UgValue* object, const char* name, UgValueType type)
+{
+	UgValue*  member;
+
+	member = ug_value_alloc (object, 1);
+	if (type == UG_VALUE_ARRAY)
+		ug_value_init_array (member, 8);
+	else
+		member->type = type;
+	member->name = (name) ? ug_strdup (name) : NULL;
+	return member;
+}
+
+static void set_status_value (UgValue* value, UgetRpcStatus* status)
+{
+	ug_value_init_object (value, 14);
+	add_member (value, "id", UG_VALUE_UINT64)->c.uinteger64 = status->id;
+	add_member (value, "category", UG_VALUE_INT)->c.integer = status->category;
+	add_member (value, "state", UG_VALUE_STRING)->c.string =
+			ug_strdup (state_names[status_state (status->group)]);
+	add_member (value, "group", UG_VALUE_INT)->c.integer = status->group;
+	// NULL string will be output as JSON null
+	add_member (value, "name", UG_VALUE_STRING)->c.string =
+			(status->name) ? ug_strdup (status->name) : NULL;
+	add_member (value, "uri", UG_VALUE_STRING)->c.string =
+			(status->uri) ? ug_strdup (status->uri) : NULL;
+	add_member (value, "total", UG_VALUE_INT64)->c.integer64 = status->total;
+	add_member (value, "complete", UG_VALUE_INT64)->c.integer64 = status->complete;
+	add_member (value, "uploaded", UG_VALUE_INT64)->c.integer64 = status->uploaded;
+	add_member (value, "elapsed", UG_VALUE_INT64)->c.integer64 = status->elapsed;
+	add_member (value, "left", UG_VALUE_INT64)->c.integer64 = status->left;
+	add_member (value, "downloadSpeed", UG_VALUE_INT)->c.integer = status->download_speed;
+	add_member (value, "uploadSpeed", UG_VALUE_INT)->c.integer = status->upload_speed;
+	add_member (value, "percent", UG_VALUE_INT)->c.integer = status->percent;
+}
+
+static void set_snapshot_value (UgValue* value, UgetRpcSnapshot* snapshot)
+{
+	add_member (value, "serial", UG_VALUE_UINT)->c.uinteger = snapshot->serial;
+	add_member (value, "time", UG_VALUE_INT64)->c.integer64 = snapshot->time;
+}
+
+// return integer member of params or 'value' if it doesn't exist.
+// members of params must be sorted by name.
+static int  get_param_int (UgJsonrpcObject* jobj, const char* name, int value)
+{
+	UgValue*  member;
+
+	if (jobj->params.type != UG_VALUE_OBJECT)
+		return value;
+	member = ug_value_find_name (&jobj->params, name);
+	if (member == NULL || member->type == UG_VALUE_STRING ||
+	    member->type == UG_VALUE_OBJECT || member->type == UG_VALUE_ARRAY)
+		return value;
+	return ug_value_get_int (member);
+}
+
+static void list_downloads (UgJsonrpcObject* jobj, UgetRpcSnapshot* snapshot)
+{
+	UgValue*  value;
+	int       category;
+	int       offset;
+	int       limit;
+	int       beg;
+	int       end;
+
+	category = get_param_int (jobj, "category", -1);
+	offset = get_param_int (jobj, "offset", 0);
+	limit = get_param_int (jobj, "limit", 100);
+	if (offset < 0 || limit < 0 || category >= snapshot->n_categories) {
+		set_error (jobj, -32602, "Invalid params");
+		return;
+	}
+	if (limit > UGET_RPC_LIST_LIMIT)
+		limit = UGET_RPC_LIST_LIMIT;
+
+	if (category < 0) {
+		beg = 0;
+		end = snapshot->length;
+	}
+	else {
+		beg = snapshot->categories[category];
+		end = snapshot->categories[category + 1];
+	}
+
+	ug_jsonrpc_object_clear_request (jobj);
+	ug_value_init_object (&jobj->result, 5);
+	set_snapshot_value (&jobj->result, snapshot);
+	add_member (&jobj->result, "total", UG_VALUE_INT)->c.integer = end - beg;
+	add_member (&jobj->result, "offset", UG_VALUE_INT)->c.integer = offset;
+	value = add_member (&jobj->result, "downloads", UG_VALUE_ARRAY);
+
+	if (offset > end - beg)
+		offset = end - beg;
+	beg += offset;
+	if (end > beg + limit)
+		end = beg + limit;
+	for (;  beg < end;  beg++)
+		set_status_value (ug_value_alloc (value, 1), snapshot->at + beg);
+}
+
+static void get_progress (UgJsonrpcObject* jobj, UgetRpcSnapshot* snapshot)
+{
+	UgetRpcStatus*  status = NULL;
+	UgValue*        member = NULL;
+
+	if (jobj->params.type == UG_VALUE_OBJECT)
+		member = ug_value_find_name (&jobj->params, "id");
+	if (member && member->type != UG_VALUE_STRING &&
+	    member->type != UG_VALUE_OBJECT && member->type != UG_VALUE_ARRAY)
+	{
+		status = uget_rpc_snapshot_find (snapshot,
+				(uintptr_t) ug_value_get_uint64 (member));
+	}
+	if (status == NULL) {
+		set_error (jobj, -32602, "Invalid params");
+		return;
+	}
+
+	ug_jsonrpc_object_clear_request (jobj);
+	set_status_value (&jobj->result, status);
+}
+
+static void get_speed (UgJsonrpcObject* jobj, UgetRpcSnapshot* snapshot)
+{
+	UgetRpcStatus*  status;
+	UgetRpcStatus*  end;
+	int             counts[N_STATES] = {0};
+	int             index;
+
+	end = snapshot->at + snapshot->length;
+	for (status = snapshot->at;  status < end;  status++)
+		counts[status_state (status->group)]++;
+
+	ug_jsonrpc_object_clear_request (jobj);
+	ug_value_init_object (&jobj->result, 12);
+	set_snapshot_value (&jobj->result, snapshot);
+	add_member (&jobj->result, "download", UG_VALUE_INT)->c.integer = snapshot->download_speed;
+	add_member (&jobj->result, "upload", UG_VALUE_INT)->c.integer = snapshot->upload_speed;
+	add_member (&jobj->result, "total", UG_VALUE_INT)->c.integer = snapshot->length;
+	for (index = 0;  index < N_STATES;  index++)
+		add_member (&jobj->result, state_names[index], UG_VALUE_INT)->c.integer = counts[index];
+}
+
+// return -1 if 'method' is not query method.
+static int  do_query (UgetRpc* urpc, UgJsonrpcObject* jobj, const char* method)
+{
+	UgetRpcSnapshot* snapshot;
+	void (*query) (UgJsonrpcObject* jobj, UgetRpcSnapshot* snapshot);
+
+	if (strcmp (method, "uget.listDownloads") == 0)
+		query = list_downloads;
+	else if (strcmp (method, "uget.getProgress") == 0)
+		query = get_progress;
+	else if (strcmp (method, "uget.getSpeed") == 0)
+		query = get_speed;
+	else
+		return -1;
+
+	// get_param_int() use binary search to find member
+	if (jobj->params.type == UG_VALUE_OBJECT)
+		ug_value_sort_name (&jobj->params);
+
+	snapshot = uget_rpc_snapshot_ref (urpc);
+	if (snapshot == NULL) {
+		// main thread hasn't called uget_rpc_update()
+		set_error (jobj, -32000, "Status is not ready");
+		return FALSE;
+	}
+	query (jobj, snapshot);
+	uget_rpc_snapshot_unref (urpc, snapshot);
+	return (jobj->error.code == 0) ? TRUE : FALSE;
+}
+
+// ------------------------------------
+// subscription (server thread)
+
+static int  remove_subscriber (UgArrayPtr* array, UgJsonrpc* jrpc)
+{
+	int  index;
+
+	for (index = 0;  index < array->length;  index++) {
+		if (array->at[index] == jrpc) {
+			ug_array_erase (array, index, 1);
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static void on_subscriber_closed (UgJsonrpc* jrpc, UgetRpc* urpc)
+{
+	if (remove_subscriber (&urpc->subscribers, jrpc) == FALSE)
+		remove_subscriber (&urpc->joining, jrpc);
+}
+
+static int  status_changed (UgetRpcStatus* status, UgetRpcStatus* old)
+{
+	if (old == NULL)
+		return TRUE;
+	if (status->generation != old->generation || status->group != old->group ||
+	    status->category != old->category)
+		return TRUE;
+	if (status->name != old->name && (status->name == NULL ||
+	    old->name == NULL || strcmp (status->name, old->name) != 0))
+		return TRUE;
+	if (status->uri != old->uri && (status->uri == NULL ||
+	    old->uri == NULL || strcmp (status->uri, old->uri) != 0))
+		return TRUE;
+	return FALSE;
+}
+
+// notification "uget.onProgress". If 'old' is NULL, it has all downloads.
+// return number of changed and removed downloads.
+static int  make_notification (UgJsonrpcObject* jobj, UgetRpcSnapshot* snapshot,
+                               UgetRpcSnapshot* old)
+{
+	UgetRpcStatus*  status;
+	UgValue*        array;
+	int             index;
+	int             count = 0;
+
+	jobj->method_static = "uget.onProgress";
+	ug_value_init_object (&jobj->params, 7);
+	set_snapshot_value (&jobj->params, snapshot);
+	add_member (&jobj->params, "full", UG_VALUE_BOOL)->c.boolean = (old == NULL);
+	add_member (&jobj->params, "download", UG_VALUE_INT)->c.integer = snapshot->download_speed;
+	add_member (&jobj->params, "upload", UG_VALUE_INT)->c.integer = snapshot->upload_speed;
+	// adding member may move other members, fill array before adding next.
+	array = add_member (&jobj->params, "changed", UG_VALUE_ARRAY);
+	for (index = 0;  index < snapshot->length;  index++) {
+		status = snapshot->at + index;
+		if (old == NULL || status_changed (status, uget_rpc_snapshot_find (old, status->id))) {
+			set_status_value (ug_value_alloc (array, 1), status);
+			count++;
+		}
+	}
+	array = add_member (&jobj->params, "removed", UG_VALUE_ARRAY);
+	for (index = 0;  old && index < old->length;  index++) {
+		status = old->at + index;
+		if (uget_rpc_snapshot_find (snapshot, status->id) == NULL) {
+			add_member (array, NULL, UG_VALUE_UINT64)->c.uinteger64 = status->id;
+			count++;
+		}
+	}
+	return count;
+}
+
+// move subscribers from array 'from' to 'to' if 'moved' == result of sending.
+static void push_notification (UgArrayPtr* from, UgArrayPtr* to, int moved,
+                               UgJsonrpcObject* jobj)
+{
+	UgJsonrpc*  jrpc;
+	int         index;
+
+	for (index = 0;  index < from->length;  ) {
+		jrpc = from->at[index];
+		if (ug_jsonrpc_socket_notify (jrpc, jobj) == moved) {
+			ug_array_erase (from, index, 1);
+			*(void**) ug_array_alloc (to, 1) = jrpc;
+			continue;
+		}
+		index++;
+	}
+}
+
+static void on_push_timer (UgSocketWatch* watch, int events)
+{
+	UgetRpc*          urpc = watch->data;
+	UgetRpcSnapshot*  snapshot;
+	UgJsonrpcObject   jobj;
+
+	if (events & UG_SOCKET_STOPPED)
+		return;
+
+	snapshot = uget_rpc_snapshot_ref (urpc);
+	if (snapshot && snapshot != urpc->pushed) {
+		if (urpc->subscribers.length > 0 && urpc->pushed) {
+			ug_jsonrpc_object_init (&jobj);
+			// don't send empty delta.
+			// if it failed, subscriber will get all downloads again.
+			if (make_notification (&jobj, snapshot, urpc->pushed) > 0) {
+				push_notification (&urpc->subscribers, &urpc->joining,
+				                   FALSE, &jobj);
 			}
+			ug_jsonrpc_object_clear (&jobj);
+		}
+		uget_rpc_snapshot_unref (urpc, urpc->pushed);
+		urpc->pushed = snapshot;
+	}
+	else
+		uget_rpc_snapshot_unref (urpc, snapshot);
+
+	if (urpc->joining.length > 0 && urpc->pushed) {
+		ug_jsonrpc_object_init (&jobj);
+		make_notification (&jobj, urpc->pushed, NULL);
+		push_notification (&urpc->joining, &urpc->subscribers,
+		                   TRUE, &jobj);
+		ug_jsonrpc_object_clear (&jobj);
+	}
+
+	if (urpc->subscribers.length > 0 || urpc->joining.length > 0)
+		ug_socket_server_watch (urpc->server, watch);
+}
+
+// return -1 if 'jobj' is not subscription method.
+static int  do_subscription (UgetRpc* urpc, UgJsonrpc* jrpc, UgJsonrpcObject* jobj)
+{
+	const char* method;
+
+	if (jobj->method_static)
+		method = jobj->method_static;
+	else
+		method = jobj->method;
+	if (method == NULL)
+		return -1;
+
+	if (strcmp (method, "uget.subscribe") == 0) {
+		if (remove_subscriber (&urpc->subscribers, jrpc) == FALSE)
+			remove_subscriber (&urpc->joining, jrpc);
+		*(void**) ug_array_alloc (&urpc->joining, 1) = jrpc;
+		ug_jsonrpc_socket_hold (jrpc, (UgJsonrpcClosedFunc) on_subscriber_closed, urpc);
+		if (urpc->push_timer.server == NULL)
+			ug_socket_server_watch (urpc->server, &urpc->push_timer);
+	}
+	else if (strcmp (method, "uget.unsubscribe") == 0) {
+		if (remove_subscriber (&urpc->subscribers, jrpc) ||
+		    remove_subscriber (&urpc->joining, jrpc))
+		{
+			ug_jsonrpc_socket_release (jrpc);
 		}
-		ug_jsonrpc_response_batch (jrpc, &urpc->jarray);
-		ug_jsonrpc_array_clear (&urpc->jarray, TRUE);
 	}
+	else
+		return -1;
+
+	// response OK
+	// {"jsonrpc": "2.0", "result": true, "id": 1}
+	ug_jsonrpc_object_clear_request (jobj);
+	jobj->result.type = UG_VALUE_BOOL;
+	jobj->result.c.boolean = TRUE;
+	return TRUE;
+}
+
+// ----------------------------------------------------------------------------
+// error
+
+static void set_error (UgJsonrpcObject* jobj, int code, const char* message)
+{
+	ug_jsonrpc_object_clear_request (jobj);
+	ug_free (jobj->error.message);
+	jobj->error.code = code;
+	jobj->error.message = ug_strdup (message);
 }
 
 static void set_invalid_request (UgJsonrpcObject* jobj)
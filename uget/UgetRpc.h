@@ -39,8 +39,10 @@
 
 #include <UgList.h>
 #include <UgThread.h>
+#include <UgSocket.h>
 #include <UgJsonrpcSocket.h>
 #include <UgetOption.h>
+#include <UgetApp.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,6 +57,8 @@ enum {
 typedef struct UgetRpc           UgetRpc;
 typedef struct UgetRpcReq        UgetRpcReq;
 typedef struct UgetRpcCmd        UgetRpcCmd;
+typedef struct UgetRpcStatus     UgetRpcStatus;
+typedef struct UgetRpcSnapshot   UgetRpcSnapshot;
 
 struct UgetRpc {
 	UG_JSONRPC_SOCKET_MEMBERS;
@@ -74,6 +78,18 @@ struct UgetRpc {
 	UgMutex          queue_lock;
 	char*            backup_dir;
 
+	// status of downloads for query methods. see uget_rpc_update()
+	UgMutex          snapshot_lock;
+	UgCond           snapshot_cond;   // signaled after snapshot was replaced
+	UgetRpcSnapshot* snapshot;
+	uint64_t         snapshot_read;   // ug_get_time_count() of last reading
+
+	// subscription, used by server thread only.
+	UgetRpcSnapshot* pushed;          // the last snapshot sent to subscribers
+	UgArrayPtr       subscribers;     // UgJsonrpc* that received 'pushed'
+	UgArrayPtr       joining;         // UgJsonrpc* that need full status
+	UgSocketWatch    push_timer;
+
 #ifdef USE_UNIX_DOMAIN_SOCKET
 	char*            socket_path;
 	int              socket_path_len;
@@ -98,6 +114,12 @@ void  uget_rpc_stop_server  (UgetRpc* urpc);
 int          uget_rpc_has_request (UgetRpc* urpc);
 UgetRpcReq*  uget_rpc_get_request (UgetRpc* urpc);
 
+// Query methods don't access UgetApp in server thread. They read a snapshot
+// that is created by uget_rpc_update(). Call it periodically in main thread.
+// It rebuild snapshot only if it was read recently or subscribers exist.
+// After idle, server thread wait for main thread to rebuild it.
+void  uget_rpc_update (UgetRpc* urpc, UgetApp* app);
+
 // ----------------------------------------------------------------------------
 // UgetRpcReq - Request
 
@@ -140,6 +162,66 @@ struct UgetRpcCmd
 UgetRpcCmd*  uget_rpc_cmd_new (void);
 void         uget_rpc_cmd_free (UgetRpcCmd* urcmd);
 
+// ----------------------------------------------------------------------------
+// UgetRpcSnapshot: status of all downloads for query and subscription methods.
+//
+// JSON-RPC methods:
+// "uget.listDownloads"  params: {"offset": 0, "limit": 100, "category": -1}
+//                       result: {"serial": 1, "time": 0, "total": 2,
+//                                "downloads": [UgetRpcStatus, ...]}
+// "uget.getProgress"    params: {"id": 1234}    result: UgetRpcStatus
+// "uget.getSpeed"       result: {"download": 0, "upload": 0, "active": 0, ...}
+// "uget.subscribe"      result: true
+//     Server send notification "uget.onProgress" when downloads changed:
+//     {"serial": 2, "time": 0, "full": false, "download": 0, "upload": 0,
+//      "changed": [UgetRpcStatus, ...], "removed": [id, ...]}
+//     "full" is true in the first notification, "changed" has all downloads.
+// "uget.unsubscribe"    result: true
+
+#define UGET_RPC_SNAPSHOT_KEEP     60000    // rebuild while read in 60 seconds
+#define UGET_RPC_SNAPSHOT_AGE      2000     // older snapshot must be rebuilt
+#define UGET_RPC_SNAPSHOT_WAIT     2000     // max time to wait for rebuilding
+#define UGET_RPC_PUSH_INTERVAL     1000     // check new snapshot every second
+#define UGET_RPC_LIST_LIMIT        1000     // max "limit" of uget.listDownloads
+
+struct UgetRpcStatus
+{
+	uintptr_t    id;          // address of real download node
+	int          category;    // position of category
+	int          group;       // UgetGroup
+	unsigned int generation;  // UgetProgress.generation
+	char*        name;
+	char*        uri;
+
+	int64_t      total;
+	int64_t      complete;
+	int64_t      uploaded;
+	int64_t      elapsed;
+	int64_t      left;
+	int          download_speed;
+	int          upload_speed;
+	int          percent;
+};
+
+struct UgetRpcSnapshot
+{
+	int             ref_count;
+	unsigned int    serial;
+	uint64_t        built;    // ug_get_time_count()
+	int64_t         time;     // time(NULL)
+
+	int             download_speed;
+	int             upload_speed;
+
+	UgetRpcStatus*  at;       // in order of categories
+	int             length;
+	UgetRpcStatus** sorted;   // elements of 'at' sorted by id
+	// downloads of Nth category are from at[categories[N]] to
+	// at[categories[N+1] - 1]
+	int*            categories;
+	int             n_categories;
+};
+
 
 #ifdef __cplusplus
 }
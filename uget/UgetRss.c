@@ -460,6 +460,8 @@ int   uget_rss_save_feeds (UgetRss* urss, const char* path)
 	UgJsonFile*  jfile;
 
 	jfile = ug_json_file_new (4096);
+	// feeds can be downloaded again if file lost.
+	ug_json_file_set_sync (jfile, UG_JSON_FILE_SYNC_NONE);
 	if (ug_json_file_begin_write (jfile, path, UG_JSON_FORMAT_ALL)) {
 //		ug_json_write_array_head (&jfile->json);
 		ug_json_write_entry (&jfile->json, urss, UgetRssEntry);
@@ -0,0 +1,508 @@
+/*
+ *
+ *   Copyright (C) 2012-2020 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <UgDefine.h>
+#include <UgString.h>
+#include <UgetData.h>
+#include <UgetSearch.h>
+
+// compact index if number of removed entries is larger than this
+#define UGET_SEARCH_MIN_REMOVED    1024
+
+#define UGET_SEARCH_GRAM(text)     \
+		(0x1000000 | ((uint8_t)(text)[0] << 16) | ((uint8_t)(text)[1] << 8) | (uint8_t)(text)[2])
+
+typedef struct UgetSearchEntry  UgetSearchEntry;
+typedef struct UgetSearchSlot   UgetSearchSlot;
+typedef struct UgetSearchGram   UgetSearchGram;
+
+struct UgetSearchEntry
+{
+	UgetNode*  node;      // NULL if entry was removed
+	char*      text;      // lowercase "name\nuri\nfolder"
+};
+
+// hash table: UgetNode -> entry id
+struct UgetSearchSlot
+{
+	UgetNode*  node;      // NULL if slot is empty
+	int        id;        // -1 if slot was removed
+};
+
+// hash table: trigram -> entry ids
+struct UgetSearchGram
+{
+	uint32_t   gram;      // 0 if slot is empty
+	int        length;
+	int        allocated;
+	int*       ids;
+};
+
+struct UgetSearch
+{
+	UgetSearchEntry* entries;
+	int              n_entries;
+	int              n_removed;
+	int              allocated;
+
+	UgetSearchSlot*  slots;
+	int              n_slots;     // power of 2
+	int              n_occupied;  // used and removed slots
+
+	UgetSearchGram*  grams;
+	int              n_grams;     // power of 2
+	int              n_used_grams;
+
+	char*            pattern;     // lowercase, for uget_search_match()
+};
+
+static void  uget_search_compact (UgetSearch* search);
+
+static char* uget_search_lower (const char* pattern, int* length)
+{
+	char*  lower;
+	int    index;
+
+	lower = ug_strdup (pattern);
+	for (index = 0;  lower[index];  index++) {
+		if (lower[index] >= 'A' && lower[index] <= 'Z')
+			lower[index] += 'a' - 'A';
+	}
+	if (length)
+		*length = index;
+	return lower;
+}
+
+static unsigned int  uget_search_hash_node (UgetNode* node)
+{
+	return (unsigned int) (((uintptr_t) node >> 4) * 2654435761u);
+}
+
+static unsigned int  uget_search_hash_gram (uint32_t gram)
+{
+	return gram * 2654435761u;
+}
+
+// return lowercase "name\nuri\nfolder" of download
+static char* uget_search_make_text (UgetNode* node)
+{
+	UgetCommon*  common;
+	const char*  strings[3] = {NULL, NULL, NULL};
+	char*        text;
+	char*        cur;
+	int          length;
+	int          index;
+
+	common = ug_info_get (node->info, UgetCommonInfo);
+	if (common) {
+		strings[0] = common->name;
+		strings[1] = common->uri;
+		strings[2] = common->folder;
+	}
+	for (length = 0, index = 0;  index < 3;  index++) {
+		if (strings[index])
+			length += strlen (strings[index]);
+	}
+
+	cur = text = ug_malloc (length + 3);
+	for (index = 0;  index < 3;  index++) {
+		if (index > 0)
+			*cur++ = '\n';
+		if (strings[index] == NULL)
+			continue;
+		for (length = 0;  strings[index][length];  length++) {
+			*cur = strings[index][length];
+			if (*cur >= 'A' && *cur <= 'Z')
+				*cur += 'a' - 'A';
+			cur++;
+		}
+	}
+	*cur = 0;
+	return text;
+}
+
+// ----------------------------------------------------------------------------
+// hash table: UgetNode -> entry id
+
+static UgetSearchSlot* uget_search_find_slot (UgetSearch* search, UgetNode* node)
+{
+	UgetSearchSlot*  slot;
+	unsigned int     mask;
+	unsigned int     index;
+
+	if (search->n_slots == 0)
+		return NULL;
+	mask = search->n_slots - 1;
+	for (index = uget_search_hash_node (node) & mask;  ;  index = (index + 1) & mask) {
+		slot = search->slots + index;
+		if (slot->node == node && slot->id >= 0)
+			return slot;
+		if (slot->node == NULL)
+			return NULL;
+	}
+}
+
+static void  uget_search_insert_slot (UgetSearch* search, UgetNode* node, int id)
+{
+	UgetSearchSlot*  slots;
+	UgetSearchSlot*  slot;
+	unsigned int     mask;
+	unsigned int     index;
+	int              n_slots;
+
+	// keep load factor under 1/2
+	if ((search->n_occupied + 1) * 2 > search->n_slots) {
+		slots = search->slots;
+		n_slots = search->n_slots;
+		search->n_slots = (n_slots) ? n_slots * 2 : 64;
+		while (search->n_slots < (search->n_entries - search->n_removed) * 4)
+			search->n_slots *= 2;
+		search->slots = ug_malloc0 (sizeof (UgetSearchSlot) * search->n_slots);
+		search->n_occupied = 0;
+		for (index = 0;  index < n_slots;  index++) {
+			if (slots[index].node && slots[index].id >= 0)
+				uget_search_insert_slot (search, slots[index].node, slots[index].id);
+		}
+		ug_free (slots);
+	}
+
+	mask = search->n_slots - 1;
+	for (index = uget_search_hash_node (node) & mask;  ;  index = (index + 1) & mask) {
+		slot = search->slots + index;
+		if (slot->node == NULL)
+			break;
+	}
+	slot->node = node;
+	slot->id = id;
+	search->n_occupied++;
+}
+
+// ----------------------------------------------------------------------------
+// hash table: trigram -> entry ids
+
+static UgetSearchGram* uget_search_find_gram (UgetSearch* search, uint32_t gram)
+{
+	UgetSearchGram*  slot;
+	unsigned int     mask;
+	unsigned int     index;
+
+	if (search->n_grams == 0)
+		return NULL;
+	mask = search->n_grams - 1;
+	for (index = uget_search_hash_gram (gram) & mask;  ;  index = (index + 1) & mask) {
+		slot = search->grams + index;
+		if (slot->gram == gram)
+			return slot;
+		if (slot->gram == 0)
+			return NULL;
+	}
+}
+
+static UgetSearchGram* uget_search_add_gram (UgetSearch* search, uint32_t gram)
+{
+	UgetSearchGram*  grams;
+	UgetSearchGram*  slot;
+	unsigned int     mask;
+	unsigned int     index;
+	int              n_grams;
+
+	slot = uget_search_find_gram (search, gram);
+	if (slot)
+		return slot;
+
+	// keep load factor under 1/2
+	if ((search->n_used_grams + 1) * 2 > search->n_grams) {
+		grams = search->grams;
+		n_grams = search->n_grams;
+		search->n_grams = (n_grams) ? n_grams * 2 : 1024;
+		search->grams = ug_malloc0 (sizeof (UgetSearchGram) * search->n_grams);
+		mask = search->n_grams - 1;
+		for (index = 0;  index < n_grams;  index++) {
+			if (grams[index].gram == 0)
+				continue;
+			slot = search->grams + (uget_search_hash_gram (grams[index].gram) & mask);
+			while (slot->gram)
+				slot = search->grams + ((slot - search->grams + 1) & mask);
+			*slot = grams[index];
+		}
+		ug_free (grams);
+	}
+
+	mask = search->n_grams - 1;
+	for (index = uget_search_hash_gram (gram) & mask;  ;  index = (index + 1) & mask) {
+		slot = search->grams + index;
+		if (slot->gram == 0)
+			break;
+	}
+	slot->gram = gram;
+	search->n_used_grams++;
+	return slot;
+}
+
+static void  uget_search_index_entry (UgetSearch* search, int id)
+{
+	UgetSearchGram*  slot;
+	const char*      text;
+
+	for (text = search->entries[id].text;  text[0] && text[1] && text[2];  text++) {
+		if (text[0] == '\n' || text[1] == '\n' || text[2] == '\n')
+			continue;
+		slot = uget_search_add_gram (search, UGET_SEARCH_GRAM (text));
+		// the same trigram may appear more than once in text
+		if (slot->length > 0 && slot->ids[slot->length - 1] == id)
+			continue;
+		if (slot->length == slot->allocated) {
+			slot->allocated = (slot->allocated) ? slot->allocated * 2 : 4;
+			slot->ids = ug_realloc (slot->ids, sizeof (int) * slot->allocated);
+		}
+		slot->ids[slot->length++] = id;
+	}
+}
+
+// ----------------------------------------------------------------------------
+// UgetSearch
+
+UgetSearch* uget_search_new (void)
+{
+	return ug_malloc0 (sizeof (UgetSearch));
+}
+
+static void  uget_search_clear (UgetSearch* search)
+{
+	int  index;
+
+	for (index = 0;  index < search->n_entries;  index++)
+		ug_free (search->entries[index].text);
+	for (index = 0;  index < search->n_grams;  index++)
+		ug_free (search->grams[index].ids);
+	ug_free (search->entries);
+	ug_free (search->slots);
+	ug_free (search->grams);
+	memset (search, 0, sizeof (UgetSearch));
+}
+
+void  uget_search_free (UgetSearch* search)
+{
+	if (search) {
+		ug_free (search->pattern);
+		search->pattern = NULL;
+		uget_search_clear (search);
+		ug_free (search);
+	}
+}
+
+static void  uget_search_add_text (UgetSearch* search, UgetNode* node, char* text)
+{
+	int  id;
+
+	if (search->n_entries == search->allocated) {
+		search->allocated = (search->allocated) ? search->allocated * 2 : 256;
+		search->entries = ug_realloc (search->entries,
+				sizeof (UgetSearchEntry) * search->allocated);
+	}
+	id = search->n_entries++;
+	search->entries[id].node = node;
+	search->entries[id].text = text;
+	uget_search_insert_slot (search, node, id);
+	uget_search_index_entry (search, id);
+}
+
+void  uget_search_add (UgetSearch* search, UgetNode* dnode)
+{
+	dnode = dnode->base;
+	if (search == NULL || uget_search_find_slot (search, dnode))
+		return;
+	uget_search_add_text (search, dnode, uget_search_make_text (dnode));
+}
+
+void  uget_search_remove (UgetSearch* search, UgetNode* dnode)
+{
+	UgetSearchSlot*  slot;
+
+	if (search == NULL)
+		return;
+	slot = uget_search_find_slot (search, dnode->base);
+	if (slot == NULL)
+		return;
+	// trigram lists still have this id, uget_search_find() skip it.
+	search->entries[slot->id].node = NULL;
+	ug_free (search->entries[slot->id].text);
+	search->entries[slot->id].text = NULL;
+	search->n_removed++;
+	slot->id = -1;
+
+	if (search->n_removed > UGET_SEARCH_MIN_REMOVED &&
+	    search->n_removed > search->n_entries / 2)
+	{
+		uget_search_compact (search);
+	}
+}
+
+int   uget_search_update (UgetSearch* search, UgetNode* dnode)
+{
+	UgetSearchSlot*  slot;
+	char*            text;
+
+	if (search == NULL)
+		return FALSE;
+	dnode = dnode->base;
+	slot = uget_search_find_slot (search, dnode);
+	if (slot == NULL)
+		return FALSE;
+
+	text = uget_search_make_text (dnode);
+	if (strcmp (text, search->entries[slot->id].text) == 0) {
+		ug_free (text);
+		return FALSE;
+	}
+	uget_search_remove (search, dnode);
+	uget_search_add_text (search, dnode, text);
+	return TRUE;
+}
+
+void  uget_search_add_category (UgetSearch* search, UgetNode* cnode)
+{
+	UgetNode*  dnode;
+
+	for (dnode = cnode->children;  dnode;  dnode = dnode->next)
+		uget_search_add (search, dnode);
+}
+
+void  uget_search_remove_category (UgetSearch* search, UgetNode* cnode)
+{
+	UgetNode*  dnode;
+
+	for (dnode = cnode->children;  dnode;  dnode = dnode->next)
+		uget_search_remove (search, dnode);
+}
+
+// rebuild index without removed entries
+static void  uget_search_compact (UgetSearch* search)
+{
+	UgetSearch  temp;
+	int         index;
+
+	temp = *search;
+	memset (search, 0, sizeof (UgetSearch));
+	search->pattern = temp.pattern;
+	temp.pattern = NULL;
+	for (index = 0;  index < temp.n_entries;  index++) {
+		if (temp.entries[index].node == NULL)
+			continue;
+		uget_search_add_text (search, temp.entries[index].node,
+		                      temp.entries[index].text);
+		temp.entries[index].text = NULL;
+	}
+	uget_search_clear (&temp);
+}
+
+int   uget_search_find (UgetSearch* search, const char* pattern, UgArrayPtr* nodes)
+{
+	UgetSearchEntry* entry;
+	UgetSearchGram*  slot;
+	UgetSearchGram*  shortest;
+	char*            lower;
+	int              length;
+	int              counts;
+	int              index;
+
+	if (search == NULL || pattern == NULL || pattern[0] == 0)
+		return 0;
+	lower = uget_search_lower (pattern, &length);
+
+	counts = 0;
+	if (length < 3) {
+		// too short to use trigram, scan all entries.
+		for (index = 0;  index < search->n_entries;  index++) {
+			entry = search->entries + index;
+			if (entry->node && strstr (entry->text, lower)) {
+				*(void**) ug_array_alloc (nodes, 1) = entry->node;
+				counts++;
+			}
+		}
+		ug_free (lower);
+		return counts;
+	}
+
+	// find the shortest list of trigrams in pattern
+	shortest = NULL;
+	for (index = 0;  index + 2 < length;  index++) {
+		slot = uget_search_find_gram (search, UGET_SEARCH_GRAM (lower + index));
+		if (slot == NULL) {
+			shortest = NULL;
+			break;
+		}
+		if (shortest == NULL || shortest->length > slot->length)
+			shortest = slot;
+	}
+	// verify entries in list
+	if (shortest) {
+		for (index = 0;  index < shortest->length;  index++) {
+			entry = search->entries + shortest->ids[index];
+			if (entry->node && strstr (entry->text, lower)) {
+				*(void**) ug_array_alloc (nodes, 1) = entry->node;
+				counts++;
+			}
+		}
+	}
+	ug_free (lower);
+	return counts;
+}
+
+void  uget_search_set_pattern (UgetSearch* search, const char* pattern)
+{
+	if (search == NULL)
+		return;
+	ug_free (search->pattern);
+	if (pattern == NULL || pattern[0] == 0)
+		search->pattern = NULL;
+	else
+		search->pattern = uget_search_lower (pattern, NULL);
+}
+
+int   uget_search_match (UgetSearch* search, UgetNode* dnode)
+{
+	UgetSearchSlot*  slot;
+
+	if (search == NULL || search->pattern == NULL)
+		return FALSE;
+	slot = uget_search_find_slot (search, dnode->base);
+	if (slot == NULL)
+		return FALSE;
+	return strstr (search->entries[slot->id].text, search->pattern) != NULL;
+}
@@ -0,0 +1,82 @@
+/*
+ *
+ *   Copyright (C) 2012-2020 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#ifndef UGET_SEARCH_H
+#define UGET_SEARCH_H
+
+#include <UgArray.h>
+#include <UgetNode.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// UgetSearch: trigram index of download name, URI, and folder.
+//             It answer case-insensitive substring query.
+//
+// Each download has an entry that keep lowercase text "name\nuri\nfolder".
+// Every 3 bytes of text (trigram) has a list of entry id. Query find the
+// shortest list of trigrams in pattern and verify these entries by strstr().
+// Removed entries are marked and dropped when the index is compacted.
+
+typedef struct UgetSearch       UgetSearch;
+
+UgetSearch* uget_search_new (void);
+void  uget_search_free (UgetSearch* search);
+
+// these functions use dnode->base
+void  uget_search_add (UgetSearch* search, UgetNode* dnode);
+void  uget_search_remove (UgetSearch* search, UgetNode* dnode);
+// re-index download if it's name, URI, or folder changed. return TRUE if changed.
+int   uget_search_update (UgetSearch* search, UgetNode* dnode);
+
+void  uget_search_add_category (UgetSearch* search, UgetNode* cnode);
+void  uget_search_remove_category (UgetSearch* search, UgetNode* cnode);
+
+// add matched downloads (base node) to 'nodes' and return number of them.
+int   uget_search_find (UgetSearch* search, const char* pattern, UgArrayPtr* nodes);
+
+// keep pattern for uget_search_match(). set pattern to NULL to match nothing.
+void  uget_search_set_pattern (UgetSearch* search, const char* pattern);
+// return TRUE if indexed download match pattern of uget_search_set_pattern()
+int   uget_search_match (UgetSearch* search, UgetNode* dnode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // End of UGET_SEARCH_H
@@ -34,6 +34,8 @@
  *
  */
 
+#include <stddef.h>
+#include <string.h>
 #include <UgUri.h>
 #include <UgString.h>
 #include <UgetData.h>
@@ -42,6 +44,10 @@
 // static function
 static int  uget_task_dispatch1(UgetTask* task, UgetNode* node, UgetPlugin* plugin);
 
+// size of values in UgetProgress (from 'elapsed' to 'percent')
+#define UGET_PROGRESS_VALUES_SIZE    \
+		(offsetof(UgetProgress, percent) + sizeof(int) - offsetof(UgetProgress, elapsed))
+
 void  uget_task_init(UgetTask* task)
 {
 	int  count;
@@ -92,12 +98,15 @@ int   uget_task_add(UgetTask* task, UgetNode* node, const UgetPluginInfo* info)
 		}
 		temp.progress->download_speed = 0;
 		temp.progress->upload_speed = 0;
+		temp.progress->generation++;
 	}
 
 	// UgetCommon: clear retry_count
 	temp.common = ug_info_get(node->info, UgetCommonInfo);
-	if (temp.common)
+	if (temp.common && temp.common->retry_count) {
 		temp.common->retry_count = 0;
+		temp.common->generation++;
+	}
 
 	// create plug-in and control it
 	relation->task = ug_malloc0(sizeof(struct UgetRelationTask));
@@ -167,16 +176,37 @@ void  uget_task_remove_all(UgetTask* task)
 static int  uget_task_dispatch1(UgetTask* task, UgetNode* node, UgetPlugin* plugin)
 {
 	UgetRelation* relation;
+	UgetCommon*   common;
 	UgetEvent*  event;
 	UgetEvent*  next;
 	int         active;
+	int         retry_count;
+	UgetProgress  last;
 	union {
 		int           count;
 		UgetLog*      log;
 		UgetFiles*    files;
+		UgetProgress* progress;
 	} temp;
 
+	common = ug_info_get(node->info, UgetCommonInfo);
+	retry_count = (common) ? common->retry_count : 0;
+	temp.progress = ug_info_get(node->info, UgetProgressInfo);
+	if (temp.progress)
+		memcpy(&last.elapsed, &temp.progress->elapsed, UGET_PROGRESS_VALUES_SIZE);
 	active = uget_plugin_sync(plugin, node->info);
+	// increase generation of UgetCommon if retry_count changed.
+	// Plug-in post UGET_EVENT_NAME if it changed name.
+	common = ug_info_get(node->info, UgetCommonInfo);
+	if (common && common->retry_count != retry_count)
+		common->generation++;
+	// increase generation if progress has been created or changed
+	if (temp.progress == NULL)
+		temp.progress = ug_info_get(node->info, UgetProgressInfo);
+	else if (memcmp(&last.elapsed, &temp.progress->elapsed, UGET_PROGRESS_VALUES_SIZE) == 0)
+		temp.progress = NULL;
+	if (temp.progress)
+		temp.progress->generation++;
 	// update UgetFiles
 	temp.files = ug_info_get(node->info, UgetFilesInfo);
 	if (temp.files)
@@ -209,7 +239,7 @@ static int  uget_task_dispatch1(UgetTask* task, UgetNode* node, UgetPlugin* plug
 		case UGET_EVENT_WARNING:
 		case UGET_EVENT_NORMAL:
 			temp.log = ug_info_realloc(node->info, UgetLogInfo);
-			ug_list_prepend(&temp.log->messages, (UgLink*) event);
+			uget_log_add_message(temp.log, event);
 			break;
 
 		case UGET_EVENT_START:
@@ -238,6 +268,12 @@ static int  uget_task_dispatch1(UgetTask* task, UgetNode* node, UgetPlugin* plug
 			uget_event_free(event);
 			break;
 
+		case UGET_EVENT_NAME:
+			if (common)
+				common->generation++;
+			uget_event_free(event);
+			break;
+
 		default:
 			uget_event_free(event);
 			break;
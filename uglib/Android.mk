@@ -14,6 +14,8 @@ LOCAL_SRC_FILES  := \
 	UgFileUtil.c  \
 	UgArray.c  \
 	UgList.c  \
+	UgSlab.c  \
+	UgRankTree.c  \
 	UgSLink.c  \
 	UgOption.c  \
 	UgUri.c  \
@@ -30,6 +32,7 @@ LOCAL_SRC_FILES  := \
 	UgJsonrpc.c  \
 	UgJsonrpcSocket.c  \
 	UgJsonrpcCurl.c  \
+	UgJsonrpcWebsocket.c  \
 	UgHtml.c  \
 	UgHtmlEntry.c  \
 	UgHtmlFilter.c
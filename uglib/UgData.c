@@ -38,11 +38,8 @@
 #include <config.h>
 #endif
 
-#ifdef HAVE_GLIB
-#include <glib.h>    // g_slice_xxx
-#endif
-
 #include <stdlib.h>
+#include <UgSlab.h>
 #include <UgData.h>
 #include <UgJson-custom.h>
 
@@ -56,11 +53,7 @@ void* ug_type_new(const void* typeinfo)
 	UgInitFunc  init;
 	UgType*     type;
 
-#ifdef HAVE_GLIB
-	type = g_slice_alloc0(((UgTypeInfo*)typeinfo)->size);
-#else
-	type = ug_malloc0(((UgTypeInfo*)typeinfo)->size);
-#endif // HAVE_GLIB
+	type = ug_slab_alloc0(((UgTypeInfo*)typeinfo)->size);
 
 	type->info = typeinfo;
 	init = type->info->init;
@@ -77,11 +70,7 @@ void  ug_type_free(void* type)
 	if (final)
 		final(type);
 
-#ifdef HAVE_GLIB
-	g_slice_free1(((UgType*)type)->info->size, type);
-#else
-	ug_free(type);
-#endif // HAVE_GLIB
+	ug_slab_free(((UgType*)type)->info->size, type);
 }
 
 void  ug_type_init(void* type)
@@ -118,11 +107,7 @@ void* ug_data_copy(void* data)
 		init   = info->init;
 		assign = info->assign;
 		if (assign) {
-#ifdef HAVE_GLIB
-			newone = g_slice_alloc0(info->size);
-#else
-			newone = ug_malloc0(info->size);
-#endif
+			newone = ug_slab_alloc0(info->size);
 			((UgData*)newone)->info = info;
 			if (init)
 				init(newone);
@@ -115,6 +115,9 @@ struct UgDataInfo
 	UgAssignFunc    assign;
 	const UgEntry*	entry;
  */
+
+	// fixed position in UgInfo, set by ug_info_register_slot(). 0 = none
+	int             slot;
 };
 
 /* ----------------------------------------------------------------------------
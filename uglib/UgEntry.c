@@ -108,8 +108,12 @@ UgJsonError ug_json_parse_entry(UgJson* json,
 			break;
 
 		case UG_ENTRY_STRING:
-			if (json->type == UG_JSON_STRING)
-				*(char**) dest = ug_strdup(value);
+			if (json->type == UG_JSON_STRING) {
+				if (entry->param1 == UG_ENTRY_INTERN)
+					*(char**) dest = ug_str_intern(value);
+				else
+					*(char**) dest = ug_strdup(value);
+			}
 			else if (json->type == UG_JSON_NULL)
 				*(char**) dest = NULL;
 			else
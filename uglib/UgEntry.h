@@ -71,6 +71,11 @@ typedef enum
 // ug_json_write_entry() will not output this field when value is NULL.
 #define  UG_ENTRY_NO_NULL         ((void*)(uintptr_t) 0x0001)
 
+// You can set this in UgEntry.param1 when UgEntry.type is UG_ENTRY_STRING.
+// ug_json_parse_entry() will store string by ug_str_intern(),
+// release it by ug_str_unintern().
+#define  UG_ENTRY_INTERN          ((void*)(uintptr_t) 0x0001)
+
 // ----------------------------------------------------------------------------
 // UgEntry: It can defines a object member and it's offset of data structure.
 
@@ -104,6 +109,8 @@ typedef enum
 	UgEntryType = UG_ENTRY_STRING
 	If you don't want to output anything when string value is NULL,
 	set UG_ENTRY_NO_NULL at UgEntry.param2.
+	If the same string value repeats in many objects, set UG_ENTRY_INTERN
+	at UgEntry.param1 to share it.
 
 	UgEntryType = UG_ENTRY_OBJECT
 	UgEntry.param1 pointer to UgEntry
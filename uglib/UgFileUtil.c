@@ -366,6 +366,28 @@ int  ug_create_dir_all (const char* dir, int len)
 }
 #endif  // USE__ANDROID__SAF
 
+#if defined _WIN32 || defined _WIN64
+int  ug_sync_dir (const char* dir_utf8)
+{
+	// Windows can't open directory as file descriptor.
+	// NTFS journals directory entries by itself.
+	return 0;
+}
+#else
+int  ug_sync_dir (const char* dir_utf8)
+{
+	int  fd;
+	int  retval;
+
+	fd = ug_open (dir_utf8, UG_O_RDONLY, 0);
+	if (fd == -1)
+		return -1;
+	retval = ug_sync (fd);
+	ug_close (fd);
+	return retval;
+}
+#endif  // _WIN32 || _WIN64
+
 // ----------------------------------------------------------------------------
 // File I/O
 
@@ -106,6 +106,9 @@ int   ug_delete_dir (const char *dir_utf8);
 int   ug_create_dir_all (const char* dir_utf8, int len);
 //int ug_delete_dir_all (const char* dir_utf8, int len);
 
+// flush directory entries (created/renamed files) to disk. return -1 if error
+int   ug_sync_dir (const char* dir_utf8);
+
 // ----------------------------------------------------------------------------
 // File I/O
 
@@ -36,6 +36,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <UgSlab.h>
 #include <UgInfo.h>
 
 // ----------------------------------------------------------------------------
@@ -53,6 +54,21 @@ void  ug_info_set_registry(UgRegistry* registry)
 	ug_info_registry = registry;
 }
 
+// ----------------------------------------------------------------------------
+// UgInfo slots
+
+static const UgDataInfo*  ug_info_slots[UG_INFO_N_SLOTS];
+static int                ug_info_n_slots;
+
+int   ug_info_register_slot(const UgDataInfo* key)
+{
+	if (key->slot == 0 && ug_info_n_slots < UG_INFO_N_SLOTS) {
+		ug_info_slots[ug_info_n_slots++] = key;
+		((UgDataInfo*)key)->slot = ug_info_n_slots;
+	}
+	return key->slot;
+}
+
 // ----------------------------------------------------------------------------
 // UgInfo
 
@@ -60,11 +76,7 @@ UgInfo* ug_info_new(int allocated_length, int cache_length)
 {
 	UgInfo*  info;
 
-#ifdef HAVE_GLIB
-	info = g_slice_alloc(sizeof(UgInfo));
-#else
-	info = ug_malloc(sizeof(UgInfo));
-#endif // HAVE_GLIB
+	info = ug_slab_alloc(sizeof(UgInfo));
 	ug_info_init(info, allocated_length, cache_length);
 	return info;
 }
@@ -78,11 +90,7 @@ void    ug_info_unref(UgInfo* info)
 {
 	if (--info->ref_count == 0) {
 		ug_info_final(info);
-#ifdef HAVE_GLIB
-		g_slice_free1(sizeof(UgInfo), info);
-#else
-		ug_free(info);
-#endif // HAVE_GLIB
+		ug_slab_free(sizeof(UgInfo), info);
 	}
 }
 
@@ -95,9 +103,12 @@ void  ug_info_init(UgInfo* info, int allocated_length, int cache_length)
 	info->cache_length = cache_length;
 	info->ref_count    = 1;
 
-	// clear cache
+	// clear cache and put registered slots in it
 	for (index = 0;  index < info->length;  index++) {
-		info->at[index].key  = NULL;
+		if (index < ug_info_n_slots)
+			info->at[index].key = (void*) ug_info_slots[index];
+		else
+			info->at[index].key = NULL;
 		info->at[index].data = NULL;
 	}
 }
@@ -122,6 +133,13 @@ UgPair* ug_info_find(UgInfo* info, const UgDataInfo* key, int* index)
 	UgPair*   end;
 	UgPair*   cur;
 
+	// registered slot has fixed position in cache space
+	if (key->slot && key->slot <= info->cache_length) {
+		cur = info->at + key->slot - 1;
+		if (cur->key == key)
+			return cur;
+	}
+
 	// find key in cache space
 	for (cur = info->at, end = cur + info->cache_length;  cur < end;  cur++) {
 		if (cur->key == key)
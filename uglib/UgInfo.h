@@ -64,6 +64,21 @@ void         ug_info_set_registry(UgRegistry* registry);
      data pointer to UgData
  */
 
+/* ----------------------------------------------------------------------------
+   UgInfo slots - UgDataInfo that used by almost every UgInfo can register a
+   slot at program startup. UgInfo created after that stores it at fixed
+   position in cache space, so ug_info_get() can find it without searching.
+   Other UgDataInfo still use sorted array.
+
+   ug_info_register_slot() return slot number (1 ~ UG_INFO_N_SLOTS),
+   or 0 if no free slot. UgDataInfo must not be a const object.
+   It is not thread-safe, call it before creating UgInfo in other threads.
+ */
+
+#define UG_INFO_N_SLOTS    8
+
+int   ug_info_register_slot(const UgDataInfo* key);
+
 // ----------------------------------------------------------------------------
 // UgInfo functions
 
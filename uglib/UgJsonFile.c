@@ -34,11 +34,15 @@
  *
  */
 
+#include <string.h>
 #include <UgStdio.h>
 #include <UgDefine.h>
+#include <UgString.h>
+#include <UgFileUtil.h>
 #include <UgJsonFile.h>
 
 static int  buffer_to_fd (UgBuffer* buffer);
+static int  buffer_expand_or_fd (UgBuffer* buffer);
 
 UgJsonFile*  ug_json_file_new (int buffer_size)
 {
@@ -53,6 +57,10 @@ UgJsonFile*  ug_json_file_new (int buffer_size)
 		jfile = ug_malloc (sizeof (UgJsonFile) + sizeof (char) * buffer_size - 1);
 
 	jfile->fd = -1;
+	jfile->sync = UG_JSON_FILE_SYNC_FULL;
+	jfile->path = NULL;
+	jfile->heap = NULL;
+	jfile->heap_size = 0;
 	jfile->n_bytes = buffer_size;
 	ug_json_init (&jfile->json);
 	return jfile;
@@ -63,9 +71,16 @@ void  ug_json_file_free (UgJsonFile* jfile)
 	if (jfile->fd != -1)
 		ug_close (jfile->fd);
 	ug_json_final (&jfile->json);
+	ug_free (jfile->path);
+	ug_free (jfile->heap);
 	ug_free (jfile);
 }
 
+void  ug_json_file_set_sync (UgJsonFile* jfile, UgJsonFileSync sync)
+{
+	jfile->sync = sync;
+}
+
 int   ug_json_file_begin_parse (UgJsonFile* jfile, const char* path)
 {
 	int  fd;
@@ -89,7 +104,10 @@ int   ug_json_file_begin_write (UgJsonFile* jfile, const char* path, UgJsonForma
 	if (fd == -1)
 		return FALSE;
 
-	return ug_json_file_begin_write_fd (jfile, fd, format);
+	ug_json_file_begin_write_fd (jfile, fd, format);
+	// ug_json_file_begin_write_fd() clear path
+	jfile->path = ug_strdup (path);
+	return TRUE;
 }
 
 int   ug_json_file_begin_parse_fd (UgJsonFile* jfile, int fd)
@@ -103,10 +121,15 @@ int   ug_json_file_begin_parse_fd (UgJsonFile* jfile, int fd)
 int   ug_json_file_begin_write_fd (UgJsonFile* jfile, int fd, UgJsonFormat format)
 {
 	jfile->fd = fd;
+	ug_free (jfile->path);
+	jfile->path = NULL;
 	// init UgBuffer for writer
-	ug_buffer_init_external (&jfile->buffer, jfile->bytes, jfile->n_bytes);
-	jfile->buffer.data = (void*)(uintptr_t) jfile->fd;
-	jfile->buffer.more = buffer_to_fd;
+	if (jfile->heap)
+		ug_buffer_init_external (&jfile->buffer, jfile->heap, jfile->heap_size);
+	else
+		ug_buffer_init_external (&jfile->buffer, jfile->bytes, jfile->n_bytes);
+	jfile->buffer.data = jfile;
+	jfile->buffer.more = buffer_expand_or_fd;
 	// ready to write
 	ug_json_begin_write (&jfile->json, format, &jfile->buffer);
 	return TRUE;
@@ -133,16 +156,50 @@ exit:
 
 void  ug_json_file_end_write (UgJsonFile* jfile)
 {
+	char*  sep;
+
+	// append tail to buffer, then flush all data by one write()
+	ug_buffer_write (&jfile->buffer, "\n\n", 2);
+	jfile->buffer.more = buffer_to_fd;
 	ug_json_end_write (&jfile->json);
 	ug_buffer_clear (&jfile->buffer, FALSE);
-	if (ug_write (jfile->fd, "\n\n", 2)) {}
 
 	// close() doesn't call fsync()
 	// If you want to avoid delayed write, call fsync() before close()
-	ug_sync (jfile->fd);
+	switch (jfile->sync) {
+	case UG_JSON_FILE_SYNC_DATA:
+		ug_sync_data (jfile->fd);
+		break;
+
+	case UG_JSON_FILE_SYNC_FULL:
+		ug_sync (jfile->fd);
+		break;
+
+	default:
+		break;
+	}
 
 	ug_close (jfile->fd);
 	jfile->fd = -1;
+
+	// sync directory entry of new file
+	if (jfile->path && jfile->sync == UG_JSON_FILE_SYNC_FULL) {
+		sep = strrchr (jfile->path, UG_DIR_SEPARATOR);
+#if defined _WIN32 || defined _WIN64
+		if (sep == NULL)
+			sep = strrchr (jfile->path, '/');
+#endif
+		if (sep == NULL)
+			ug_sync_dir (".");
+		else if (sep == jfile->path)
+			ug_sync_dir (UG_DIR_SEPARATOR_S);
+		else {
+			sep[0] = 0;
+			ug_sync_dir (jfile->path);
+		}
+	}
+	ug_free (jfile->path);
+	jfile->path = NULL;
 }
 
 // ----------------------------------------------------------------------------
@@ -151,12 +208,53 @@ void  ug_json_file_end_write (UgJsonFile* jfile)
 // UgBufferFunc
 static int  buffer_to_fd (UgBuffer* buffer)
 {
-	int     fd;
+	UgJsonFile*  jfile;
+	char*        cur;
+	int          len;
 
-	fd = (uintptr_t)buffer->data;
-	if (ug_write (fd, buffer->beg, ug_buffer_length (buffer))) {}
+	jfile = buffer->data;
+	for (cur = buffer->beg;  cur < buffer->cur;  cur += len) {
+		len = ug_write (jfile->fd, cur, (int) (buffer->cur - cur));
+		if (len <= 0)
+			break;
+	}
 	buffer->cur = buffer->beg;
-	return 0;
+	return 1;
 }
 
+// UgBufferFunc
+// expand buffer until it reach UG_JSON_FILE_BUFFER_MAX, then write it to fd.
+// Small file can be written by one write() call in ug_json_file_end_write().
+static int  buffer_expand_or_fd (UgBuffer* buffer)
+{
+	UgJsonFile*  jfile;
+	int          length;
+	int          used;
+
+	jfile = buffer->data;
+	length = ug_buffer_allocated (buffer);
+	if (length >= UG_JSON_FILE_BUFFER_MAX)
+		return buffer_to_fd (buffer);
+
+	length *= 2;
+	if (length > UG_JSON_FILE_BUFFER_MAX)
+		length = UG_JSON_FILE_BUFFER_MAX;
+
+	if (buffer->beg == jfile->heap) {
+		ug_buffer_set_size (buffer, length);
+		jfile->heap = buffer->beg;
+	}
+	else {
+		// move data from jfile->bytes to heap
+		used = ug_buffer_length (buffer);
+		ug_free (jfile->heap);
+		jfile->heap = ug_malloc (length);
+		memcpy (jfile->heap, buffer->beg, used);
+		ug_buffer_init_external (buffer, jfile->heap, length);
+		buffer->cur = buffer->beg + used;
+		buffer->more = buffer_expand_or_fd;
+	}
+	jfile->heap_size = length;
+	return 1;
+}
 
@@ -46,6 +46,17 @@ extern "C" {
 
 typedef struct UgJsonFile            UgJsonFile;
 
+// durability of ug_json_file_end_write()
+typedef enum {
+	UG_JSON_FILE_SYNC_NONE,     // close() only, let OS write it back later.
+	UG_JSON_FILE_SYNC_DATA,     // fdatasync() before close()
+	UG_JSON_FILE_SYNC_FULL,     // fsync() before close(), then fsync() directory.
+	                            // Directory is synced only if file opened by path.
+} UgJsonFileSync;
+
+// Writer expands buffer to this size before it call write().
+#define UG_JSON_FILE_BUFFER_MAX    (1024 * 1024)
+
 // ----------------------------------------------------------------------------
 // UgJsonFile: JSON file loader and writer
 
@@ -54,6 +65,10 @@ struct UgJsonFile
 	UgJson    json;
 	UgBuffer  buffer;
 	int       fd;
+	int       sync;     // UgJsonFileSync, default is UG_JSON_FILE_SYNC_FULL
+	char*     path;     // file path for syncing directory
+	char*     heap;     // expanded writer buffer, reused until ug_json_file_free()
+	int       heap_size;
 	int       n_bytes;
 	char      bytes[1];
 };
@@ -61,6 +76,9 @@ struct UgJsonFile
 UgJsonFile*  ug_json_file_new (int buffer_size);
 void         ug_json_file_free (UgJsonFile* jfile);
 
+// UgJsonFileSync
+void  ug_json_file_set_sync (UgJsonFile* jfile, UgJsonFileSync sync);
+
 // return TRUE or FALSE
 int   ug_json_file_begin_parse (UgJsonFile* jfile, const char* filename);
 int   ug_json_file_begin_write (UgJsonFile* jfile, const char* filename, UgJsonFormat format);
@@ -250,19 +250,27 @@ UgJsonrpcObject*  ug_jsonrpc_array_alloc(UgJsonrpcArray* joarray)
 
 UgJsonError  ug_json_parse_rpc_array(UgJson* json,
                                      const char* name, const char* value,
-                                     void* jrarray, void* none)
+                                     void* jrarray, void* spare)
 {
 	UgJsonrpcArray*   array;
+	UgJsonrpcArray*   objects;
 	UgJsonrpcObject*  object;
 
 	array = (UgJsonrpcArray*) jrarray;
+	objects = (UgJsonrpcArray*) spare;
 	if (json->type != UG_JSON_OBJECT) {
 //		if (json->type == UG_JSON_ARRAY)
 //			ug_json_push(json, ug_json_parse_unknown, NULL, NULL);
 		return UG_JSON_ERROR_RPC_INVALID;
 	}
 
-	object = ug_jsonrpc_array_alloc(array);
+	// reuse cleared object if possible
+	if (objects && objects->length > 0) {
+		object = objects->at[--objects->length];
+		*(UgJsonrpcObject**) ug_array_alloc(array, 1) = object;
+	}
+	else
+		object = ug_jsonrpc_array_alloc(array);
 	ug_json_push(json, ug_json_parse_entry,
 	             object, (void*)UgJsonrpcObjectEntry);
 	return UG_JSON_ERROR_NONE;
@@ -295,6 +303,7 @@ void  ug_jsonrpc_init(UgJsonrpc* jrpc, UgJson* json, UgBuffer* buffer)
 	jrpc->buffer = buffer;
 	jrpc->data.id.previous = 0;
 	jrpc->data.id.current = 0;
+	jrpc->spare = NULL;
 }
 
 void  ug_jsonrpc_clear(UgJsonrpc* jrpc)
@@ -407,7 +416,8 @@ int  ug_jsonrpc_call_batch(UgJsonrpc* jrpc,
 	if (response == NULL)
 		ug_json_push(jrpc->json, ug_json_parse_unknown, NULL, NULL);
 	else {
-		ug_json_push(jrpc->json, ug_json_parse_rpc_array, response, NULL);
+		ug_json_push(jrpc->json, ug_json_parse_rpc_array,
+		             response, jrpc->spare);
 		ug_json_push(jrpc->json, ug_json_parse_array, NULL, NULL);
 	}
 
@@ -441,24 +451,37 @@ int  ug_jsonrpc_receive(UgJsonrpc* jrpc,
                         UgJsonrpcArray*  jr_array)
 {
 	int    n;
-	int    type;
-	UgJsonrpcObject*  jres;
 
-	type = -1;
+	ug_jsonrpc_begin_receive(jrpc, jr_object, jr_array);
+	// receive request
+	n = jrpc->receive.func(jrpc->receive.data);
+	if (n <= 0) {
+		ug_json_end_parse(jrpc->json);
+		return n;
+	}
+	return ug_jsonrpc_end_receive(jrpc);
+}
+
+void ug_jsonrpc_begin_receive(UgJsonrpc* jrpc,
+                              UgJsonrpcObject* jr_object,
+                              UgJsonrpcArray*  jr_array)
+{
 	jrpc->error = 0;
 	jrpc->data.request.object = jr_object;
 	jrpc->data.request.array  = jr_array;
+	jrpc->data.request.type   = -1;
 
 	// parser --- start ---
 	ug_json_begin_parse(jrpc->json);
 	ug_json_push(jrpc->json, ug_json_parse_rpc_request,
-	             jrpc, &type);
-	// receive request
-	n = jrpc->receive.func(jrpc->receive.data);
-	if (n <= 0) {
-		ug_json_end_parse(jrpc->json);
-		return n;
-	}
+	             jrpc, &jrpc->data.request.type);
+}
+
+int  ug_jsonrpc_end_receive(UgJsonrpc* jrpc)
+{
+	int    n;
+	UgJsonrpcObject*  jres;
+
 	n = ug_json_end_parse(jrpc->json);
 	if (n < 0 || jrpc->error == 0)
 		jrpc->error = n;
@@ -480,7 +503,7 @@ int  ug_jsonrpc_receive(UgJsonrpc* jrpc,
 		ug_jsonrpc_object_free(jres);
 		return -1;
 	}
-	if (type < UG_JSON_OBJECT) {
+	if (jrpc->data.request.type < UG_JSON_OBJECT) {
 		// {"jsonrpc": "2.0", "error": {"code": -32600, "message": "Invalid Request"}, "id": null}
 		jres = ug_jsonrpc_object_new();
 		// "id": null
@@ -497,7 +520,7 @@ int  ug_jsonrpc_receive(UgJsonrpc* jrpc,
 		return -1;
 	}
 
-	return type;
+	return jrpc->data.request.type;
 }
 
 int  ug_jsonrpc_response(UgJsonrpc* jrpc,
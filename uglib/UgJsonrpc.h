@@ -132,9 +132,11 @@ UgJsonrpcObject*  ug_jsonrpc_array_find(UgJsonrpcArray* joarray, UgValue* id, in
 UgJsonrpcObject*  ug_jsonrpc_array_alloc(UgJsonrpcArray* joarray);
 
 // ------------------------------------
+// param spare: NULL or UgJsonrpcArray that has cleared objects.
+//              parser takes objects from it before allocating new one.
 UgJsonError  ug_json_parse_rpc_array(UgJson* json,
                                      const char* name, const char* value,
-                                     void* jrarray, void* none);
+                                     void* jrarray, void* spare);
 // param noArrayIfPossible: TRUE or FALSE
 void         ug_json_write_rpc_array(UgJson* json, UgJsonrpcArray* objects,
                                      int  noArrayIfPossible);
@@ -171,6 +173,9 @@ struct  UgJsonrpc
 		void*          data;
 	} send, receive;
 
+	// client: cleared objects for batch response, it can be NULL.
+	UgJsonrpcArray*   spare;
+
 	union {
 		// client
 		struct {
@@ -181,6 +186,7 @@ struct  UgJsonrpc
 		struct {
 			UgJsonrpcObject*  object;
 			UgJsonrpcArray*   array;
+			int               type;
 		} request;
 	} data;
 };
@@ -210,6 +216,18 @@ int  ug_jsonrpc_receive(UgJsonrpc* jrpc,
                         UgJsonrpcObject* jr_object,
                         UgJsonrpcArray*  jr_array);
 
+// ug_jsonrpc_receive() = ug_jsonrpc_begin_receive() + UgJsonrpc.receive.func
+//                        + ug_jsonrpc_end_receive()
+// Server can feed request to UgJsonrpc.json piece by piece between
+// ug_jsonrpc_begin_receive() and ug_jsonrpc_end_receive() if it doesn't want
+// to block in UgJsonrpc.receive.func
+void ug_jsonrpc_begin_receive(UgJsonrpc* jrpc,
+                              UgJsonrpcObject* jr_object,
+                              UgJsonrpcArray*  jr_array);
+// return -1 if error occurred. It send error response to client.
+// if ok, return UG_JSON_ARRAY or UG_JSON_OBJECT.
+int  ug_jsonrpc_end_receive(UgJsonrpc* jrpc);
+
 int  ug_jsonrpc_response(UgJsonrpc* jrpc,
                          UgJsonrpcObject* jr_object);
 
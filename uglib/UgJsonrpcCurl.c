@@ -43,6 +43,9 @@
 
 static int  global_ref_count = 0;
 
+static size_t  ug_jsonrpc_curl_write (char* buffer, size_t size, size_t nmemb,
+                                      UgJsonrpcCurl* jrcurl);
+
 void  ug_jsonrpc_curl_init (UgJsonrpcCurl* jrcurl)
 {
 	if (global_ref_count == 0) {
@@ -54,12 +57,24 @@ void  ug_jsonrpc_curl_init (UgJsonrpcCurl* jrcurl)
 	ug_json_init (&jrcurl->json);
 	ug_jsonrpc_init (&jrcurl->rpc, &jrcurl->json, &jrcurl->buffer);
 	jrcurl->url = NULL;
+	jrcurl->unix_socket = NULL;
 
 	// libcurl
 	jrcurl->curl = curl_easy_init ();
 	jrcurl->slist = NULL;
 	jrcurl->slist = curl_slist_append (jrcurl->slist,
 			"Content-Type: application/json-rpc; charset=utf-8");
+	// don't wait for "100 Continue" before sending large batch
+	jrcurl->slist = curl_slist_append (jrcurl->slist, "Expect:");
+
+	// These options don't change between requests.
+	curl_easy_setopt (jrcurl->curl, CURLOPT_POST, 1L);
+	curl_easy_setopt (jrcurl->curl, CURLOPT_HTTPHEADER, jrcurl->slist);
+	curl_easy_setopt (jrcurl->curl, CURLOPT_WRITEFUNCTION,
+			(curl_write_callback) ug_jsonrpc_curl_write);
+	curl_easy_setopt (jrcurl->curl, CURLOPT_WRITEDATA, jrcurl);
+	// keep idle connection alive between polling
+	curl_easy_setopt (jrcurl->curl, CURLOPT_TCP_KEEPALIVE, 1L);
 
 	jrcurl->rpc.send.func = (UgJsonrpcFunc) ug_jsonrpc_curl_send;
 	jrcurl->rpc.send.data = jrcurl;
@@ -78,6 +93,7 @@ void  ug_jsonrpc_curl_final (UgJsonrpcCurl* jrcurl)
 	ug_jsonrpc_clear (&jrcurl->rpc);
 	ug_buffer_clear (&jrcurl->buffer, TRUE);
 	ug_free (jrcurl->url);
+	ug_free (jrcurl->unix_socket);
 
 	// libcurl
 	curl_easy_cleanup (jrcurl->curl);
@@ -96,7 +112,18 @@ void  ug_jsonrpc_curl_set_url (UgJsonrpcCurl* jrcurl, const char* url)
 	curl_easy_setopt (jrcurl->curl, CURLOPT_SSL_VERIFYPEER, 0L);
 }
 
-static size_t	ug_jsonrpc_curl_write (char* buffer, size_t size, size_t nmemb, UgJsonrpcCurl* jrcurl)
+void  ug_jsonrpc_curl_set_unix_socket (UgJsonrpcCurl* jrcurl, const char* path)
+{
+	ug_free (jrcurl->unix_socket);
+	jrcurl->unix_socket = (path) ? ug_strdup (path) : NULL;
+#if LIBCURL_VERSION_NUM >= 0x072800    // 7.40.0
+	curl_easy_setopt (jrcurl->curl, CURLOPT_UNIX_SOCKET_PATH, jrcurl->unix_socket);
+#endif
+}
+
+// parse response while it is received, don't buffer whole response.
+static size_t  ug_jsonrpc_curl_write (char* buffer, size_t size, size_t nmemb,
+                                      UgJsonrpcCurl* jrcurl)
 {
 	int  error;
 
@@ -117,19 +144,16 @@ int   ug_jsonrpc_curl_send (UgJsonrpcCurl* jrcurl)
 	int  send_size;
 
 	send_size = jrcurl->buffer.cur - jrcurl->buffer.beg;
-	curl_easy_setopt (jrcurl->curl, CURLOPT_POST, TRUE);
 	curl_easy_setopt (jrcurl->curl, CURLOPT_POSTFIELDS, jrcurl->buffer.beg);
 	curl_easy_setopt (jrcurl->curl, CURLOPT_POSTFIELDSIZE, send_size);
-	curl_easy_setopt (jrcurl->curl, CURLOPT_HTTPHEADER, jrcurl->slist);
-	curl_easy_setopt (jrcurl->curl, CURLOPT_WRITEFUNCTION,
-			(curl_write_callback) ug_jsonrpc_curl_write);
-	curl_easy_setopt (jrcurl->curl, CURLOPT_WRITEDATA, jrcurl);
-
-	curl_easy_perform (jrcurl->curl);
 
+	// ug_jsonrpc_curl_write() count received size
 	jrcurl->receive_size = 0;
 	jrcurl->response = 0;
-	curl_easy_getinfo (jrcurl->curl, CURLINFO_RESPONSE_CODE, &jrcurl->response);
+	if (curl_easy_perform (jrcurl->curl) == CURLE_OK) {
+		curl_easy_getinfo (jrcurl->curl, CURLINFO_RESPONSE_CODE,
+		                   &jrcurl->response);
+	}
 
 	jrcurl->buffer.cur = jrcurl->buffer.beg;
 	if (jrcurl->response != 200)
@@ -48,6 +48,9 @@ typedef struct UgJsonrpcCurl             UgJsonrpcCurl;
 // ----------------------------------------------------------------------------
 // UgJsonrpcCurl: JSON-RPC by curl (client only)
 
+// One curl handle is reused, so connection is kept alive between requests.
+// Response is parsed piece by piece while it is received.
+
 struct  UgJsonrpcCurl
 {
 	UgJson     json;
@@ -55,6 +58,7 @@ struct  UgJsonrpcCurl
 	UgBuffer   buffer;
 
 	char*      url;
+	char*      unix_socket;
 	void*      curl;
 	void*      slist;
 	long       response;
@@ -66,6 +70,9 @@ void  ug_jsonrpc_curl_final (UgJsonrpcCurl* jrcurl);
 
 // bool
 void  ug_jsonrpc_curl_set_url (UgJsonrpcCurl* jrhttp, const char* url);
+// connect to HTTP server (or local proxy) through Unix domain socket.
+// path = NULL to use TCP.
+void  ug_jsonrpc_curl_set_unix_socket (UgJsonrpcCurl* jrcurl, const char* path);
 
 int   ug_jsonrpc_curl_send (UgJsonrpcCurl* jrcurl);
 int   ug_jsonrpc_curl_receive (UgJsonrpcCurl* jrcurl);
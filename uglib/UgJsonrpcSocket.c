@@ -34,6 +34,8 @@
  *
  */
 
+#include <errno.h>
+#include <stddef.h>   // offsetof()
 #include <string.h>
 #include <UgDefine.h>
 #include <UgThread.h>
@@ -249,3 +251,303 @@ void  ug_socket_server_run_jsonrpc (UgSocketServer* server,
 	ug_socket_server_start (server);
 }
 
+// ------------------------------------
+// one thread handle all connection concurrently
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL    0
+#endif
+
+struct UgJsonrpcSocketPeer
+{
+	UG_JSONRPC_SOCKET_MEMBERS;
+//	UgJson           json;
+//	UgJsonrpc        rpc;
+//	UgBuffer         buffer;    // response
+//	int              socket;
+
+	UgSocketServer*  server;
+	UgSocketWatch    watch;
+	UgJsonrpcObject  jobject;
+	UgJsonrpcArray   jarray;
+
+	// ug_jsonrpc_socket_hold()
+	UgJsonrpcClosedFunc  closed;
+	void*                closed_data;
+
+	int       sent;      // bytes of response have been sent
+	int       length;    // bytes of current request
+	int       depth;     // depth of object and array in current request
+	uint8_t   in_string;
+	uint8_t   escaped;
+	uint8_t   closing;   // close connection after response was sent
+};
+
+static int  would_block (void)
+{
+#if defined _WIN32 || defined _WIN64
+	return WSAGetLastError () == WSAEWOULDBLOCK;
+#else
+	return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+#define PEER_FROM_JSONRPC(jrpc)    \
+		((struct UgJsonrpcSocketPeer*) ((char*)(jrpc) - offsetof (struct UgJsonrpcSocketPeer, rpc)))
+
+static void peer_free (struct UgJsonrpcSocketPeer* peer)
+{
+	if (peer->closed)
+		peer->closed (&peer->rpc, peer->closed_data);
+	ug_jsonrpc_object_clear (&peer->jobject);
+	ug_jsonrpc_array_clear (&peer->jarray, TRUE);
+	ug_jsonrpc_socket_final ((UgJsonrpcSocket*) peer);
+	ug_free (peer);
+}
+
+// return number of bytes that haven't been sent, -1 if error occurred.
+static int  peer_flush (struct UgJsonrpcSocketPeer* peer)
+{
+	int  length;
+	int  n;
+
+	length = ug_buffer_length (&peer->buffer) - peer->sent;
+	while (length > 0) {
+		n = send (peer->socket, peer->buffer.beg + peer->sent, length,
+		          MSG_NOSIGNAL);
+		if (n == -1) {
+			if (would_block ())
+				break;
+			return -1;
+		}
+		peer->sent += n;
+		length -= n;
+	}
+	if (length == 0) {
+		peer->buffer.cur = peer->buffer.beg;
+		peer->sent = 0;
+	}
+	return length;
+}
+
+// UgJsonrpc.send.func. Remaining response will be sent when socket is writable.
+static int  peer_send (struct UgJsonrpcSocketPeer* peer)
+{
+	int  n;
+
+	n = ug_buffer_length (&peer->buffer) - peer->sent;
+	if (peer_flush (peer) == -1)
+		return -1;
+	return n;
+}
+
+// return FALSE if connection should be closed.
+static int  peer_feed (struct UgJsonrpcSocketPeer* peer,
+                       const char* data, int length)
+{
+	UgJsonrpcRequestFunc  callback;
+	const char* beg;
+	const char* cur;
+	const char* end;
+	int         error;
+	int         type;
+
+	cur = data;
+	end = data + length;
+	while (cur < end) {
+		if (peer->length == 0) {
+			// skip white space between requests
+			while (cur < end && (*cur == ' ' || *cur == '\t' ||
+			                     *cur == '\r' || *cur == '\n'))
+				cur++;
+			if (cur == end)
+				break;
+			ug_jsonrpc_begin_receive (&peer->rpc,
+			                          &peer->jobject, &peer->jarray);
+			// request is not object or array, reply error and close.
+			if (*cur != '{' && *cur != '[') {
+				ug_json_parse (&peer->json, cur, end - cur);
+				ug_jsonrpc_end_receive (&peer->rpc);
+				return FALSE;
+			}
+		}
+
+		// find the end of request
+		for (beg = cur;  cur < end;  cur++) {
+			if (peer->in_string) {
+				if (peer->escaped)
+					peer->escaped = FALSE;
+				else if (*cur == '\\')
+					peer->escaped = TRUE;
+				else if (*cur == '"')
+					peer->in_string = FALSE;
+			}
+			else if (*cur == '"')
+				peer->in_string = TRUE;
+			else if (*cur == '{' || *cur == '[')
+				peer->depth++;
+			else if (*cur == '}' || *cur == ']') {
+				if (--peer->depth == 0) {
+					cur++;
+					break;
+				}
+			}
+		}
+
+		peer->length += cur - beg;
+		if (peer->length > UG_JSONRPC_SOCKET_REQUEST_MAX)
+			return FALSE;
+		error = ug_json_parse (&peer->json, beg, cur - beg);
+		if (error < 0 || peer->rpc.error == 0)
+			peer->rpc.error = error;
+		if (peer->depth > 0)
+			break;
+
+		// request completed
+		peer->length = 0;
+		type = ug_jsonrpc_end_receive (&peer->rpc);
+		if (type < 0)
+			return FALSE;
+		callback = peer->server->user.data3;
+		callback (&peer->rpc, type, &peer->jobject, &peer->jarray,
+		          peer->server->user.data);
+	}
+	return TRUE;
+}
+
+static void on_peer_ready (UgSocketWatch* watch, int events)
+{
+	struct UgJsonrpcSocketPeer* peer;
+	char    data[4096];
+	int     n;
+
+	peer = watch->data;
+	// watch has been removed from server
+	if (events & UG_SOCKET_TIMEOUT) {
+		peer_free (peer);
+		return;
+	}
+
+	if (events & UG_SOCKET_WRITE) {
+		if (peer_flush (peer) == -1)
+			goto close;
+	}
+	if (events & UG_SOCKET_READ && peer->closing == FALSE) {
+		// if connection was closed, recv() will return zero.
+		n = recv (peer->socket, data, sizeof (data), 0);
+		if (n == 0 || (n == -1 && would_block () == FALSE))
+			goto close;
+		if (n > 0 && peer_feed (peer, data, n) == FALSE)
+			peer->closing = TRUE;
+	}
+
+	// wait until response was sent
+	if (ug_buffer_length (&peer->buffer) > peer->sent)
+		n = UG_SOCKET_WRITE;
+	else if (peer->closing)
+		goto close;
+	else
+		n = UG_SOCKET_READ;
+	if (watch->events != n) {
+		watch->events = n;
+		ug_socket_server_watch (peer->server, watch);
+	}
+	return;
+
+close:
+	ug_socket_server_unwatch (peer->server, watch);
+	peer_free (peer);
+}
+
+static void on_receiving_poll (UgSocketServer* server, SOCKET client_fd, void* data)
+{
+	struct UgJsonrpcSocketPeer* peer;
+
+	if (ug_socket_set_blocking (client_fd, FALSE) == FALSE) {
+		closesocket (client_fd);
+		return;
+	}
+
+	peer = ug_malloc0 (sizeof (struct UgJsonrpcSocketPeer));
+	ug_jsonrpc_socket_init ((UgJsonrpcSocket*) peer);
+	peer->rpc.send.func = (UgJsonrpcFunc) peer_send;
+	peer->rpc.send.data = peer;
+	peer->rpc.receive.func = NULL;
+	peer->socket = client_fd;
+	peer->server = server;
+	ug_jsonrpc_object_init (&peer->jobject);
+	ug_jsonrpc_array_init (&peer->jarray, 8);
+
+	peer->watch.socket = client_fd;
+	peer->watch.events = UG_SOCKET_READ;
+	peer->watch.timeout = UG_JSONRPC_SOCKET_TIMEOUT;
+	peer->watch.func = on_peer_ready;
+	peer->watch.data = peer;
+	ug_socket_server_watch (server, &peer->watch);
+}
+
+void  ug_jsonrpc_socket_hold (UgJsonrpc* jrpc, UgJsonrpcClosedFunc closed,
+                              void* data)
+{
+	struct UgJsonrpcSocketPeer* peer;
+
+	peer = PEER_FROM_JSONRPC (jrpc);
+	peer->closed = closed;
+	peer->closed_data = data;
+	// no time limit
+	peer->watch.timeout = 0;
+	ug_socket_server_watch (peer->server, &peer->watch);
+}
+
+void  ug_jsonrpc_socket_release (UgJsonrpc* jrpc)
+{
+	struct UgJsonrpcSocketPeer* peer;
+
+	peer = PEER_FROM_JSONRPC (jrpc);
+	peer->closed = NULL;
+	peer->closed_data = NULL;
+	peer->watch.timeout = UG_JSONRPC_SOCKET_TIMEOUT;
+	ug_socket_server_watch (peer->server, &peer->watch);
+}
+
+int   ug_jsonrpc_socket_notify (UgJsonrpc* jrpc, UgJsonrpcObject* jobj)
+{
+	struct UgJsonrpcSocketPeer* peer;
+	UgJson  json;
+
+	peer = PEER_FROM_JSONRPC (jrpc);
+	if (peer->closing)
+		return FALSE;
+	// client doesn't read data
+	if (ug_buffer_length (&peer->buffer) - peer->sent > UG_JSONRPC_SOCKET_REQUEST_MAX)
+		return FALSE;
+
+	// peer->json may be parsing request, use another UgJson to write.
+	ug_json_init (&json);
+	ug_json_begin_write (&json, 0, &peer->buffer);
+	ug_json_write_rpc_object (&json, jobj);
+	ug_json_end_write (&json);
+	ug_json_final (&json);
+
+	// if error occurred, on_peer_ready() will fail to send and close it.
+	if (peer_flush (peer) == -1)
+		peer->closing = TRUE;
+	if (ug_buffer_length (&peer->buffer) > peer->sent &&
+	    peer->watch.events != UG_SOCKET_WRITE)
+	{
+		peer->watch.events = UG_SOCKET_WRITE;
+		ug_socket_server_watch (peer->server, &peer->watch);
+	}
+	return (peer->closing) ? FALSE : TRUE;
+}
+
+void  ug_socket_server_poll_jsonrpc (UgSocketServer* server,
+                                     UgJsonrpcRequestFunc callback,
+                                     void* data)
+{
+	server->user.data  = data;
+	server->user.data2 = NULL;
+	server->user.data3 = callback;
+	ug_socket_server_set_receiver (server, on_receiving_poll, NULL);
+	ug_socket_server_start (server);
+}
@@ -104,6 +104,38 @@ void  ug_socket_server_run_jsonrpc (UgSocketServer* server,
                                     UgJsonrpcServerFunc callback,
                                     void* data, void* data2);
 
+// one thread handle all connection concurrently.
+// Client sockets are non-blocking and watched by server thread. Request is
+// parsed piece by piece when data arrive, then 'callback' is called with
+// 'type' (UG_JSON_OBJECT or UG_JSON_ARRAY) and parsed 'jobj' or 'jarray'.
+// 'callback' must clear them after response. Client will be closed if it is
+// idle longer than UG_JSONRPC_SOCKET_TIMEOUT or request is larger than
+// UG_JSONRPC_SOCKET_REQUEST_MAX.
+#define UG_JSONRPC_SOCKET_TIMEOUT        10000        // milliseconds
+#define UG_JSONRPC_SOCKET_REQUEST_MAX    (1024 * 1024)
+
+typedef void (*UgJsonrpcRequestFunc) (UgJsonrpc* jrpc, int type,
+                                      UgJsonrpcObject* jobj,
+                                      UgJsonrpcArray*  jarray,
+                                      void* data);
+
+void  ug_socket_server_poll_jsonrpc (UgSocketServer* server,
+                                     UgJsonrpcRequestFunc callback,
+                                     void* data);
+
+// These functions must be called in server thread of
+// ug_socket_server_poll_jsonrpc(). 'jrpc' is from UgJsonrpcRequestFunc.
+// ug_jsonrpc_socket_hold() keep connection without time limit and 'closed' is
+// called before 'jrpc' is freed. ug_jsonrpc_socket_notify() send 'jobj' (e.g.
+// notification) to held connection. It return FALSE if connection is closing
+// or client doesn't read data.
+typedef void (*UgJsonrpcClosedFunc) (UgJsonrpc* jrpc, void* data);
+
+void  ug_jsonrpc_socket_hold (UgJsonrpc* jrpc, UgJsonrpcClosedFunc closed,
+                              void* data);
+void  ug_jsonrpc_socket_release (UgJsonrpc* jrpc);
+int   ug_jsonrpc_socket_notify (UgJsonrpc* jrpc, UgJsonrpcObject* jobj);
+
 #ifdef __cplusplus
 }
 #endif
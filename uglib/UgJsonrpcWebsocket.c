@@ -0,0 +1,571 @@
+/*
+ *
+ *   Copyright (C) 2012-2020 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <UgDefine.h>
+#include <UgString.h>
+#include <UgUtil.h>
+#include <UgUri.h>
+#include <UgSocket.h>
+#include <UgJsonrpcWebsocket.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL    0
+#endif
+
+#if defined _WIN32 || defined _WIN64
+static int  global_ref_count = 0;
+#endif
+
+// opcode of WebSocket frame (RFC 6455)
+enum {
+	WS_OP_CONTINUATION = 0x0,
+	WS_OP_TEXT         = 0x1,
+	WS_OP_BINARY       = 0x2,
+	WS_OP_CLOSE        = 0x8,
+	WS_OP_PING         = 0x9,
+	WS_OP_PONG         = 0xA,
+};
+
+static int  ws_send_frame (UgJsonrpcWebsocket* jrws, int opcode,
+                           char* payload, int length);
+static int  ws_read_message (UgJsonrpcWebsocket* jrws, int milliseconds);
+static int  ws_take_notification (UgJsonrpcWebsocket* jrws, int length);
+static void ws_disconnect (UgJsonrpcWebsocket* jrws);
+
+void  ug_jsonrpc_websocket_init (UgJsonrpcWebsocket* jrws)
+{
+#if defined _WIN32 || defined _WIN64
+	WSADATA  WSAData;
+
+	if (global_ref_count == 0)
+		WSAStartup (MAKEWORD (2, 2), &WSAData);
+	global_ref_count++;
+#endif // _WIN32 || _WIN64
+
+	ug_buffer_init (&jrws->buffer, 4096);
+	ug_buffer_init (&jrws->input, 4096);
+	ug_buffer_init (&jrws->message, 4096);
+	ug_json_init (&jrws->json);
+	ug_json_init (&jrws->notify_json);
+	ug_jsonrpc_init (&jrws->rpc, &jrws->json, &jrws->buffer);
+	ug_jsonrpc_array_init (&jrws->notifications, 8);
+	jrws->socket = INVALID_SOCKET;
+	// seed of xorshift, it must not be zero.
+	jrws->mask_seed = (uint32_t) time (NULL) ^ (uint32_t) (uintptr_t) jrws;
+	jrws->mask_seed |= 1;
+
+	jrws->rpc.send.func = (UgJsonrpcFunc) ug_jsonrpc_websocket_send;
+	jrws->rpc.send.data = jrws;
+	jrws->rpc.receive.func = (UgJsonrpcFunc) ug_jsonrpc_websocket_receive;
+	jrws->rpc.receive.data = jrws;
+}
+
+void  ug_jsonrpc_websocket_final (UgJsonrpcWebsocket* jrws)
+{
+	int  index;
+
+	ug_jsonrpc_websocket_close (jrws);
+
+	for (index = 0;  index < jrws->notifications.length;  index++)
+		ug_jsonrpc_object_free (jrws->notifications.at[index]);
+	ug_array_clear (&jrws->notifications);
+
+	ug_json_final (&jrws->json);
+	ug_json_final (&jrws->notify_json);
+	ug_jsonrpc_clear (&jrws->rpc);
+	ug_buffer_clear (&jrws->buffer, TRUE);
+	ug_buffer_clear (&jrws->input, TRUE);
+	ug_buffer_clear (&jrws->message, TRUE);
+
+#if defined _WIN32 || defined _WIN64
+	global_ref_count--;
+	if (global_ref_count == 0)
+		WSACleanup ();
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// static functions
+
+static void  ws_random (UgJsonrpcWebsocket* jrws, uint8_t* bytes, int length)
+{
+	uint32_t  x;
+
+	// xorshift32, masking key doesn't need strong random number.
+	x = jrws->mask_seed;
+	while (length--) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		*bytes++ = (uint8_t) x;
+	}
+	jrws->mask_seed = x;
+}
+
+static const char* ws_find (const char* beg, int length, const char* str)
+{
+	const char*  end;
+	int          str_len;
+
+	str_len = strlen (str);
+	for (end = beg + length - str_len;  beg <= end;  beg++) {
+		if (beg[0] == str[0] && memcmp (beg, str, str_len) == 0)
+			return beg;
+	}
+	return NULL;
+}
+
+static int  ws_send_all (UgJsonrpcWebsocket* jrws, const char* data, int length)
+{
+	int  n;
+
+	while (length > 0) {
+		n = send (jrws->socket, data, length, MSG_NOSIGNAL);
+		if (n <= 0)
+			return -1;
+		data   += n;
+		length -= n;
+	}
+	return 0;
+}
+
+// return number of bytes, return 0 if timed out, return -1 if error or closed.
+static int  ws_recv (UgJsonrpcWebsocket* jrws, int milliseconds)
+{
+	struct timeval  timeout;
+	fd_set          read_fds;
+	int             n;
+
+	FD_ZERO (&read_fds);
+	FD_SET (jrws->socket, &read_fds);
+	timeout.tv_sec  = milliseconds / 1000;
+	timeout.tv_usec = (milliseconds % 1000) * 1000;
+	n = select (jrws->socket + 1, &read_fds, NULL, NULL, &timeout);
+	if (n <= 0)
+		return n;
+
+	if (ug_buffer_remain (&jrws->input) < 4096) {
+		ug_buffer_set_size (&jrws->input,
+				ug_buffer_allocated (&jrws->input) * 2);
+	}
+	// if connection was closed, recv() will return zero.
+	n = recv (jrws->socket, jrws->input.cur, ug_buffer_remain (&jrws->input), 0);
+	if (n <= 0)
+		return -1;
+	jrws->input.cur += n;
+	return n;
+}
+
+// remove 'length' bytes from beginning of input buffer
+static void  ws_consume (UgJsonrpcWebsocket* jrws, int length)
+{
+	memmove (jrws->input.beg, jrws->input.beg + length,
+	         ug_buffer_length (&jrws->input) - length);
+	jrws->input.cur -= length;
+}
+
+static void  ws_disconnect (UgJsonrpcWebsocket* jrws)
+{
+	if (jrws->socket != INVALID_SOCKET) {
+		closesocket (jrws->socket);
+		jrws->socket = INVALID_SOCKET;
+	}
+	jrws->input.cur = jrws->input.beg;
+	jrws->message.cur = jrws->message.beg;
+}
+
+static int  ws_send_frame (UgJsonrpcWebsocket* jrws, int opcode,
+                           char* payload, int length)
+{
+	uint8_t   header[14];
+	uint8_t*  mask;
+	int       header_len;
+	int       index;
+
+	header[0] = 0x80 | opcode;    // FIN
+	if (length < 126) {
+		header[1] = 0x80 | length;
+		header_len = 2;
+	}
+	else if (length < 65536) {
+		header[1] = 0x80 | 126;
+		header[2] = (uint8_t) (length >> 8);
+		header[3] = (uint8_t) length;
+		header_len = 4;
+	}
+	else {
+		header[1] = 0x80 | 127;
+		for (index = 0;  index < 8;  index++)
+			header[2 + index] = (uint8_t) ((uint64_t) length >> (56 - index * 8));
+		header_len = 10;
+	}
+
+	// client must mask payload. It is masked in place.
+	mask = header + header_len;
+	ws_random (jrws, mask, 4);
+	header_len += 4;
+	for (index = 0;  index < length;  index++)
+		payload[index] ^= mask[index & 3];
+
+	if (ws_send_all (jrws, (char*) header, header_len) == -1 ||
+	    ws_send_all (jrws, payload, length) == -1)
+	{
+		return -1;
+	}
+	return length;
+}
+
+// return length of frame if input buffer has complete frame.
+// return 0 if frame is incomplete. return -1 if frame is too large.
+static int  ws_parse_frame (UgJsonrpcWebsocket* jrws, int* fin, int* opcode,
+                            char** payload, int* payload_len)
+{
+	uint8_t*  beg;
+	uint8_t*  mask;
+	uint64_t  length;
+	int       input_len;
+	int       header_len;
+	int       index;
+
+	beg = (uint8_t*) jrws->input.beg;
+	input_len = ug_buffer_length (&jrws->input);
+	if (input_len < 2)
+		return 0;
+
+	header_len = 2;
+	length = beg[1] & 0x7F;
+	if (length == 126) {
+		header_len = 4;
+		if (input_len < header_len)
+			return 0;
+		length = (beg[2] << 8) | beg[3];
+	}
+	else if (length == 127) {
+		header_len = 10;
+		if (input_len < header_len)
+			return 0;
+		for (length = 0, index = 2;  index < 10;  index++)
+			length = (length << 8) | beg[index];
+	}
+	// server must not mask frame, but accept it.
+	mask = NULL;
+	if (beg[1] & 0x80) {
+		mask = beg + header_len;
+		header_len += 4;
+	}
+
+	if (length > (uint64_t) (INT32_MAX - header_len))
+		return -1;
+	if (input_len < header_len + (int) length)
+		return 0;
+
+	if (mask) {
+		for (index = 0;  index < (int) length;  index++)
+			beg[header_len + index] ^= mask[index & 3];
+	}
+	*fin = beg[0] & 0x80;
+	*opcode = beg[0] & 0x0F;
+	*payload = (char*) beg + header_len;
+	*payload_len = (int) length;
+	return header_len + (int) length;
+}
+
+// read one text message. 'milliseconds' is used if no data arrived.
+// return length of message, return 0 if timed out, return -1 if error.
+static int  ws_read_message (UgJsonrpcWebsocket* jrws, int milliseconds)
+{
+	char*  payload;
+	int    payload_len;
+	int    frame_len;
+	int    opcode;
+	int    fin;
+	int    n;
+
+	jrws->message.cur = jrws->message.beg;
+	for (;;) {
+		frame_len = ws_parse_frame (jrws, &fin, &opcode, &payload, &payload_len);
+		if (frame_len == -1)
+			return -1;
+		if (frame_len == 0) {
+			// don't give up partial message
+			if (ug_buffer_length (&jrws->input) > 0 ||
+			    ug_buffer_length (&jrws->message) > 0)
+			{
+				milliseconds = UG_JSONRPC_WEBSOCKET_TIMEOUT;
+			}
+			n = ws_recv (jrws, milliseconds);
+			if (n == -1)
+				return -1;
+			if (n == 0)
+				return (milliseconds == UG_JSONRPC_WEBSOCKET_TIMEOUT) ? -1 : 0;
+			continue;
+		}
+
+		switch (opcode) {
+		case WS_OP_PING:
+			ws_send_frame (jrws, WS_OP_PONG, payload, payload_len);
+			break;
+
+		case WS_OP_PONG:
+			break;
+
+		case WS_OP_CLOSE:
+			return -1;
+
+		default:
+			memcpy (ug_buffer_alloc (&jrws->message, payload_len),
+			        payload, payload_len);
+			break;
+		}
+		ws_consume (jrws, frame_len);
+
+		// control frame can be injected in the middle of a fragmented message.
+		if (fin && opcode < WS_OP_CLOSE && ug_buffer_length (&jrws->message) > 0)
+			return ug_buffer_length (&jrws->message);
+	}
+}
+
+// return TRUE if message is notification and it was taken.
+static int  ws_take_notification (UgJsonrpcWebsocket* jrws, int length)
+{
+	UgJsonrpcObject*  jobj;
+	const char*       beg;
+
+	// response of batch request is array, it doesn't need to be parsed twice.
+	for (beg = jrws->message.beg;  length > 0;  beg++, length--) {
+		if (beg[0] != ' ' && beg[0] != '\t' && beg[0] != '\r' && beg[0] != '\n')
+			break;
+	}
+	if (length == 0 || beg[0] != '{' || ws_find (beg, length, "\"method\"") == NULL)
+		return FALSE;
+
+	jobj = ug_jsonrpc_object_new ();
+	ug_json_begin_parse (&jrws->notify_json);
+	ug_json_push (&jrws->notify_json, ug_json_parse_entry,
+	              jobj, (void*) UgJsonrpcObjectEntry);
+	ug_json_push (&jrws->notify_json, ug_json_parse_object, NULL, NULL);
+	ug_json_parse (&jrws->notify_json, beg, length);
+	// notification is a request object without "id" member
+	if (ug_json_end_parse (&jrws->notify_json) < 0 ||
+	    jobj->method == NULL || jobj->id.type != UG_VALUE_NONE)
+	{
+		ug_jsonrpc_object_free (jobj);
+		return FALSE;
+	}
+
+	*(UgJsonrpcObject**) ug_array_alloc (&jrws->notifications, 1) = jobj;
+	return TRUE;
+}
+
+// ----------------------------------------------------------------------------
+// Client API
+
+int   ug_jsonrpc_websocket_connect (UgJsonrpcWebsocket* jrws, const char* uri)
+{
+	UgUri        uuri;
+	const char*  str;
+	const char*  path;
+	char*        host;
+	char*        port;
+	char*        key;
+	char*        request;
+	uint8_t      nonce[16];
+	int          path_len;
+	int          length;
+	SOCKET       fd;
+
+	if (jrws->socket != INVALID_SOCKET)
+		return FALSE;
+
+	ug_uri_init (&uuri, uri);
+	length = ug_uri_part_host (&uuri, &str);
+	if (length == 0)
+		return FALSE;
+	host = ug_strndup (str, length);
+	length = ug_uri_part_port (&uuri, &str);
+	if (length)
+		port = ug_strndup (str, length);
+	else
+		port = ug_strdup ("80");
+	path = uri + uuri.path;
+	path_len = strcspn (path, "#");
+	if (path_len == 0) {
+		path = "/";
+		path_len = 1;
+	}
+
+	// caller may be the only thread that talk to server, don't block it long.
+	// IPv6 address in square brackets, e.g. "[::1]"
+	length = strlen (host);
+	if (host[0] == '[' && host[length - 1] == ']') {
+		host[length - 1] = 0;
+		fd = ug_socket_connect_timeout (host + 1, port, UG_JSONRPC_WEBSOCKET_CONNECT_TIMEOUT);
+		host[length - 1] = ']';
+	}
+	else
+		fd = ug_socket_connect_timeout (host, port, UG_JSONRPC_WEBSOCKET_CONNECT_TIMEOUT);
+	if (fd == INVALID_SOCKET)
+		goto failed;
+	jrws->socket = fd;
+	jrws->input.cur = jrws->input.beg;
+
+	// opening handshake. Sec-WebSocket-Accept is not verified.
+	ws_random (jrws, nonce, sizeof (nonce));
+	key = ug_base64_encode (nonce, sizeof (nonce), NULL);
+	request = ug_strdup_printf (
+			"GET %.*s HTTP/1.1\r\n"
+			"Host: %s:%s\r\n"
+			"Upgrade: websocket\r\n"
+			"Connection: Upgrade\r\n"
+			"Sec-WebSocket-Key: %s\r\n"
+			"Sec-WebSocket-Version: 13\r\n"
+			"\r\n",
+			path_len, path, host, port, key);
+	length = ws_send_all (jrws, request, strlen (request));
+	ug_free (request);
+	ug_free (key);
+	if (length == -1)
+		goto disconnect;
+
+	// read response header
+	for (;;) {
+		if (ws_recv (jrws, UG_JSONRPC_WEBSOCKET_CONNECT_TIMEOUT) <= 0)
+			goto disconnect;
+		length = ug_buffer_length (&jrws->input);
+		str = ws_find (jrws->input.beg, length, "\r\n\r\n");
+		if (str)
+			break;
+		if (length > 16384)
+			goto disconnect;
+	}
+	// status line: "HTTP/1.1 101 Switching Protocols"
+	if (strncmp (jrws->input.beg, "HTTP/1.", 7) != 0 ||
+	    strncmp (jrws->input.beg + 8, " 101", 4) != 0)
+	{
+		goto disconnect;
+	}
+	// frames may follow response header
+	ws_consume (jrws, str + 4 - jrws->input.beg);
+
+	ug_free (host);
+	ug_free (port);
+	return TRUE;
+
+disconnect:
+	ws_disconnect (jrws);
+failed:
+	ug_free (host);
+	ug_free (port);
+	return FALSE;
+}
+
+void  ug_jsonrpc_websocket_close (UgJsonrpcWebsocket* jrws)
+{
+	char  code[2];
+
+	if (jrws->socket != INVALID_SOCKET) {
+		// closing handshake, status code 1000 is normal closure.
+		code[0] = (char) (1000 >> 8);
+		code[1] = (char) (1000 & 0xFF);
+		ws_send_frame (jrws, WS_OP_CLOSE, code, 2);
+		ws_disconnect (jrws);
+	}
+}
+
+int   ug_jsonrpc_websocket_send (UgJsonrpcWebsocket* jrws)
+{
+	int  n;
+
+	if (jrws->socket == INVALID_SOCKET)
+		n = -1;
+	else {
+		n = ws_send_frame (jrws, WS_OP_TEXT, jrws->buffer.beg,
+		                   ug_buffer_length (&jrws->buffer));
+		if (n == -1)
+			ws_disconnect (jrws);
+	}
+	jrws->buffer.cur = jrws->buffer.beg;
+	return n;
+}
+
+int   ug_jsonrpc_websocket_receive (UgJsonrpcWebsocket* jrws)
+{
+	int  length;
+	int  error;
+
+	if (jrws->socket == INVALID_SOCKET)
+		return -1;
+	// skip notifications until response arrived
+	do {
+		length = ws_read_message (jrws, UG_JSONRPC_WEBSOCKET_TIMEOUT);
+		if (length <= 0) {
+			ws_disconnect (jrws);
+			return -1;
+		}
+	} while (ws_take_notification (jrws, length));
+
+	error = ug_json_parse (&jrws->json, jrws->message.beg, length);
+	if (error < 0 || jrws->rpc.error == 0)
+		jrws->rpc.error = error;
+	return length;
+}
+
+int   ug_jsonrpc_websocket_wait (UgJsonrpcWebsocket* jrws, int milliseconds)
+{
+	int  length;
+	int  counts = 0;
+
+	if (jrws->socket == INVALID_SOCKET)
+		return -1;
+
+	for (;;) {
+		length = ws_read_message (jrws, milliseconds);
+		if (length == 0)
+			break;
+		if (length == -1) {
+			ws_disconnect (jrws);
+			return -1;
+		}
+		if (ws_take_notification (jrws, length))
+			counts++;
+		// read other arrived messages without waiting
+		milliseconds = 0;
+	}
+	return counts;
+}
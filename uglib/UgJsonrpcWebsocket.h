@@ -0,0 +1,104 @@
+/*
+ *
+ *   Copyright (C) 2012-2020 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#ifndef UG_JSONRPC_WEBSOCKET_H
+#define UG_JSONRPC_WEBSOCKET_H
+
+#include <stdint.h>
+#include <UgJsonrpc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct UgJsonrpcWebsocket   UgJsonrpcWebsocket;
+
+// ----------------------------------------------------------------------------
+// UgJsonrpcWebsocket: JSON-RPC over WebSocket (client only)
+
+//           +-----------------------------+
+//           |     UgJsonrpcWebsocket      |    UgJsonrpcArray
+// buffer <--+--> UgJson <--> UgJsonrpc <--+-->       or
+//           |                             |    UgJsonrpcObject
+//           +-----------------------------+
+
+// Request and response are sent in text frames over one persistent
+// connection. Server can push notifications (request without "id") at any
+// time, e.g. aria2 sends "aria2.onDownloadComplete". They are parsed and
+// appended to UgJsonrpcWebsocket.notifications while waiting for response or
+// in ug_jsonrpc_websocket_wait().
+// Only "ws://" is supported, "wss://" (TLS) is not.
+
+#define UG_JSONRPC_WEBSOCKET_TIMEOUT          30000   // milliseconds
+#define UG_JSONRPC_WEBSOCKET_CONNECT_TIMEOUT  3000   // milliseconds, connect and handshake
+
+struct  UgJsonrpcWebsocket
+{
+	UgJson           json;
+	UgJsonrpc        rpc;
+	UgBuffer         buffer;
+	int              socket;
+
+	UgBuffer         input;      // data from socket, it may have partial frame
+	UgBuffer         message;    // payload of fragmented text frames
+	uint32_t         mask_seed;
+
+	// notifications from server.
+	// Caller must free objects by ug_jsonrpc_object_free() and reset length.
+	UgJson           notify_json;
+	UgJsonrpcArray   notifications;
+};
+
+void  ug_jsonrpc_websocket_init (UgJsonrpcWebsocket* jrws);
+void  ug_jsonrpc_websocket_final (UgJsonrpcWebsocket* jrws);
+
+// uri: "ws://host:port/path" or "http://host:port/path"
+// return TRUE if opening handshake succeeded.
+int   ug_jsonrpc_websocket_connect (UgJsonrpcWebsocket* jrws, const char* uri);
+void  ug_jsonrpc_websocket_close (UgJsonrpcWebsocket* jrws);
+
+int   ug_jsonrpc_websocket_send (UgJsonrpcWebsocket* jrws);
+int   ug_jsonrpc_websocket_receive (UgJsonrpcWebsocket* jrws);
+
+// wait notifications for 'milliseconds' and read all arrived messages.
+// return number of notifications, return -1 if connection was closed.
+int   ug_jsonrpc_websocket_wait (UgJsonrpcWebsocket* jrws, int milliseconds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UG_JSONRPC_WEBSOCKET_H
@@ -0,0 +1,213 @@
+/*
+ *
+ *   Copyright (C) 2012-2020 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#include <UgDefine.h>
+#include <UgSlab.h>
+#include <UgRankTree.h>
+
+#define RANK_SIZE(rnode)    ((rnode) ? (rnode)->size : 0)
+
+static void  rank_node_update (UgRankNode* rnode)
+{
+	rnode->size = 1 + RANK_SIZE (rnode->left) + RANK_SIZE (rnode->right);
+	if (rnode->left)
+		rnode->left->parent = rnode;
+	if (rnode->right)
+		rnode->right->parent = rnode;
+}
+
+// all nodes in 'left' are in front of nodes in 'right'
+static UgRankNode* rank_merge (UgRankNode* left, UgRankNode* right)
+{
+	if (left == NULL)
+		return right;
+	if (right == NULL)
+		return left;
+
+	if (left->priority > right->priority) {
+		left->right = rank_merge (left->right, right);
+		rank_node_update (left);
+		return left;
+	}
+	else {
+		right->left = rank_merge (left, right->left);
+		rank_node_update (right);
+		return right;
+	}
+}
+
+// move first 'n' nodes to 'left', others to 'right'
+static void  rank_split (UgRankNode* rnode, int n,
+                         UgRankNode** left, UgRankNode** right)
+{
+	if (rnode == NULL) {
+		*left  = NULL;
+		*right = NULL;
+		return;
+	}
+
+	if (RANK_SIZE (rnode->left) < n) {
+		rank_split (rnode->right, n - RANK_SIZE (rnode->left) - 1,
+		            &rnode->right, right);
+		rank_node_update (rnode);
+		*left = rnode;
+	}
+	else {
+		rank_split (rnode->left, n, left, &rnode->left);
+		rank_node_update (rnode);
+		*right = rnode;
+	}
+}
+
+static void  rank_node_free_all (UgRankNode* rnode)
+{
+	if (rnode) {
+		rank_node_free_all (rnode->left);
+		rank_node_free_all (rnode->right);
+		ug_slab_free (sizeof (UgRankNode), rnode);
+	}
+}
+
+// ----------------------------------------------------------------------------
+// UgRankTree
+
+void  ug_rank_tree_init (UgRankTree* tree)
+{
+	tree->root = NULL;
+	tree->seed = 2463534242u;
+}
+
+void  ug_rank_tree_clear (UgRankTree* tree)
+{
+	rank_node_free_all (tree->root);
+	tree->root = NULL;
+}
+
+UgRankNode* ug_rank_tree_insert (UgRankTree* tree, UgRankNode* sibling, void* data)
+{
+	if (sibling)
+		return ug_rank_tree_insert_at (tree, ug_rank_node_position (sibling), data);
+	else
+		return ug_rank_tree_insert_at (tree, -1, data);
+}
+
+UgRankNode* ug_rank_tree_insert_at (UgRankTree* tree, int position, void* data)
+{
+	UgRankNode*  rnode;
+	UgRankNode*  left;
+	UgRankNode*  right;
+
+	// xorshift32
+	tree->seed ^= tree->seed << 13;
+	tree->seed ^= tree->seed >> 17;
+	tree->seed ^= tree->seed << 5;
+
+	rnode = ug_slab_alloc (sizeof (UgRankNode));
+	rnode->parent = NULL;
+	rnode->left   = NULL;
+	rnode->right  = NULL;
+	rnode->size   = 1;
+	rnode->priority = tree->seed;
+	rnode->data   = data;
+
+	if (position < 0 || position >= ug_rank_tree_length (tree))
+		tree->root = rank_merge (tree->root, rnode);
+	else {
+		rank_split (tree->root, position, &left, &right);
+		tree->root = rank_merge (rank_merge (left, rnode), right);
+	}
+	tree->root->parent = NULL;
+	return rnode;
+}
+
+void* ug_rank_tree_remove (UgRankTree* tree, UgRankNode* rnode)
+{
+	UgRankNode*  parent;
+	UgRankNode*  merged;
+	void*        data;
+
+	// replace 'rnode' by merging it's children
+	parent = rnode->parent;
+	merged = rank_merge (rnode->left, rnode->right);
+	if (parent == NULL)
+		tree->root = merged;
+	else if (parent->left == rnode)
+		parent->left = merged;
+	else
+		parent->right = merged;
+	if (merged)
+		merged->parent = parent;
+	// update size of ancestors
+	for (;  parent;  parent = parent->parent)
+		parent->size--;
+
+	data = rnode->data;
+	ug_slab_free (sizeof (UgRankNode), rnode);
+	return data;
+}
+
+UgRankNode* ug_rank_tree_nth (UgRankTree* tree, int nth)
+{
+	UgRankNode*  rnode;
+	int          size;
+
+	if (nth < 0)
+		return NULL;
+	for (rnode = tree->root;  rnode;  ) {
+		size = RANK_SIZE (rnode->left);
+		if (nth < size)
+			rnode = rnode->left;
+		else if (nth == size)
+			return rnode;
+		else {
+			nth -= size + 1;
+			rnode = rnode->right;
+		}
+	}
+	return NULL;
+}
+
+int   ug_rank_node_position (UgRankNode* rnode)
+{
+	int  position;
+
+	position = RANK_SIZE (rnode->left);
+	for (;  rnode->parent;  rnode = rnode->parent) {
+		if (rnode->parent->right == rnode)
+			position += RANK_SIZE (rnode->parent->left) + 1;
+	}
+	return position;
+}
@@ -0,0 +1,94 @@
+/*
+ *
+ *   Copyright (C) 2012-2020 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#ifndef UG_RANK_TREE_H
+#define UG_RANK_TREE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct UgRankTree    UgRankTree;
+typedef struct UgRankNode    UgRankNode;
+
+/* ----------------------------------------------------------------------------
+   UgRankTree: order-statistic tree (randomized treap ordered by position).
+
+   It keeps a sequence of pointers. Getting nth element, getting position of
+   element, inserting and removing element are O(log n). UgRankNode is
+   stable until it is removed, user can keep it to find position later.
+
+   e.g. GListModel can use it to map row to UgetNode and UgetNode to row.
+ */
+
+struct UgRankNode
+{
+	UgRankNode*   parent;
+	UgRankNode*   left;
+	UgRankNode*   right;
+	int           size;      // number of nodes in this subtree
+	unsigned int  priority;
+
+	void*         data;
+};
+
+struct UgRankTree
+{
+	UgRankNode*   root;
+	unsigned int  seed;      // random number for priority
+};
+
+void  ug_rank_tree_init  (UgRankTree* tree);
+void  ug_rank_tree_clear (UgRankTree* tree);
+
+#define ug_rank_tree_length(tree)    ((tree)->root ? (tree)->root->size : 0)
+
+// insert data before 'sibling'. If 'sibling' is NULL, append data.
+UgRankNode* ug_rank_tree_insert (UgRankTree* tree, UgRankNode* sibling, void* data);
+// insert data at 'position'. If 'position' is -1 or too large, append data.
+UgRankNode* ug_rank_tree_insert_at (UgRankTree* tree, int position, void* data);
+// remove and free 'rnode'. It return data of 'rnode'.
+void*       ug_rank_tree_remove (UgRankTree* tree, UgRankNode* rnode);
+
+// return NULL if 'nth' is out of range.
+UgRankNode* ug_rank_tree_nth (UgRankTree* tree, int nth);
+int         ug_rank_node_position (UgRankNode* rnode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UG_RANK_TREE_H
@@ -0,0 +1,224 @@
+/*
+ *
+ *   Copyright (C) 2012-2020 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <UgDefine.h>
+#include <UgSlab.h>
+
+#if defined _WIN32 || defined _WIN64
+#include <malloc.h>    // _aligned_malloc(), _aligned_free()
+#endif
+
+#define UG_SLAB_ALIGN         16
+#define UG_SLAB_CHUNK_SIZE    (64 * 1024)
+#define UG_SLAB_N_CLASSES     (UG_SLAB_MAX_SIZE / UG_SLAB_ALIGN)
+
+typedef struct UgSlabChunk    UgSlabChunk;
+typedef struct UgSlabClass    UgSlabClass;
+
+// chunk header. It is at the beginning of chunk that aligned to
+// UG_SLAB_CHUNK_SIZE, so object can find it's chunk by masking address.
+struct UgSlabChunk
+{
+	UgSlabChunk*  next;     // chunks that have free space
+	UgSlabChunk*  prev;
+	void*         freed;    // free list of objects in this chunk
+	char*         cur;      // unused space
+	char*         end;
+	int           n_used;   // number of allocated objects
+	int           is_listed;
+};
+
+struct UgSlabClass
+{
+	atomic_int    lock;     // spin lock, zero-initialized is unlocked
+	UgSlabChunk*  chunks;   // chunks that have free space
+};
+
+static UgSlabClass  slab_classes[UG_SLAB_N_CLASSES];
+
+static void  slab_lock (UgSlabClass* sclass)
+{
+	while (atomic_exchange_explicit (&sclass->lock, 1, memory_order_acquire))
+		continue;
+}
+
+static void  slab_unlock (UgSlabClass* sclass)
+{
+	atomic_store_explicit (&sclass->lock, 0, memory_order_release);
+}
+
+static UgSlabChunk* slab_chunk_new (int object_size)
+{
+	UgSlabChunk*  chunk;
+
+#if defined _WIN32 || defined _WIN64
+	chunk = _aligned_malloc (UG_SLAB_CHUNK_SIZE, UG_SLAB_CHUNK_SIZE);
+	if (chunk == NULL)
+		return NULL;
+#else
+	if (posix_memalign ((void**) &chunk, UG_SLAB_CHUNK_SIZE, UG_SLAB_CHUNK_SIZE) != 0)
+		return NULL;
+#endif
+	chunk->next = NULL;
+	chunk->prev = NULL;
+	chunk->freed = NULL;
+	chunk->cur = (char*) chunk + ((sizeof (UgSlabChunk) + UG_SLAB_ALIGN - 1) & ~(UG_SLAB_ALIGN - 1));
+	chunk->end = (char*) chunk + UG_SLAB_CHUNK_SIZE - object_size + 1;
+	chunk->n_used = 0;
+	chunk->is_listed = FALSE;
+	return chunk;
+}
+
+static void  slab_chunk_free (UgSlabChunk* chunk)
+{
+#if defined _WIN32 || defined _WIN64
+	_aligned_free (chunk);
+#else
+	free (chunk);
+#endif
+}
+
+static void  slab_link (UgSlabClass* sclass, UgSlabChunk* chunk)
+{
+	chunk->prev = NULL;
+	chunk->next = sclass->chunks;
+	if (sclass->chunks)
+		sclass->chunks->prev = chunk;
+	sclass->chunks = chunk;
+	chunk->is_listed = TRUE;
+}
+
+static void  slab_unlink (UgSlabClass* sclass, UgSlabChunk* chunk)
+{
+	if (chunk->prev)
+		chunk->prev->next = chunk->next;
+	else
+		sclass->chunks = chunk->next;
+	if (chunk->next)
+		chunk->next->prev = chunk->prev;
+	chunk->next = NULL;
+	chunk->prev = NULL;
+	chunk->is_listed = FALSE;
+}
+
+void*  ug_slab_alloc (size_t size)
+{
+	UgSlabClass*  sclass;
+	UgSlabChunk*  chunk;
+	void*         mem;
+	int           object_size;
+
+	if (size > UG_SLAB_MAX_SIZE)
+		return ug_malloc (size);
+	if (size == 0)
+		size = 1;
+	sclass = slab_classes + (size - 1) / UG_SLAB_ALIGN;
+	object_size = (int) ((size + UG_SLAB_ALIGN - 1) & ~(UG_SLAB_ALIGN - 1));
+
+	slab_lock (sclass);
+	chunk = sclass->chunks;
+	if (chunk == NULL) {
+		chunk = slab_chunk_new (object_size);
+		if (chunk == NULL) {
+			slab_unlock (sclass);
+			return NULL;
+		}
+		slab_link (sclass, chunk);
+	}
+
+	if (chunk->freed) {
+		mem = chunk->freed;
+		chunk->freed = *(void**) mem;
+	}
+	else {
+		mem = chunk->cur;
+		chunk->cur += object_size;
+	}
+	chunk->n_used++;
+	// chunk is full
+	if (chunk->freed == NULL && chunk->cur >= chunk->end)
+		slab_unlink (sclass, chunk);
+	slab_unlock (sclass);
+	return mem;
+}
+
+void*  ug_slab_alloc0 (size_t size)
+{
+	void*  mem;
+
+	mem = ug_slab_alloc (size);
+	if (mem)
+		memset (mem, 0, size);
+	return mem;
+}
+
+void   ug_slab_free (size_t size, void* mem)
+{
+	UgSlabClass*  sclass;
+	UgSlabChunk*  chunk;
+	UgSlabChunk*  released = NULL;
+
+	if (mem == NULL)
+		return;
+	if (size > UG_SLAB_MAX_SIZE) {
+		ug_free (mem);
+		return;
+	}
+	if (size == 0)
+		size = 1;
+	sclass = slab_classes + (size - 1) / UG_SLAB_ALIGN;
+	chunk = (UgSlabChunk*) ((uintptr_t) mem & ~((uintptr_t) UG_SLAB_CHUNK_SIZE - 1));
+
+	slab_lock (sclass);
+	*(void**) mem = chunk->freed;
+	chunk->freed = mem;
+	chunk->n_used--;
+	if (chunk->is_listed == FALSE)
+		slab_link (sclass, chunk);
+	// release empty chunk if it is not the only one
+	else if (chunk->n_used == 0 && (chunk->prev || chunk->next)) {
+		slab_unlink (sclass, chunk);
+		released = chunk;
+	}
+	slab_unlock (sclass);
+
+	if (released)
+		slab_chunk_free (released);
+}
+
@@ -0,0 +1,69 @@
+/*
+ *
+ *   Copyright (C) 2012-2020 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  In addition, as a special exception, the copyright holders give
+ *  permission to link the code of portions of this program with the
+ *  OpenSSL library under certain conditions as described in each
+ *  individual source file, and distribute linked combinations
+ *  including the two.
+ *  You must obey the GNU Lesser General Public License in all respects
+ *  for all of the code used other than OpenSSL.  If you modify
+ *  file(s) with this exception, you may extend this exception to your
+ *  version of the file(s), but you are not obligated to do so.  If you
+ *  do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source
+ *  files in the program, then also delete it here.
+ *
+ */
+
+#ifndef UG_SLAB_H
+#define UG_SLAB_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------------------
+   UgSlab: allocator for small fixed-size objects (UgInfo, UgData, UgetNode...)
+
+   Objects are carved from 64 KiB chunks, one group of chunks per size class.
+   Freed objects go back to their own chunk. When all objects in a chunk have
+   been freed, the chunk is released, so deleting a large category gives its
+   memory back in bulk. All functions are thread-safe.
+
+   Like g_slice_free1(), caller must pass the same size to ug_slab_free().
+   Objects larger than UG_SLAB_MAX_SIZE are allocated by ug_malloc().
+ */
+
+#define UG_SLAB_MAX_SIZE      512
+
+void*  ug_slab_alloc  (size_t size);
+void*  ug_slab_alloc0 (size_t size);
+void   ug_slab_free   (size_t size, void* mem);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UG_SLAB_H
+
@@ -36,9 +36,11 @@
 
 #define _XOPEN_SOURCE 700
 #include <string.h>
+#include <errno.h>
 #include <UgDefine.h>
 #include <UgThread.h>
 #include <UgStdio.h>
+#include <UgUtil.h>
 #include <UgSocket.h>
 
 #if defined _WIN32 || defined _WIN64
@@ -53,6 +55,14 @@
 #define  ug_sleep(millisecond)    usleep (millisecond * 1000)
 #endif // _WIN32 || _WIN64
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#define  SERVER_N_EVENTS        64
+#endif
+
+// server thread check UgSocketServer.stopping every 1 second
+#define  SERVER_CHECK_INTERVAL  1000
+
 int  ug_socket_connect (SOCKET fd, const char* addr, const char* port_or_serv)
 {
 	struct addrinfo  hints;
@@ -97,6 +107,61 @@ int  ug_socket_connect (SOCKET fd, const char* addr, const char* port_or_serv)
 	return fd;
 }
 
+SOCKET  ug_socket_connect_timeout (const char* addr, const char* port_or_serv,
+                                   int milliseconds)
+{
+	struct addrinfo  hints;
+	struct addrinfo* result;
+	struct addrinfo* cur;
+	struct timeval   timeout;
+	fd_set     write_fds;
+	socklen_t  len;
+	SOCKET     fd;
+	int        error;
+
+	memset (&hints, 0, sizeof (hints));
+	hints.ai_socktype = SOCK_STREAM;
+	if (getaddrinfo (addr, port_or_serv, &hints, &result) != 0)
+		return INVALID_SOCKET;
+
+	fd = INVALID_SOCKET;
+	for (cur = result;  cur;  cur = cur->ai_next) {
+		fd = socket (cur->ai_family, cur->ai_socktype, cur->ai_protocol);
+		if (fd == INVALID_SOCKET)
+			continue;
+		// non-blocking connect() and wait it by select()
+		ug_socket_set_blocking (fd, FALSE);
+		error = 0;
+		if (connect (fd, cur->ai_addr, cur->ai_addrlen) == SOCKET_ERROR) {
+#if defined _WIN32 || defined _WIN64
+			error = (WSAGetLastError () == WSAEWOULDBLOCK) ? 0 : -1;
+#else
+			error = (errno == EINPROGRESS) ? 0 : -1;
+#endif
+			if (error == 0) {
+				FD_ZERO (&write_fds);
+				FD_SET (fd, &write_fds);
+				timeout.tv_sec  = milliseconds / 1000;
+				timeout.tv_usec = (milliseconds % 1000) * 1000;
+				if (select (fd + 1, NULL, &write_fds, NULL, &timeout) <= 0)
+					error = -1;
+				else {
+					len = sizeof (error);
+					if (getsockopt (fd, SOL_SOCKET, SO_ERROR, (char*) &error, &len) == -1)
+						error = -1;
+				}
+			}
+		}
+		if (error == 0 && ug_socket_set_blocking (fd, TRUE))
+			break;
+		closesocket (fd);
+		fd = INVALID_SOCKET;
+	}
+
+	freeaddrinfo (result);    // free result from getaddrinfo()
+	return fd;
+}
+
 #if !(defined _WIN32 || defined _WIN64)
 int  ug_socket_connect_unix (SOCKET fd, const char* path, int path_len)
 {
@@ -254,6 +319,10 @@ UgSocketServer* ug_socket_server_new (SOCKET server_fd)
 	server->stopped = TRUE;
 	server->stopping = FALSE;
 	server->client_addr_len = sizeof (server->client_addr);
+	server->watches = NULL;
+#ifdef __linux__
+	server->epoll_fd = -1;
+#endif
 	return server;
 }
 
@@ -349,37 +418,269 @@ void  ug_socket_server_stop (UgSocketServer* server)
 	}
 }
 
-static UgThreadResult server_thread (UgSocketServer* server)
+#ifdef __linux__
+// return -1 if epoll_ctl() failed.
+static int  server_epoll_ctl (UgSocketServer* server, UgSocketWatch* watch, int op)
+{
+	struct epoll_event  event;
+
+	event.events = 0;
+	if (watch->events & UG_SOCKET_READ)
+		event.events |= EPOLLIN;
+	if (watch->events & UG_SOCKET_WRITE)
+		event.events |= EPOLLOUT;
+	event.data.ptr = watch;
+	return epoll_ctl (server->epoll_fd, op, watch->socket, &event);
+}
+
+// server thread use select() after epoll was closed.
+static void  server_epoll_close (UgSocketServer* server)
+{
+	if (server->epoll_fd != -1) {
+		close (server->epoll_fd);
+		server->epoll_fd = -1;
+	}
+}
+#endif
+
+void  ug_socket_server_watch (UgSocketServer* server, UgSocketWatch* watch)
+{
+#ifdef __linux__
+	int  op;
+
+	// timer doesn't have socket.
+	// If server thread has not created epoll, it will add this watch later.
+	if (server->epoll_fd != -1 && watch->socket != INVALID_SOCKET) {
+		op = (watch->server) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+		if (server_epoll_ctl (server, watch, op) == -1)
+			server_epoll_close (server);
+	}
+#endif
+
+	if (watch->server == NULL) {
+		watch->server = server;
+		watch->prev = NULL;
+		watch->next = server->watches;
+		if (server->watches)
+			server->watches->prev = watch;
+		server->watches = watch;
+	}
+	if (watch->timeout > 0)
+		watch->deadline = ug_get_time_count () + watch->timeout;
+}
+
+void  ug_socket_server_unwatch (UgSocketServer* server, UgSocketWatch* watch)
+{
+	if (watch->server != server)
+		return;
+#ifdef __linux__
+	// socket may be closed already, error can be ignored.
+	if (server->epoll_fd != -1 && watch->socket != INVALID_SOCKET)
+		epoll_ctl (server->epoll_fd, EPOLL_CTL_DEL, watch->socket, NULL);
+#endif
+	if (watch->next)
+		watch->next->prev = watch->prev;
+	if (watch->prev)
+		watch->prev->next = watch->next;
+	else
+		server->watches = watch->next;
+	watch->server = NULL;
+	watch->next = NULL;
+	watch->prev = NULL;
+}
+
+static void server_accept (UgSocketServer* server)
 {
-	struct    timeval  timeout;
 	int       client_fd;
-	int       result;
 
-	while (server->stopping == FALSE) {
-		// reset fd_set and timeout because select() will change them.
-		FD_ZERO (&server->read_fds);
-		FD_SET (server->socket, &server->read_fds);
-		timeout.tv_sec = 1;
-		timeout.tv_usec = 0;
-		// select() will change fd_set and timeout (reduce timeout to 0)
-		result = select (server->socket + 1, &server->read_fds,
-		        NULL, NULL, &timeout);
-		// exit thread if user stop server
-		if (server->stopping || result < 0)
-			break;
-		// select() time limit expired if result == 0
-		if (result == 0) {
-//			ug_sleep (200);
+	server->client_addr_len = sizeof (server->client_addr);
+	client_fd = accept (server->socket,
+			(struct sockaddr *) &server->client_addr,
+			&server->client_addr_len);
+	if (client_fd == INVALID_SOCKET)
+		return;
+
+	server->receiver.func (server, client_fd,
+	                       server->receiver.data);
+}
+
+static void server_notify (UgSocketWatch* watch, int events)
+{
+	// socket is active, restart time limit.
+	if (watch->timeout > 0)
+		watch->deadline = ug_get_time_count () + watch->timeout;
+	watch->func (watch, events);
+}
+
+// return milliseconds until the nearest deadline, but not more than
+// SERVER_CHECK_INTERVAL. It also remove expired watches and notify them.
+static int  server_expire (UgSocketServer* server)
+{
+	UgSocketWatch*  watch;
+	UgSocketWatch*  next;
+	uint64_t        now;
+	int             interval;
+
+	interval = SERVER_CHECK_INTERVAL;
+	now = ug_get_time_count ();
+	for (watch = server->watches;  watch;  watch = next) {
+		next = watch->next;
+		if (watch->timeout <= 0)
 			continue;
+		if (watch->deadline <= now) {
+			ug_socket_server_unwatch (server, watch);
+			watch->func (watch, UG_SOCKET_TIMEOUT);
 		}
+		else if (watch->deadline - now < (uint64_t) interval)
+			interval = (int) (watch->deadline - now);
+	}
+	return interval;
+}
+
+#ifdef __linux__
+static int  server_wait_epoll (UgSocketServer* server, int timeout)
+{
+	struct epoll_event  events[SERVER_N_EVENTS];
+	UgSocketWatch*      watch;
+	int                 flags;
+	int                 index;
+	int                 result;
+
+	result = epoll_wait (server->epoll_fd, events, SERVER_N_EVENTS, timeout);
+	if (result < 0)
+		return (errno == EINTR) ? 0 : -1;
+	// exit thread if user stop server
+	if (server->stopping)
+		return -1;
+
+	for (index = 0;  index < result;  index++) {
+		watch = events[index].data.ptr;
+		if (watch == NULL) {
+			server_accept (server);
+			continue;
+		}
+		flags = 0;
+		// let UgSocketWatch.func get error from recv()
+		if (events[index].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+			flags |= UG_SOCKET_READ;
+		if (events[index].events & EPOLLOUT)
+			flags |= UG_SOCKET_WRITE;
+		server_notify (watch, flags & (watch->events | UG_SOCKET_READ));
+	}
+	return result;
+}
+#endif // __linux__
+
+static int  server_wait_select (UgSocketServer* server, int timeout)
+{
+	struct timeval  tv;
+	UgSocketWatch*  watch;
+	UgSocketWatch*  next;
+	SOCKET          max_fd;
+	int             flags;
+	int             result;
+
+	// reset fd_set and timeout because select() will change them.
+	FD_ZERO (&server->read_fds);
+	FD_ZERO (&server->write_fds);
+	FD_SET (server->socket, &server->read_fds);
+	max_fd = server->socket;
+	for (watch = server->watches;  watch;  watch = watch->next) {
+		if (watch->socket == INVALID_SOCKET)
+			continue;
+#if !(defined _WIN32 || defined _WIN64)
+		if (watch->socket >= FD_SETSIZE)
+			continue;
+#endif
+		if (watch->events & UG_SOCKET_READ)
+			FD_SET (watch->socket, &server->read_fds);
+		if (watch->events & UG_SOCKET_WRITE)
+			FD_SET (watch->socket, &server->write_fds);
+		if (max_fd < watch->socket)
+			max_fd = watch->socket;
+	}
+	tv.tv_sec = timeout / 1000;
+	tv.tv_usec = (timeout % 1000) * 1000;
+	// select() will change fd_set and timeout (reduce timeout to 0)
+	result = select (max_fd + 1, &server->read_fds,
+	                 &server->write_fds, NULL, &tv);
+	// exit thread if user stop server
+	if (server->stopping || result < 0)
+		return -1;
+	// select() time limit expired if result == 0
+	if (result == 0)
+		return 0;
+
+	// new watches are added to head of list, they are not in fd_set.
+	for (watch = server->watches;  watch;  watch = next) {
+		next = watch->next;
+		if (watch->socket == INVALID_SOCKET)
+			continue;
+#if !(defined _WIN32 || defined _WIN64)
+		if (watch->socket >= FD_SETSIZE)
+			continue;
+#endif
+		flags = 0;
+		if (FD_ISSET (watch->socket, &server->read_fds))
+			flags |= UG_SOCKET_READ;
+		if (FD_ISSET (watch->socket, &server->write_fds))
+			flags |= UG_SOCKET_WRITE;
+		if (flags)
+			server_notify (watch, flags);
+	}
+	if (FD_ISSET (server->socket, &server->read_fds))
+		server_accept (server);
+	return result;
+}
 
-		client_fd = accept (server->socket,
-				(struct sockaddr *) &server->client_addr,
-				&server->client_addr_len);
+static int  server_wait (UgSocketServer* server, int timeout)
+{
+#ifdef __linux__
+	if (server->epoll_fd != -1)
+		return server_wait_epoll (server, timeout);
+#endif
+	return server_wait_select (server, timeout);
+}
 
-		server->receiver.func (server, client_fd,
-		                       server->receiver.data);
+static UgThreadResult server_thread (UgSocketServer* server)
+{
+	UgSocketWatch*  watch;
+	int             timeout;
+
+#ifdef __linux__
+	struct epoll_event  event;
+
+	// use select() if epoll can't be used.
+	server->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+	if (server->epoll_fd != -1) {
+		event.events = EPOLLIN;
+		event.data.ptr = NULL;    // NULL for server socket
+		if (epoll_ctl (server->epoll_fd, EPOLL_CTL_ADD, server->socket, &event) == -1)
+			server_epoll_close (server);
+	}
+	// watches that were added before epoll was created.
+	for (watch = server->watches;  watch && server->epoll_fd != -1;  watch = watch->next) {
+		if (watch->socket == INVALID_SOCKET)
+			continue;
+		if (server_epoll_ctl (server, watch, EPOLL_CTL_ADD) == -1)
+			server_epoll_close (server);
 	}
+#endif
+
+	while (server->stopping == FALSE) {
+		timeout = server_expire (server);
+		if (server_wait (server, timeout) < 0)
+			break;
+	}
+
+	// notify remaining watches that server has been stopped
+	while ((watch = server->watches) != NULL) {
+		ug_socket_server_unwatch (server, watch);
+		watch->func (watch, UG_SOCKET_TIMEOUT | UG_SOCKET_STOPPED);
+	}
+#ifdef __linux__
+	server_epoll_close (server);
+#endif
 
 	server->stopping = FALSE;
 	server->stopped = TRUE;
@@ -89,6 +89,12 @@ extern "C" {
 // return SOCKET_ERROR(-1) if error occurred.
 int  ug_socket_connect (SOCKET fd, const char* addr, const char* port_or_serv);
 
+// IPv4 or IPv6. create SOCK_STREAM socket by family of resolved address and
+// connect it. wait 'milliseconds' for each address.
+// return INVALID_SOCKET if error occurred or timed out.
+SOCKET  ug_socket_connect_timeout (const char* addr, const char* port_or_serv,
+                                   int milliseconds);
+
 #if !(defined _WIN32 || defined _WIN64)
 // UNIX Domain Socket
 int  ug_socket_connect_unix (SOCKET fd, const char* path, int path_len);
@@ -134,6 +140,7 @@ int  ug_socket_listen_unix (SOCKET fd, const char* path, int path_len, int backl
  */
 
 typedef struct UgSocketServer       UgSocketServer;
+typedef struct UgSocketWatch        UgSocketWatch;
 typedef void (*UgSocketServerFunc) (UgSocketServer* server,
                                     SOCKET client_socket,
                                     void*  data);
@@ -146,6 +153,13 @@ struct UgSocketServer {
 
 	SOCKET    socket;
 	fd_set    read_fds;
+	fd_set    write_fds;
+
+	// client sockets watched by server thread
+	UgSocketWatch*  watches;
+#ifdef __linux__
+	int             epoll_fd;
+#endif
 
 	// client address used by accept()
 	socklen_t client_addr_len;
@@ -200,6 +214,81 @@ void  ug_socket_server_set_receiver (UgSocketServer* server,
 int   ug_socket_server_start (UgSocketServer* server);
 void  ug_socket_server_stop (UgSocketServer* server);
 
+// ------------------------------------
+// UgSocketWatch
+
+/*
+	Server thread can handle many non-blocking client sockets at the same
+	time. It uses epoll() on Linux and select() on other platforms or if epoll
+	failed.
+	Call ug_socket_server_watch() in UgSocketServerFunc to add client socket,
+	server thread call UgSocketWatch.func when socket is ready.
+
+	// sample code:
+	static void on_ready (UgSocketWatch* watch, int events)
+	{
+		if (events & UG_SOCKET_TIMEOUT) {
+			// watch has been removed from server.
+			closesocket (watch->socket);
+			ug_free (watch);
+			return;
+		}
+		if (events & UG_SOCKET_READ)
+			recv (watch->socket, ...);
+	}
+
+	static void on_accepted (UgSocketServer* server, SOCKET client_fd, void* data)
+	{
+		UgSocketWatch* watch;
+
+		ug_socket_set_blocking (client_fd, FALSE);
+		watch = ug_malloc0 (sizeof (UgSocketWatch));
+		watch->socket = client_fd;
+		watch->events = UG_SOCKET_READ;
+		watch->timeout = 10000;
+		watch->func = on_ready;
+		ug_socket_server_watch (server, watch);
+	}
+
+	If UgSocketWatch.socket is INVALID_SOCKET, watch is a timer. Server thread
+	call UgSocketWatch.func with UG_SOCKET_TIMEOUT after UgSocketWatch.timeout.
+	Call ug_socket_server_watch() again in UgSocketWatch.func to repeat it
+	unless UG_SOCKET_STOPPED is set.
+ */
+
+typedef void (*UgSocketWatchFunc) (UgSocketWatch* watch, int events);
+
+enum UgSocketEvent {
+	UG_SOCKET_READ    = 1,
+	UG_SOCKET_WRITE   = 2,
+	// UgSocketWatch.timeout expired or server stopped.
+	// watch has been removed from server before calling UgSocketWatch.func
+	UG_SOCKET_TIMEOUT = 4,
+	// server stopped, it is set with UG_SOCKET_TIMEOUT.
+	UG_SOCKET_STOPPED = 8,
+};
+
+struct UgSocketWatch {
+	SOCKET          socket;     // INVALID_SOCKET for timer
+	int             events;     // UG_SOCKET_READ | UG_SOCKET_WRITE
+	int             timeout;    // milliseconds, 0 = no time limit
+	uint64_t        deadline;   // set by server thread
+
+	UgSocketWatchFunc  func;
+	void*              data;
+
+	// set by ug_socket_server_watch()
+	UgSocketServer* server;
+	UgSocketWatch*  next;
+	UgSocketWatch*  prev;
+};
+
+// These functions must be called in server thread.
+// If 'watch' has been watched, ug_socket_server_watch() apply new 'events'
+// and restart time limit.
+void  ug_socket_server_watch (UgSocketServer* server, UgSocketWatch* watch);
+void  ug_socket_server_unwatch (UgSocketServer* server, UgSocketWatch* watch);
+
 
 #ifdef __cplusplus
 }
@@ -180,6 +180,7 @@ int  ug_truncate (int fd, int64_t length);
 #  define  ug_read      _read
 #  define  ug_write     _write
 #  define  ug_sync      _commit
+#  define  ug_sync_data _commit
 #  define  ug_seek      _lseeki64   // for MS VC
 #  define  ug_tell      _telli64    // for MS VC
 #else
@@ -187,6 +188,11 @@ int  ug_truncate (int fd, int64_t length);
 #  define  ug_read      read
 #  define  ug_write     write
 #  define  ug_sync      fsync
+#  if defined __APPLE__
+#    define  ug_sync_data fsync       // macOS doesn't declare fdatasync()
+#  else
+#    define  ug_sync_data fdatasync   // don't flush metadata (e.g. mtime)
+#  endif
 #  if defined __ANDROID__
 #    define  ug_seek      lseek64
 #    define  ug_tell(fd)  lseek64(fd, 0L, SEEK_CUR)
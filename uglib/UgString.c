@@ -41,6 +41,8 @@
 #include <stdio.h>  // vsnprintf
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stddef.h>     // offsetof
+#include <stdatomic.h>
 #include <UgString.h>
 
 // ----------------------------------------------------------------------------
@@ -329,6 +331,145 @@ time_t  ug_str_rfc3339_to_time (const char* string)
 	return mktime (&timem);
 }
 
+// ----------------------------------------------------------------------------
+// string interning
+
+typedef struct UgInternNode    UgInternNode;
+
+struct UgInternNode
+{
+	UgInternNode*  next;
+	unsigned int   hash;
+	int            ref_count;
+	char           string[1];
+};
+
+static struct
+{
+	atomic_int      lock;     // spin lock, zero-initialized is unlocked
+	UgInternNode**  buckets;
+	unsigned int    n_buckets;
+	unsigned int    n_nodes;
+} intern_table;
+
+#define UG_INTERN_NODE(interned)   \
+		((UgInternNode*) ((char*)(interned) - offsetof(UgInternNode, string)))
+
+static void  intern_lock (void)
+{
+	while (atomic_exchange_explicit (&intern_table.lock, 1, memory_order_acquire))
+		continue;
+}
+
+static void  intern_unlock (void)
+{
+	atomic_store_explicit (&intern_table.lock, 0, memory_order_release);
+}
+
+// FNV-1a
+static unsigned int  intern_hash (const char* string, size_t* length)
+{
+	const unsigned char* cur;
+	unsigned int  hash = 2166136261u;
+
+	for (cur = (const unsigned char*) string;  *cur;  cur++) {
+		hash ^= *cur;
+		hash *= 16777619u;
+	}
+	*length = (const char*) cur - string;
+	return hash;
+}
+
+static void  intern_grow (void)
+{
+	UgInternNode** buckets;
+	UgInternNode*  node;
+	UgInternNode*  next;
+	unsigned int   n_buckets;
+	unsigned int   index;
+
+	n_buckets = (intern_table.n_buckets) ? intern_table.n_buckets * 2 : 64;
+	buckets = ug_malloc0 (sizeof (UgInternNode*) * n_buckets);
+	for (index = 0;  index < intern_table.n_buckets;  index++) {
+		for (node = intern_table.buckets[index];  node;  node = next) {
+			next = node->next;
+			node->next = buckets[node->hash & (n_buckets - 1)];
+			buckets[node->hash & (n_buckets - 1)] = node;
+		}
+	}
+	ug_free (intern_table.buckets);
+	intern_table.buckets = buckets;
+	intern_table.n_buckets = n_buckets;
+}
+
+char*  ug_str_intern (const char* string)
+{
+	UgInternNode*  node;
+	unsigned int   hash;
+	size_t         length;
+
+	if (string == NULL)
+		return NULL;
+	hash = intern_hash (string, &length);
+
+	intern_lock ();
+	if (intern_table.n_nodes >= intern_table.n_buckets)
+		intern_grow ();
+	node = intern_table.buckets[hash & (intern_table.n_buckets - 1)];
+	for (;  node;  node = node->next) {
+		if (node->hash == hash && strcmp (node->string, string) == 0) {
+			node->ref_count++;
+			intern_unlock ();
+			return node->string;
+		}
+	}
+	node = ug_malloc (offsetof (UgInternNode, string) + length + 1);
+	memcpy (node->string, string, length + 1);
+	node->hash = hash;
+	node->ref_count = 1;
+	node->next = intern_table.buckets[hash & (intern_table.n_buckets - 1)];
+	intern_table.buckets[hash & (intern_table.n_buckets - 1)] = node;
+	intern_table.n_nodes++;
+	intern_unlock ();
+	return node->string;
+}
+
+char*  ug_str_intern_ref (char* interned)
+{
+	if (interned) {
+		intern_lock ();
+		UG_INTERN_NODE (interned)->ref_count++;
+		intern_unlock ();
+	}
+	return interned;
+}
+
+void   ug_str_unintern (char* interned)
+{
+	UgInternNode*  node;
+	UgInternNode** link;
+
+	if (interned == NULL)
+		return;
+	node = UG_INTERN_NODE (interned);
+
+	intern_lock ();
+	if (--node->ref_count > 0) {
+		intern_unlock ();
+		return;
+	}
+	link = &intern_table.buckets[node->hash & (intern_table.n_buckets - 1)];
+	for (;  *link;  link = &(*link)->next) {
+		if (*link == node) {
+			*link = node->next;
+			break;
+		}
+	}
+	intern_table.n_nodes--;
+	intern_unlock ();
+	ug_free (node);
+}
+
 // ------------------------------------
 // command-line
 
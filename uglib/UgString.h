@@ -99,6 +99,15 @@ char*  ug_str_from_time (time_t ptt, int date_only);
 time_t  ug_str_rfc822_to_time  (const char* rfc822_string);
 time_t  ug_str_rfc3339_to_time (const char* rfc3339_string);
 
+// ------------------------------------
+// string interning
+// Equal strings share one read-only, reference counted copy, so interned
+// strings can be compared by pointer. Never modify or ug_free() them.
+// ug_str_intern() and ug_str_intern_ref() return NULL if param is NULL.
+char*  ug_str_intern (const char* string);
+char*  ug_str_intern_ref (char* interned);
+void   ug_str_unintern (char* interned);
+
 // ------------------------------------
 // command-line
 char** ug_argv_from_cmd (const char* commandline, int* argc, int reserve_len);
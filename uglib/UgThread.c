@@ -34,6 +34,14 @@
  *
  */
 
+#if defined _WIN32 || defined _WIN64
+// condition variable requires Windows Vista
+#if !defined _WIN32_WINNT || _WIN32_WINNT < 0x0600
+#undef  _WIN32_WINNT
+#define _WIN32_WINNT    0x0600
+#endif
+#endif // _WIN32 || _WIN64
+
 #include <stdlib.h>
 #include <UgDefine.h>
 #include <UgThread.h>
@@ -95,5 +103,57 @@ void  ug_mutex_unlock (UgMutex* mutex)
 	LeaveCriticalSection (*mutex);
 }
 
+void  ug_cond_init (UgCond* cond)
+{
+	*cond = ug_malloc (sizeof (CONDITION_VARIABLE));
+	InitializeConditionVariable (*cond);
+}
+
+void  ug_cond_clear (UgCond* cond)
+{
+	ug_free (*cond);
+}
+
+void  ug_cond_wait (UgCond* cond, UgMutex* mutex)
+{
+	SleepConditionVariableCS (*cond, *mutex, INFINITE);
+}
+
+int   ug_cond_wait_timeout (UgCond* cond, UgMutex* mutex, int milliseconds)
+{
+	return SleepConditionVariableCS (*cond, *mutex, milliseconds) != 0;
+}
+
+void  ug_cond_signal (UgCond* cond)
+{
+	WakeConditionVariable (*cond);
+}
+
+void  ug_cond_broadcast (UgCond* cond)
+{
+	WakeAllConditionVariable (*cond);
+}
+
 #endif // _WIN32 || _WIN64
 
+// ----------------------------------------------------------------------------
+// POSIX thread
+
+#if !(defined _WIN32 || defined _WIN64)
+#include <time.h>
+
+int   ug_cond_wait_timeout (UgCond* cond, UgMutex* mutex, int milliseconds)
+{
+	struct timespec  abstime;
+
+	clock_gettime (CLOCK_REALTIME, &abstime);
+	abstime.tv_sec  += milliseconds / 1000;
+	abstime.tv_nsec += (milliseconds % 1000) * 1000000;
+	if (abstime.tv_nsec >= 1000000000) {
+		abstime.tv_sec++;
+		abstime.tv_nsec -= 1000000000;
+	}
+	return pthread_cond_timedwait (cond, mutex, &abstime) == 0;
+}
+
+#endif // ! (_WIN32 || _WIN64)
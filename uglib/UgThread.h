@@ -48,6 +48,7 @@ extern "C" {
 
 typedef uintptr_t          UgThread;
 typedef void*              UgMutex;
+typedef void*              UgCond;
 typedef unsigned           UgThreadResult;
 
 // This function must return UG_THREAD_RESULT
@@ -68,12 +69,23 @@ void  ug_mutex_clear (UgMutex* mutex);
 void  ug_mutex_lock  (UgMutex* mutex);
 void  ug_mutex_unlock(UgMutex* mutex);
 
+// condition variable ------
+// ug_cond_wait() must be called with locked mutex. It may wake up spuriously.
+void  ug_cond_init     (UgCond* cond);
+void  ug_cond_clear    (UgCond* cond);
+void  ug_cond_wait     (UgCond* cond, UgMutex* mutex);
+// return FALSE if timed out
+int   ug_cond_wait_timeout (UgCond* cond, UgMutex* mutex, int milliseconds);
+void  ug_cond_signal   (UgCond* cond);
+void  ug_cond_broadcast(UgCond* cond);
+
 //#elif defined(HAVE_PTHREAD)
 #else
 #include <pthread.h>
 
 typedef pthread_t          UgThread;
 typedef pthread_mutex_t    UgMutex;
+typedef pthread_cond_t     UgCond;
 typedef void*              UgThreadResult;
 
 // This function must return UG_THREAD_RESULT
@@ -107,6 +119,26 @@ typedef UgThreadResult (*UgThreadFunc)(void*);
 // void ug_mutex_unlock(UgMutex* mutex);
 #define ug_mutex_unlock(mutex)  pthread_mutex_unlock(mutex)
 
+// condition variable ------
+// ug_cond_wait() must be called with locked mutex. It may wake up spuriously.
+// void ug_cond_init(UgCond* cond);
+#define ug_cond_init(cond)      pthread_cond_init(cond, NULL)
+
+// void ug_cond_clear(UgCond* cond);
+#define ug_cond_clear(cond)     pthread_cond_destroy(cond)
+
+// void ug_cond_wait(UgCond* cond, UgMutex* mutex);
+#define ug_cond_wait(cond, mutex)  pthread_cond_wait(cond, mutex)
+
+// return FALSE if timed out
+int   ug_cond_wait_timeout (UgCond* cond, UgMutex* mutex, int milliseconds);
+
+// void ug_cond_signal(UgCond* cond);
+#define ug_cond_signal(cond)    pthread_cond_signal(cond)
+
+// void ug_cond_broadcast(UgCond* cond);
+#define ug_cond_broadcast(cond) pthread_cond_broadcast(cond)
+
 #endif  // _WIN32 || _WIN64
 
 
@@ -47,6 +47,7 @@ int  ug_uri_init (UgUri* upart, const char* uri)
 {
 	const char* cur;
 	const char* tmp;
+	int  is_literal = FALSE;
 
 	// scheme - make sure ':' before '/', '%', '?', and '#'
 #if defined _WIN32 || defined _WIN64
@@ -136,7 +137,10 @@ int  ug_uri_init (UgUri* upart, const char* uri)
 				upart->host = cur - uri + 1;
 				break;
 			}
-			if (cur[0] == ':')
+			// IPv6 address in square brackets, e.g. "[::1]:6800"
+			if (cur[0] == ']')
+				is_literal = TRUE;
+			if (cur[0] == ':' && is_literal == FALSE)
 				upart->port = cur - uri + 1;
 		}
 	}
@@ -35,6 +35,7 @@
  */
 
 #include <UgtkApp.h>
+#include <UgtkNodeObject.h>
 #include <UgtkTrayIcon.h>
 #include <UgtkConfirmDialog.h>
 
@@ -99,7 +100,8 @@ void  ugtk_app_init_callback (UgtkApp* app)
 	// Tray icon callbacks are set up in ugtk_tray_icon_init()
 	// node notification
 	uget_app_set_notification ((UgetApp*) app, app,
-			node_inserted, node_removed, (UgNotifyFunc) node_updated);
+			node_inserted, node_removed, (UgNotifyFunc) node_updated,
+			(UgNotifyFunc) ugtk_node_object_release);
 }
 
 // ----------------------------------------------------------------------------
@@ -115,6 +117,12 @@ static void  on_set_download_runnable (GtkWidget* widget, UgtkApp* app)
 	ugtk_app_queue_download (app, TRUE);
 }
 
+static void  on_search_changed (GtkSearchEntry* entry, UgtkApp* app)
+{
+	ugtk_traveler_search (&app->traveler,
+			gtk_editable_get_text (GTK_EDITABLE (entry)));
+}
+
 // ----------------------------------------------------------------------------
 // UgtkWindow
 
@@ -414,6 +422,9 @@ static void ugtk_toolbar_init_callback (struct UgtkToolbar* toolbar, UgtkApp* ap
 			G_CALLBACK (ugtk_app_move_download_top), app);
 	g_signal_connect_swapped (toolbar->move_bottom, "clicked",
 			G_CALLBACK (ugtk_app_move_download_bottom), app);
+	// search
+	g_signal_connect (toolbar->search, "search-changed",
+			G_CALLBACK (on_search_changed), app);
 }
 
 // ----------------------------------------------------------------------------
@@ -422,51 +433,34 @@ static void ugtk_toolbar_init_callback (struct UgtkToolbar* toolbar, UgtkApp* ap
 static void node_inserted (UgetNode* node, UgetNode* sibling, UgetNode* child)
 {
 	UgtkApp*  app;
-	int       pos;
 
 	app = node->control->notifier->data;
 	if (node == (UgetNode*) app->traveler.category.model->root) {
 		// category inserted
-		pos = uget_node_child_position (node, child) + 1; // +1 for "All Category"
-		g_list_model_items_changed (
-				G_LIST_MODEL (app->traveler.category.model), pos, 0, 1);
+		ugtk_node_tree_inserted (app->traveler.category.model, sibling, child);
 		// sync UgtkMenubar.download.move_to
 		ugtk_menubar_sync_category (&app->menubar, app, TRUE);
 	}
 	else if (node == (UgetNode*) app->traveler.download.model->root) {
 		// download inserted
-		pos = uget_node_child_position (node, child);
-		g_list_model_items_changed (
-				G_LIST_MODEL (app->traveler.download.model), pos, 0, 1);
+		ugtk_node_tree_inserted (app->traveler.download.model, sibling, child);
 	}
 }
 
 static void node_removed (UgetNode* node, UgetNode* sibling, UgetNode* child)
 {
 	UgtkApp*  app;
-	int       pos;
 
 	app = node->control->notifier->data;
 	if (node == (UgetNode*) app->traveler.category.model->root) {
 		// category removed
-		if (sibling)
-			pos = uget_node_child_position (node, sibling);
-		else
-			pos = app->traveler.category.model->root->n_children;
-		pos += 1;  // +1 for "All Category"
-		g_list_model_items_changed (
-				G_LIST_MODEL (app->traveler.category.model), pos, 1, 0);
+		ugtk_node_tree_removed (app->traveler.category.model, child);
 		// sync UgtkMenubar.download.move_to
 		ugtk_menubar_sync_category (&app->menubar, app, TRUE);
 	}
 	else if (node == (UgetNode*) app->traveler.download.model->root) {
 		// download removed
-		if (sibling)
-			pos = uget_node_child_position (node, sibling);
-		else
-			pos = app->traveler.download.model->root->n_children;
-		g_list_model_items_changed (
-				G_LIST_MODEL (app->traveler.download.model), pos, 1, 0);
+		ugtk_node_tree_removed (app->traveler.download.model, child);
 	}
 }
 
@@ -474,7 +468,6 @@ static void node_updated (UgetNode* child)
 {
 	UgetNode*  node;
 	UgtkApp*   app;
-	int        pos;
 
 	node = child->parent;
 	if (node == NULL)
@@ -482,16 +475,18 @@ static void node_updated (UgetNode* child)
 	app = node->control->notifier->data;
 	if (node == (UgetNode*) app->traveler.category.model->root) {
 		// category changed
-		pos = uget_node_child_position (node, child) + 1;  // +1 for "All Category"
-		g_list_model_items_changed (
-				G_LIST_MODEL (app->traveler.category.model), pos, 1, 1);
+		ugtk_node_view_update ((GtkWidget*) app->traveler.category.view,
+				child, UGTK_NODE_VIEW_UPDATE_ALL);
 		// sync UgtkMenubar.download.move_to
 		ugtk_menubar_sync_category (&app->menubar, app, TRUE);
 	}
 	else if (node == (UgetNode*) app->traveler.download.model->root) {
-		// download changed
-		pos = uget_node_child_position (node, child);
-		g_list_model_items_changed (
-				G_LIST_MODEL (app->traveler.download.model), pos, 1, 1);
+		// download changed. Cells are rebound only if UgetCommon.generation,
+		// UgetRelation.group, or UgetProgress.generation changed (active
+		// downloads notify it every time UgetApp grows).
+		ugtk_node_view_update_changed (
+				(GtkWidget*) app->traveler.download.view, child);
+		ugtk_node_view_update_progress (
+				(GtkWidget*) app->traveler.download.view, child);
 	}
 }
@@ -165,12 +165,6 @@ static gboolean  ugtk_app_decide_schedule_state (UgtkApp* app)
 		}
 	}
 
-	if (changed) {
-		// refresh other data & status
-		gtk_widget_queue_draw ((GtkWidget*) app->traveler.download.view);
-		gtk_widget_queue_draw ((GtkWidget*) app->traveler.category.view);
-		gtk_widget_queue_draw ((GtkWidget*) app->traveler.state.view);
-	}
 	return changed;
 }
 
@@ -181,6 +175,7 @@ static gboolean  ugtk_app_timeout_queuing (UgtkApp* app)
 	int         n_active;
 	int         no_queuing = FALSE;
 	gchar*      string;
+	UgetNode*   node;
 
 	ugtk_app_decide_schedule_state (app);
 	if (app->setting.offline_mode ||
@@ -270,8 +265,9 @@ static gboolean  ugtk_app_timeout_queuing (UgtkApp* app)
 		if (n_counts & 1)
 			uget_task_adjust_speed (&app->task);
 		// summary
-		ugtk_summary_show (&app->summary,
-				ugtk_traveler_get_cursor (&app->traveler));
+		// summary is rebuilt only when name, URI or messages changed.
+		node = ugtk_traveler_get_cursor (&app->traveler);
+		ugtk_summary_refresh (&app->summary, (node) ? node->base : NULL);
 		// status bar
 		ugtk_statusbar_set_speed (&app->statusbar,
 				app->task.speed.download, app->task.speed.upload);
@@ -289,12 +285,12 @@ static gboolean  ugtk_app_timeout_queuing (UgtkApp* app)
 	}
 
 	uget_app_trim((UgetApp*) app, NULL);
-	if (app->n_moved > 0) {
-		// refresh other data & status
-		gtk_widget_queue_draw ((GtkWidget*) app->traveler.download.view);
-		gtk_widget_queue_draw ((GtkWidget*) app->traveler.category.view);
-		gtk_widget_queue_draw ((GtkWidget*) app->traveler.state.view);
-	}
+	// Rows of download are rebound by node_updated() and
+	// items-changed. Only quantity of category & status need rebinding.
+	// n_children of split nodes are counters of category & status, they
+	// are compared with bound value here, at most twice per second.
+	ugtk_node_view_update_quantity ((GtkWidget*) app->traveler.category.view);
+	ugtk_node_view_update_quantity ((GtkWidget*) app->traveler.state.view);
 
 	app->user_action = FALSE;
 	app->n_moved = 0;   // reset counter
@@ -317,65 +313,46 @@ static void  ugtk_app_add_uris_quietly (UgtkApp* app,       GList* list,
                                         UgInfo*  node_info, int  nth_category)
 {
 	GList*      link;
-	UgUri       uuri;
+	GPtrArray*  dnodes;
 	UgetNode*   cnode;
+	UgetNode*   cnode_default;
 	UgetNode*   dnode;
 	UgetCommon* common;
 
-	// filter existing
-	if (app->setting.ui.skip_existing) {
-		if (ugtk_app_filter_existing (app, list) == 0)
-			return;
+	// select category, other downloads match category by URI and filename.
+	cnode = NULL;
+	if (nth_category != -1)
+		cnode = uget_node_nth_child (&app->real, nth_category);
+	if (node_info == NULL) {
+		cnode_default = uget_node_nth_child (&app->real,
+				app->setting.clipboard.nth_category);
+	}
+	else {
+		cnode_default = uget_node_nth_child (&app->real,
+				app->setting.commandline.nth_category);
 	}
 
+	dnodes = g_ptr_array_new ();
 	for (link = list;  link;  link = link->next) {
-		// check existing
 		if (link->data == NULL)
 			continue;
-		// select category
-		cnode = NULL;
-		if (nth_category != -1)
-			cnode = uget_node_nth_child (&app->real, nth_category);
-		if (cnode == NULL) {
-			// match category by URI
-			ug_uri_init (&uuri, link->data);
-			cnode = uget_app_match_category ((UgetApp*) app, &uuri, NULL);
-		}
-		if (cnode == NULL && node_info) {
-			// match category by filename
-			common = ug_info_realloc(node_info, UgetCommonInfo);
-			if (common && common->file) {
-				ug_uri_init (&uuri, common->file);
-				cnode = uget_app_match_category ((UgetApp*) app, &uuri, NULL);
-			}
-		}
-		if (cnode == NULL) {
-			if (node_info == NULL) {
-				cnode = uget_node_nth_child (&app->real,
-						app->setting.clipboard.nth_category);
-			}
-			else {
-				cnode = uget_node_nth_child (&app->real,
-						app->setting.commandline.nth_category);
-			}
-		}
-		if (cnode == NULL)
-			cnode = uget_node_nth_child (&app->real, 0);
-		// add download
-		if (node_info == NULL) {
-			// add and free URI
-			uget_app_add_download_uri ((UgetApp*) app, link->data, cnode, TRUE);
-			g_free (link->data);
-		}
-		else {
-			dnode = uget_node_new (NULL);
+		dnode = uget_node_new (NULL);
+		if (node_info)
 			ug_info_assign(dnode->info, node_info, NULL);
-			common = ug_info_realloc(dnode->info, UgetCommonInfo);
-			common->uri = link->data;
-			uget_app_add_download ((UgetApp*) app, dnode, cnode, TRUE);
-		}
+		common = ug_info_realloc(dnode->info, UgetCommonInfo);
+		common->uri = link->data;
 		link->data = NULL;
+		g_ptr_array_add (dnodes, dnode);
 	}
+
+	// add all downloads at once and sync view one time
+	if (uget_app_add_downloads ((UgetApp*) app,
+			(UgetNode**) dnodes->pdata, dnodes->len, cnode, cnode_default,
+			TRUE, app->setting.ui.skip_existing) > 0)
+	{
+		ugtk_node_tree_sync (app->traveler.download.model);
+	}
+	g_ptr_array_free (dnodes, TRUE);
 }
 
 static void  ugtk_app_add_uris_selected (UgtkApp* app,       GList* list,
@@ -489,6 +466,9 @@ static gboolean  ugtk_app_timeout_rpc (UgtkApp* app)
 	UgetRpcCmd*  cmd;
 	UgInfo*      node_info;
 
+	// status of downloads for query methods
+	uget_rpc_update (app->rpc, (UgetApp*) app);
+
 	for (;;) {
 		if (uget_rpc_has_request(app->rpc) == FALSE)
 			return TRUE;
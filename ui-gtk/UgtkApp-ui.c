@@ -360,6 +360,13 @@ static void ugtk_toolbar_init_ui (struct UgtkToolbar* ugt, gpointer accel_group)
 	ugt->move_bottom = gtk_button_new_from_icon_name ("go-bottom");
 	gtk_widget_set_tooltip_text (ugt->move_bottom, _("Move Bottom"));
 	gtk_box_append (GTK_BOX (ugt->toolbar), ugt->move_bottom);
+
+	// Search
+	ugt->search = gtk_search_entry_new ();
+	gtk_widget_set_tooltip_text (ugt->search, _("Search name, URI, and folder"));
+	gtk_widget_set_hexpand (ugt->search, TRUE);
+	gtk_widget_set_halign (ugt->search, GTK_ALIGN_END);
+	gtk_box_append (GTK_BOX (ugt->toolbar), ugt->search);
 }
 
 
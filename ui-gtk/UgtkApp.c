@@ -45,6 +45,7 @@
 #include <UgetPluginMedia.h>
 #include <UgetPluginMega.h>
 #include <UgtkApp.h>
+#include <UgtkNodeObject.h>
 #include <UgtkUtil.h>
 #include <UgtkNodeDialog.h>
 #include <UgtkBatchDialog.h>
@@ -94,6 +95,7 @@ void  ugtk_app_init (UgtkApp* app, UgetRpc* rpc)
 	gtk_widget_set_visible(app->banner.self, FALSE);
 
 	uget_app_use_uri_hash ((UgetApp*) app);
+	uget_app_use_search ((UgetApp*) app);
 	ugtk_app_init_timeout (app);
 
 	if (app->setting.ui.start_in_tray)
@@ -109,7 +111,9 @@ void  ugtk_app_final (UgtkApp* app)
 {
 	int  shutdown_now;
 
-	uget_app_set_notification ((UgetApp*) app, NULL, NULL, NULL, NULL);
+	// keep releasing UgtkNodeObject of nodes that will be freed
+	uget_app_set_notification ((UgetApp*) app, NULL, NULL, NULL, NULL,
+			(UgNotifyFunc) ugtk_node_object_release);
 
 	if (app->setting.plugin_order >= UGTK_PLUGIN_ORDER_ARIA2)
 		shutdown_now = app->setting.aria2.shutdown;
@@ -448,6 +452,8 @@ void  ugtk_app_set_plugin_setting (UgtkApp* app, UgtkSetting* setting)
 	if (setting->plugin_order >= UGTK_PLUGIN_ORDER_ARIA2) {
 		uget_plugin_global_set(UgetPluginAria2Info, UGET_PLUGIN_ARIA2_GLOBAL_URI,
 		                 setting->aria2.uri);
+		uget_plugin_global_set(UgetPluginAria2Info, UGET_PLUGIN_ARIA2_GLOBAL_UNIX_SOCKET,
+		                 setting->aria2.unix_socket);
 		uget_plugin_global_set(UgetPluginAria2Info, UGET_PLUGIN_ARIA2_GLOBAL_PATH,
 		                 setting->aria2.path);
 		uget_plugin_global_set(UgetPluginAria2Info, UGET_PLUGIN_ARIA2_GLOBAL_ARGUMENT,
@@ -1722,18 +1728,39 @@ int   ugtk_app_filter_existing (UgtkApp* app, GList* uris)
 }
 
 // ------------------------------------
-// Refresh GListModel for UgtkNodeTree and UgtkNodeList
+// Sync GListModel of UgtkNodeTree and rebind rows of changed node
 
 void  ugtk_app_download_changed (UgtkApp* app, UgetNode* dnode)
 {
-	ugtk_node_tree_refresh (app->traveler.download.model);
+	UgetCommon*  common;
+
+	// let node_updated() rebind cells other than progress
+	common = ug_info_get (dnode->info, UgetCommonInfo);
+	if (common)
+		common->generation++;
+	uget_app_update_search ((UgetApp*) app, dnode);
+	ugtk_node_tree_sync (app->traveler.download.model);
+	// node_updated() rebind rows of dnode and it's fake nodes
+	uget_node_updated (dnode->base);
 }
 
 void  ugtk_app_category_changed (UgtkApp* app, UgetNode* cnode)
 {
-	ugtk_node_tree_refresh (app->traveler.category.model);
-	// refresh status list
-	ugtk_node_list_refresh (app->traveler.state.model);
+	UgetNode*  node;
+
+	uget_app_update_category ((UgetApp*) app, cnode);
+	ugtk_node_tree_sync (app->traveler.category.model);
+	// node_updated() rebind rows of cnode and it's fake nodes
+	uget_node_updated (cnode->base);
+	// state list and category column of downloads show name of category.
+	// Their items are not changed, rebind bound rows to keep selection.
+	ugtk_node_view_update_bound ((GtkWidget*) app->traveler.state.view,
+			UGTK_NODE_VIEW_UPDATE_ALL);
+	ugtk_node_view_update_bound ((GtkWidget*) app->traveler.download.view,
+			1 << UGTK_NODE_COLUMN_CATEGORY);
+	// summary show name of category, ugtk_summary_refresh() can't see it.
+	node = app->traveler.download.cursor.node;
+	ugtk_summary_show (&app->summary, (node) ? node->base : NULL);
 }
 
 void  ugtk_app_add_default_category (UgtkApp* app)
@@ -1746,7 +1773,7 @@ void  ugtk_app_add_default_category (UgtkApp* app)
 	cnode = uget_node_new (NULL);
 	common = ug_info_realloc (cnode->info, UgetCommonInfo);
 	common->name = ug_strdup_printf ("%s %d", _("New"), counts++);
-	common->folder = ug_strdup (g_get_user_special_dir (G_USER_DIRECTORY_DOWNLOAD));
+	common->folder = ug_str_intern (g_get_user_special_dir (G_USER_DIRECTORY_DOWNLOAD));
 	category = ug_info_realloc (cnode->info, UgetCategoryInfo);
 	*(char**)ug_array_alloc (&category->schemes, 1) = ug_strdup ("ftps");
 	*(char**)ug_array_alloc (&category->schemes, 1) = ug_strdup ("magnet");
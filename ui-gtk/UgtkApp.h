@@ -190,6 +190,9 @@ struct UgtkApp
 		GtkWidget*  move_down;
 		GtkWidget*  move_top;
 		GtkWidget*  move_bottom;
+
+		// GtkSearchEntry
+		GtkWidget*  search;
 	} toolbar;
 };
 
@@ -254,7 +257,7 @@ void  ugtk_app_sequence_batch (UgtkApp* app);
 void  ugtk_app_clipboard_batch (UgtkApp* app);
 int   ugtk_app_filter_existing (UgtkApp* app, GList* uris);
 
-// emit signal "row-changed" for UgtkNodeTree and UgtkNodeList
+// sync UgtkNodeTree and rebind rows of node (without resetting whole model)
 void  ugtk_app_download_changed  (UgtkApp* app, UgetNode* dnode);
 void  ugtk_app_category_changed  (UgtkApp* app, UgetNode* cnode);
 
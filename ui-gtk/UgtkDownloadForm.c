@@ -445,6 +445,21 @@ static void ugtk_download_form_init_page2 (UgtkDownloadForm* dform)
 	dform->timestamp = (GtkCheckButton*) widget;
 }
 
+// return interned string that CR and LF were removed, or NULL if text is empty
+static char*  intern_without_crlf (const char* text)
+{
+	char*  temp;
+	char*  interned;
+
+	if (*text == 0)
+		return NULL;
+	temp = ug_strdup (text);
+	ug_str_remove_crlf (temp, temp);
+	interned = ug_str_intern (temp);
+	ug_free (temp);
+	return interned;
+}
+
 void  ugtk_download_form_get (UgtkDownloadForm* dform, UgInfo* node_info)
 {
 	UgUri         uuri;
@@ -461,9 +476,8 @@ void  ugtk_download_form_get (UgtkDownloadForm* dform, UgInfo* node_info)
 	temp.common = ug_info_realloc(node_info, UgetCommonInfo);
 	// folder
 	text = gtk_editable_get_text (GTK_EDITABLE (dform->folder_entry));
-	ug_free (temp.common->folder);
-	temp.common->folder = (*text) ? ug_strdup (text) : NULL;
-	ug_str_remove_crlf (temp.common->folder, temp.common->folder);
+	ug_str_unintern (temp.common->folder);
+	temp.common->folder = intern_without_crlf (text);
 	// user
 	text = gtk_editable_get_text (GTK_EDITABLE (dform->username_entry));
 	ug_free (temp.common->user);
@@ -541,9 +555,8 @@ void  ugtk_download_form_get (UgtkDownloadForm* dform, UgInfo* node_info)
 	temp.http = ug_info_realloc(node_info, UgetHttpInfo);
 	// referrer
 	text = gtk_editable_get_text (GTK_EDITABLE (dform->referrer_entry));
-	ug_free (temp.http->referrer);
-	temp.http->referrer = (*text) ? ug_strdup (text) : NULL;
-	ug_str_remove_crlf (temp.http->referrer, temp.http->referrer);
+	ug_str_unintern (temp.http->referrer);
+	temp.http->referrer = intern_without_crlf (text);
 	// cookie_file
 	text = gtk_editable_get_text (GTK_EDITABLE (dform->cookie_entry));
 	ug_free (temp.http->cookie_file);
@@ -556,9 +569,8 @@ void  ugtk_download_form_get (UgtkDownloadForm* dform, UgInfo* node_info)
 	ug_str_remove_crlf (temp.http->post_file, temp.http->post_file);
 	// user_agent
 	text = gtk_editable_get_text (GTK_EDITABLE (dform->agent_entry));
-	ug_free (temp.http->user_agent);
-	temp.http->user_agent = (*text) ? ug_strdup (text) : NULL;
-	ug_str_remove_crlf (temp.http->user_agent, temp.http->user_agent);
+	ug_str_unintern (temp.http->user_agent);
+	temp.http->user_agent = intern_without_crlf (text);
 
 	// ------------------------------------------
 	// UgetRelation
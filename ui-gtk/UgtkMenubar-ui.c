@@ -667,7 +667,7 @@ static void on_action_category_move_up (GSimpleAction *action, GVariant *paramet
     if (position) {
         gint new_pos = app->traveler.category.cursor.pos - 1;
         uget_app_move_category ((UgetApp*) app, cnode, position);
-        gtk_widget_queue_draw ((GtkWidget*) app->traveler.category.view);
+        ugtk_node_tree_sync (app->traveler.category.model);
         // Re-select the moved category at its new position
         ugtk_traveler_select_category (&app->traveler, new_pos, -1);
     }
@@ -687,7 +687,7 @@ static void on_action_category_move_down (GSimpleAction *action, GVariant *param
     if (position || cnode->next) {  // Can only move if there's a next
         gint new_pos = app->traveler.category.cursor.pos + 1;
         uget_app_move_category ((UgetApp*) app, cnode, position);
-        gtk_widget_queue_draw ((GtkWidget*) app->traveler.category.view);
+        ugtk_node_tree_sync (app->traveler.category.model);
         // Re-select the moved category at its new position
         ugtk_traveler_select_category (&app->traveler, new_pos, -1);
     }
@@ -1641,7 +1641,7 @@ void ugtk_context_menus_init (UgtkApp *app)
     // Summary context menu
     menu = ugtk_create_summary_context_menu ();
     app->summary_context_menu = gtk_popover_menu_new_from_model (G_MENU_MODEL (menu));
-    gtk_widget_set_parent (app->summary_context_menu, GTK_WIDGET (app->summary.list_box));
+    gtk_widget_set_parent (app->summary_context_menu, GTK_WIDGET (app->summary.view));
     gtk_popover_set_has_arrow (GTK_POPOVER (app->summary_context_menu), FALSE);
     g_signal_connect (app->summary_context_menu, "notify::visible", G_CALLBACK (on_popover_visible_notify), NULL);
     g_object_unref (menu);
@@ -1649,5 +1649,5 @@ void ugtk_context_menus_init (UgtkApp *app)
     gesture = gtk_gesture_click_new ();
     gtk_gesture_single_set_button (GTK_GESTURE_SINGLE (gesture), 3);  // Right button
     g_signal_connect (gesture, "pressed", G_CALLBACK (on_summary_right_click), app);
-    gtk_widget_add_controller (GTK_WIDGET (app->summary.list_box), GTK_EVENT_CONTROLLER (gesture));
+    gtk_widget_add_controller (GTK_WIDGET (app->summary.view), GTK_EVENT_CONTROLLER (gesture));
 }
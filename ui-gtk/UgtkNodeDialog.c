@@ -35,7 +35,6 @@
  */
 
 #include <UgtkNodeView.h>
-#include <UgtkNodeObject.h>
 #include <UgtkNodeDialog.h>
 
 #include <glib/gi18n.h>
@@ -433,18 +432,15 @@ static void ugtk_node_dialog_init_list_ui (UgtkNodeDialog* ndialog,
 static void on_selection_changed (GtkSingleSelection* sel, GParamSpec* pspec,
                                   UgtkNodeDialog* ndialog)
 {
-	UgtkNodeObject* obj;
 	UgetNode*       node;
 	guint           pos;
 
 	pos = gtk_single_selection_get_selected (sel);
 	if (pos == GTK_INVALID_LIST_POSITION)
 		return;
-	obj = g_list_model_get_item (G_LIST_MODEL (ndialog->node_tree), pos);
-	if (obj == NULL)
+	node = ugtk_node_tree_nth (ndialog->node_tree, pos);
+	if (node == NULL)
 		return;
-	node = obj->node;
-	g_object_unref (obj);
 	ugtk_proxy_form_set(&ndialog->proxy, node->info, TRUE);
 	ugtk_download_form_set(&ndialog->download, node->info, TRUE);
 }
@@ -523,6 +519,7 @@ static void on_ok_edit_download (GtkWidget* button, UgtkNodeDialog* ndialog)
 			ugtk_traveler_reserve_selection (&app->traveler);
 			uget_app_reset_download_name((UgetApp*) app, ndialog->node);
 			ugtk_traveler_restore_selection (&app->traveler);
+			ugtk_app_download_changed (app, ndialog->node);
 		}
 		ug_info_unref(ndialog->node_info);
 		ugtk_download_form_get_folders (&ndialog->download,
@@ -553,6 +550,6 @@ static void on_category_items_changed (GListModel* model, guint pos,
                                        guint removed, guint added,
                                        UgtkNodeDialog* ndialog)
 {
-	// When the main window's category model changes, refresh our dialog's model
-	ugtk_node_tree_refresh (ndialog->node_tree);
+	// When the main window's category model changes, sync our dialog's model
+	ugtk_node_tree_sync (ndialog->node_tree);
 }
@@ -54,8 +54,15 @@ static void ugtk_node_list_list_model_init (GListModelInterface* iface)
 G_DEFINE_TYPE_WITH_CODE (UgtkNodeList, ugtk_node_list, G_TYPE_OBJECT,
 	G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, ugtk_node_list_list_model_init))
 
+static void ugtk_node_list_finalize (GObject* object)
+{
+	g_ptr_array_unref (UGTK_NODE_LIST (object)->items);
+	G_OBJECT_CLASS (ugtk_node_list_parent_class)->finalize (object);
+}
+
 static void ugtk_node_list_class_init (UgtkNodeListClass* klass)
 {
+	G_OBJECT_CLASS (klass)->finalize = ugtk_node_list_finalize;
 }
 
 static void ugtk_node_list_init (UgtkNodeList* ulist)
@@ -63,42 +70,24 @@ static void ugtk_node_list_init (UgtkNodeList* ulist)
 	ulist->root = NULL;
 	ulist->n_fake = 0;
 	ulist->root_visible = FALSE;
-	ulist->last_count = 0;
+	ulist->items = g_ptr_array_new ();
 }
 
 // --- GListModel helpers ---
 
-static gint ugtk_node_list_count (UgtkNodeList* ulist)
+static void ugtk_node_list_rebuild (UgtkNodeList* ulist)
 {
 	UgetNode* node;
 	gint n;
 
+	g_ptr_array_set_size (ulist->items, 0);
 	if (ulist->root == NULL)
-		return 0;
+		return;
 
-	for (n = 0, node = ulist->root->fake;  node;  node = node->peer)
-		n++;
-	if (n > ulist->n_fake)
-		n = ulist->n_fake;
 	if (ulist->root_visible)
-		n++;
-	return n;
-}
-
-static UgetNode* ugtk_node_list_nth (UgtkNodeList* ulist, guint position)
-{
-	if (ulist->root == NULL)
-		return NULL;
-
-	if (ulist->root_visible) {
-		if (position == 0)
-			return ulist->root;
-		position--;
-	}
-
-	if ((gint)position >= ulist->n_fake)
-		return NULL;
-	return uget_node_nth_fake (ulist->root, position);
+		g_ptr_array_add (ulist->items, ulist->root);
+	for (n = 0, node = ulist->root->fake;  node && n < ulist->n_fake;  node = node->peer, n++)
+		g_ptr_array_add (ulist->items, node);
 }
 
 // --- GListModel interface ---
@@ -110,18 +99,16 @@ static GType list_model_get_item_type (GListModel* list)
 
 static guint list_model_get_n_items (GListModel* list)
 {
-	return ugtk_node_list_count (UGTK_NODE_LIST (list));
+	return UGTK_NODE_LIST (list)->items->len;
 }
 
 static gpointer list_model_get_item (GListModel* list, guint position)
 {
 	UgtkNodeList* ulist = UGTK_NODE_LIST (list);
-	UgetNode* node;
 
-	node = ugtk_node_list_nth (ulist, position);
-	if (node == NULL)
+	if (position >= ulist->items->len)
 		return NULL;
-	return ugtk_node_object_new (node);
+	return g_object_ref (ugtk_node_object_get (g_ptr_array_index (ulist->items, position)));
 }
 
 // --- public API ---
@@ -134,13 +121,23 @@ UgtkNodeList* ugtk_node_list_new (UgetNode* root, gint n_fake, gboolean root_vis
 	ulist->root = root;
 	ulist->n_fake = n_fake;
 	ulist->root_visible = root_visible;
+	ugtk_node_list_rebuild (ulist);
 	return ulist;
 }
 
 void ugtk_node_list_refresh (UgtkNodeList* ulist)
 {
-	guint old_n = ulist->last_count;
-	guint new_n = ugtk_node_list_count (ulist);
-	ulist->last_count = new_n;
+	guint old_n = ulist->items->len;
+	guint new_n;
+
+	ugtk_node_list_rebuild (ulist);
+	new_n = ulist->items->len;
 	g_list_model_items_changed (G_LIST_MODEL (ulist), 0, old_n, new_n);
 }
+
+UgetNode* ugtk_node_list_nth (UgtkNodeList* ulist, guint position)
+{
+	if (position >= ulist->items->len)
+		return NULL;
+	return g_ptr_array_index (ulist->items, position);
+}
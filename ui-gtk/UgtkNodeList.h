@@ -54,6 +54,8 @@ typedef struct UgtkNodeList       UgtkNodeList;
 typedef struct UgtkNodeListClass  UgtkNodeListClass;
 
 // GListModel for UgetNode: shows root (optionally) + first n_fake children.
+// Items are cached in 'items', call ugtk_node_list_refresh() after changing
+// 'root'.
 struct UgtkNodeList
 {
 	GObject     parent;
@@ -61,7 +63,7 @@ struct UgtkNodeList
 	UgetNode*   root;
 	gint        n_fake;
 	gboolean    root_visible;
-	guint       last_count;
+	GPtrArray*  items;
 };
 
 struct UgtkNodeListClass
@@ -73,9 +75,12 @@ UgtkNodeList*  ugtk_node_list_new (UgetNode* root, gint n_fake, gboolean root_vi
 
 GType  ugtk_node_list_get_type (void);
 
-// Notify the model that items changed (call after root/data changes)
+// Rebuild items and notify the model that items changed (call after root/data changes)
 void  ugtk_node_list_refresh (UgtkNodeList* ulist);
 
+// return NULL if 'position' is out of range. It doesn't create UgtkNodeObject.
+UgetNode* ugtk_node_list_nth (UgtkNodeList* ulist, guint position);
+
 #ifdef __cplusplus
 }
 #endif
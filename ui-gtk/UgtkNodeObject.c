@@ -34,17 +34,39 @@
  *
  */
 
+#include <UgDefine.h>
 #include <UgtkNodeObject.h>
 
 G_DEFINE_TYPE (UgtkNodeObject, ugtk_node_object, G_TYPE_OBJECT)
 
+static void ugtk_node_object_finalize (GObject* object)
+{
+	UgtkNodeObject* self = UGTK_NODE_OBJECT (object);
+	int             index;
+
+	for (index = 0;  index < UGTK_NODE_N_COLUMNS;  index++)
+		ug_free (self->text[index].string);
+	G_OBJECT_CLASS (ugtk_node_object_parent_class)->finalize (object);
+}
+
 static void ugtk_node_object_class_init (UgtkNodeObjectClass* klass)
 {
+	G_OBJECT_CLASS (klass)->finalize = ugtk_node_object_finalize;
 }
 
 static void ugtk_node_object_init (UgtkNodeObject* self)
 {
+	int  index;
+
 	self->node = NULL;
+	self->generation = 0;
+	self->common_generation = 0;
+	self->group = 0;
+	self->quantity = 0;
+	for (index = 0;  index < UGTK_NODE_N_COLUMNS;  index++) {
+		self->text[index].value = 0;
+		self->text[index].string = NULL;
+	}
 }
 
 UgtkNodeObject* ugtk_node_object_new (UgetNode* node)
@@ -55,3 +77,22 @@ UgtkNodeObject* ugtk_node_object_new (UgetNode* node)
 	obj->node = node;
 	return obj;
 }
+
+UgtkNodeObject* ugtk_node_object_get (UgetNode* node)
+{
+	if (node->data == NULL)
+		node->data = ugtk_node_object_new (node);
+	return node->data;
+}
+
+void  ugtk_node_object_release (UgetNode* node)
+{
+	UgtkNodeObject* obj;
+
+	obj = node->data;
+	if (obj) {
+		node->data = NULL;
+		obj->node = NULL;
+		g_object_unref (obj);
+	}
+}
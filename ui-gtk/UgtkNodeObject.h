@@ -37,8 +37,10 @@
 #ifndef UGTK_NODE_OBJECT_H
 #define UGTK_NODE_OBJECT_H
 
+#include <stdint.h>
 #include <gtk/gtk.h>
 #include <UgetNode.h>
+#include <UgtkNodeView.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,11 +53,29 @@ extern "C" {
 typedef struct UgtkNodeObject       UgtkNodeObject;
 typedef struct UgtkNodeObjectClass  UgtkNodeObjectClass;
 
-// GObject wrapper for UgetNode*, required by GListModel
+// GObject wrapper for UgetNode*, required by GListModel.
+// Every UgetNode has only one wrapper, it is stored in UgetNode.data.
+// UgtkNodeObject.node is NULL after node has been freed.
 struct UgtkNodeObject
 {
 	GObject    parent;
 	UgetNode*  node;
+
+	// UgetProgress.generation when progress cells were bound last time
+	unsigned int  generation;
+	// UgetCommon.generation and UgetRelation.group when other cells were
+	// bound last time
+	unsigned int  common_generation;
+	int           group;
+	// UgetNode.n_children when quantity of sidebar row was bound last time
+	unsigned int  quantity;
+
+	// formatted text of cells (index is UgtkNodeColumn).
+	// 'string' is kept until 'value' changed.
+	struct {
+		int64_t   value;
+		char*     string;
+	} text[UGTK_NODE_N_COLUMNS];
 };
 
 struct UgtkNodeObjectClass
@@ -66,6 +86,12 @@ struct UgtkNodeObjectClass
 GType            ugtk_node_object_get_type (void);
 UgtkNodeObject*  ugtk_node_object_new (UgetNode* node);
 
+// return wrapper of 'node' (without adding reference).
+// It is created at first call and released by ugtk_node_object_release().
+UgtkNodeObject*  ugtk_node_object_get (UgetNode* node);
+// UgetNodeNotifier.destroy: release wrapper before 'node' is freed.
+void             ugtk_node_object_release (UgetNode* node);
+
 #ifdef __cplusplus
 }
 #endif
@@ -54,16 +54,27 @@ static void ugtk_node_tree_list_model_init (GListModelInterface* iface)
 G_DEFINE_TYPE_WITH_CODE (UgtkNodeTree, ugtk_node_tree, G_TYPE_OBJECT,
 	G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, ugtk_node_tree_list_model_init))
 
+static void ugtk_node_tree_finalize (GObject* object)
+{
+	UgtkNodeTree* utree = UGTK_NODE_TREE (object);
+
+	g_hash_table_destroy (utree->positions);
+	ug_rank_tree_clear (&utree->index);
+	G_OBJECT_CLASS (ugtk_node_tree_parent_class)->finalize (object);
+}
+
 static void ugtk_node_tree_class_init (UgtkNodeTreeClass* klass)
 {
+	G_OBJECT_CLASS (klass)->finalize = ugtk_node_tree_finalize;
 }
 
 static void ugtk_node_tree_init (UgtkNodeTree* utree)
 {
 	utree->root = NULL;
-	utree->last_count = 0;
 	utree->prefix.root = NULL;
 	utree->prefix.len = 0;
+	ug_rank_tree_init (&utree->index);
+	utree->positions = g_hash_table_new (g_direct_hash, g_direct_equal);
 }
 
 // --- helpers ---
@@ -80,29 +91,46 @@ static gint ugtk_node_tree_prefix_count (UgtkNodeTree* utree)
 	return n;
 }
 
-static gint ugtk_node_tree_count (UgtkNodeTree* utree)
+// insert 'node' before 'sibling'. If 'sibling' is NULL, append 'node'.
+static UgRankNode* ugtk_node_tree_add (UgtkNodeTree* utree, UgRankNode* sibling, UgetNode* node)
 {
-	gint n;
+	UgRankNode* rnode;
 
-	n = ugtk_node_tree_prefix_count (utree);
-	if (utree->root)
-		n += utree->root->n_children;
-	return n;
+	rnode = ug_rank_tree_insert (&utree->index, sibling, node);
+	g_hash_table_insert (utree->positions, node, rnode);
+	return rnode;
 }
 
-static UgetNode* ugtk_node_tree_nth (UgtkNodeTree* utree, guint position)
+// collect prefix children + root children in current order
+static void ugtk_node_tree_collect (UgtkNodeTree* utree, GPtrArray* array)
 {
-	gint n_prefix;
+	UgetNode* node;
+	gint      n;
+
+	n = ugtk_node_tree_prefix_count (utree);
+	if (n > 0) {
+		for (node = utree->prefix.root->children;  node && n > 0;  node = node->next, n--)
+			g_ptr_array_add (array, node);
+	}
+	if (utree->root) {
+		for (node = utree->root->children;  node;  node = node->next)
+			g_ptr_array_add (array, node);
+	}
+}
 
-	n_prefix = ugtk_node_tree_prefix_count (utree);
+static void ugtk_node_tree_rebuild (UgtkNodeTree* utree)
+{
+	GPtrArray* array;
+	guint      index;
 
-	if ((gint)position < n_prefix)
-		return uget_node_nth_child (utree->prefix.root, position);
+	g_hash_table_remove_all (utree->positions);
+	ug_rank_tree_clear (&utree->index);
 
-	position -= n_prefix;
-	if (utree->root == NULL)
-		return NULL;
-	return uget_node_nth_child (utree->root, position);
+	array = g_ptr_array_new ();
+	ugtk_node_tree_collect (utree, array);
+	for (index = 0;  index < array->len;  index++)
+		ugtk_node_tree_add (utree, NULL, g_ptr_array_index (array, index));
+	g_ptr_array_unref (array);
 }
 
 // --- GListModel interface ---
@@ -114,18 +142,18 @@ static GType list_model_get_item_type (GListModel* list)
 
 static guint list_model_get_n_items (GListModel* list)
 {
-	return ugtk_node_tree_count (UGTK_NODE_TREE (list));
+	return ug_rank_tree_length (&UGTK_NODE_TREE (list)->index);
 }
 
 static gpointer list_model_get_item (GListModel* list, guint position)
 {
 	UgtkNodeTree* utree = UGTK_NODE_TREE (list);
-	UgetNode* node;
+	UgRankNode*   rnode;
 
-	node = ugtk_node_tree_nth (utree, position);
-	if (node == NULL)
+	rnode = ug_rank_tree_nth (&utree->index, position);
+	if (rnode == NULL)
 		return NULL;
-	return ugtk_node_object_new (node);
+	return g_object_ref (ugtk_node_object_get (rnode->data));
 }
 
 // --- public API ---
@@ -136,6 +164,7 @@ UgtkNodeTree* ugtk_node_tree_new (UgetNode* root, gboolean list_only)
 
 	utree = g_object_new (UGTK_TYPE_NODE_TREE, NULL);
 	utree->root = root;
+	ugtk_node_tree_rebuild (utree);
 	// list_only was for GtkTreeModel flags; no longer needed for GListModel
 	return utree;
 }
@@ -144,12 +173,114 @@ void ugtk_node_tree_set_prefix (UgtkNodeTree* utree, UgetNode* prefix_root, gint
 {
 	utree->prefix.root = prefix_root;
 	utree->prefix.len = prefix_len;
+	ugtk_node_tree_rebuild (utree);
 }
 
 void ugtk_node_tree_refresh (UgtkNodeTree* utree)
 {
-	guint old_n = utree->last_count;
-	guint new_n = ugtk_node_tree_count (utree);
-	utree->last_count = new_n;
+	guint old_n;
+	guint new_n;
+
+	old_n = ug_rank_tree_length (&utree->index);
+	ugtk_node_tree_rebuild (utree);
+	new_n = ug_rank_tree_length (&utree->index);
 	g_list_model_items_changed (G_LIST_MODEL (utree), 0, old_n, new_n);
 }
+
+void  ugtk_node_tree_sync (UgtkNodeTree* utree)
+{
+	GPtrArray*  array;
+	UgRankNode* rnode;
+	guint       old_n, new_n;
+	guint       head, tail, index;
+
+	array = g_ptr_array_new ();
+	ugtk_node_tree_collect (utree, array);
+	old_n = ug_rank_tree_length (&utree->index);
+	new_n = array->len;
+
+	// skip unchanged items at head and tail
+	for (head = 0;  head < old_n && head < new_n;  head++) {
+		rnode = ug_rank_tree_nth (&utree->index, head);
+		if (rnode->data != g_ptr_array_index (array, head))
+			break;
+	}
+	for (tail = 0;  tail < old_n - head && tail < new_n - head;  tail++) {
+		rnode = ug_rank_tree_nth (&utree->index, old_n - tail - 1);
+		if (rnode->data != g_ptr_array_index (array, new_n - tail - 1))
+			break;
+	}
+
+	// replace items between head and tail
+	if (head + tail < old_n || head + tail < new_n) {
+		for (index = head;  index < old_n - tail;  index++) {
+			rnode = ug_rank_tree_nth (&utree->index, head);
+			g_hash_table_remove (utree->positions, rnode->data);
+			ug_rank_tree_remove (&utree->index, rnode);
+		}
+		// first item of tail, it is NULL if tail is empty
+		rnode = ug_rank_tree_nth (&utree->index, head);
+		for (index = head;  index < new_n - tail;  index++)
+			ugtk_node_tree_add (utree, rnode, g_ptr_array_index (array, index));
+		g_list_model_items_changed (G_LIST_MODEL (utree), head,
+				old_n - head - tail, new_n - head - tail);
+	}
+	g_ptr_array_unref (array);
+}
+
+void  ugtk_node_tree_inserted (UgtkNodeTree* utree, UgetNode* sibling, UgetNode* child)
+{
+	UgRankNode* rnode;
+
+	if (child->parent != utree->root ||
+	    g_hash_table_contains (utree->positions, child))
+		return;
+
+	if (sibling == NULL)
+		rnode = NULL;
+	else {
+		rnode = g_hash_table_lookup (utree->positions, sibling);
+		if (rnode == NULL) {
+			// index is out of sync
+			ugtk_node_tree_refresh (utree);
+			return;
+		}
+	}
+	rnode = ugtk_node_tree_add (utree, rnode, child);
+	g_list_model_items_changed (G_LIST_MODEL (utree),
+			ug_rank_node_position (rnode), 0, 1);
+}
+
+void  ugtk_node_tree_removed (UgtkNodeTree* utree, UgetNode* child)
+{
+	UgRankNode* rnode;
+	guint       pos;
+
+	rnode = g_hash_table_lookup (utree->positions, child);
+	if (rnode == NULL)
+		return;
+	g_hash_table_remove (utree->positions, child);
+	pos = ug_rank_node_position (rnode);
+	ug_rank_tree_remove (&utree->index, rnode);
+	g_list_model_items_changed (G_LIST_MODEL (utree), pos, 1, 0);
+}
+
+gint  ugtk_node_tree_position (UgtkNodeTree* utree, UgetNode* node)
+{
+	UgRankNode* rnode;
+
+	rnode = g_hash_table_lookup (utree->positions, node);
+	if (rnode == NULL)
+		return -1;
+	return ug_rank_node_position (rnode);
+}
+
+UgetNode* ugtk_node_tree_nth (UgtkNodeTree* utree, guint position)
+{
+	UgRankNode* rnode;
+
+	rnode = ug_rank_tree_nth (&utree->index, position);
+	if (rnode == NULL)
+		return NULL;
+	return rnode->data;
+}
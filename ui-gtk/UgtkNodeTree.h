@@ -40,6 +40,7 @@
 #define UGTK_NODE_TREE_H
 
 #include <gtk/gtk.h>
+#include <UgRankTree.h>
 #include <UgetNode.h>
 
 #ifdef __cplusplus
@@ -54,17 +55,24 @@ typedef struct UgtkNodeTree       UgtkNodeTree;
 typedef struct UgtkNodeTreeClass  UgtkNodeTreeClass;
 
 // GListModel for UgetNode: shows prefix children + root children (flat).
+// Items are kept in 'index', so getting item and count don't walk UgetNode.
+// Call ugtk_node_tree_refresh() after changing 'root' or 'prefix',
+// call ugtk_node_tree_sync() after reordering children of 'root'.
 struct UgtkNodeTree
 {
 	GObject     parent;
 
 	UgetNode*   root;
-	guint       last_count;
 
 	struct {
 		UgetNode* root;
 		gint      len;
 	} prefix;
+
+	// position index of items (UgRankNode.data is UgetNode*)
+	UgRankTree  index;
+	// key: UgetNode*, value: UgRankNode* in 'index'
+	GHashTable* positions;
 };
 
 struct UgtkNodeTreeClass
@@ -77,8 +85,22 @@ UgtkNodeTree*  ugtk_node_tree_new (UgetNode* root, gboolean list_only);
 GType  ugtk_node_tree_get_type (void);
 void   ugtk_node_tree_set_prefix (UgtkNodeTree* utree, UgetNode* prefix_root, gint prefix_len);
 
-// Notify the model that items changed
+// Rebuild index and notify the model that all items changed
 void  ugtk_node_tree_refresh (UgtkNodeTree* utree);
+// Compare index with current order of nodes and notify the model that only
+// changed range of items changed. Call it after nodes were reordered without
+// notification (e.g. uget_node_move(), uget_app_set_sorting()).
+void  ugtk_node_tree_sync (UgtkNodeTree* utree);
+
+// Update index after 'child' has been inserted before 'sibling' or removed
+// from 'root'. These are called by UgetNodeNotifier and emit items-changed.
+void  ugtk_node_tree_inserted (UgtkNodeTree* utree, UgetNode* sibling, UgetNode* child);
+void  ugtk_node_tree_removed  (UgtkNodeTree* utree, UgetNode* child);
+
+// return -1 if 'node' is not in model
+gint  ugtk_node_tree_position (UgtkNodeTree* utree, UgetNode* node);
+// return NULL if 'position' is out of range. It doesn't create UgtkNodeObject.
+UgetNode* ugtk_node_tree_nth (UgtkNodeTree* utree, guint position);
 
 #ifdef __cplusplus
 }
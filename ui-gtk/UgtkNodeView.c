@@ -101,6 +101,59 @@ static const UgPair state_icon_pair[] =
 };
 static const int state_icon_pair_len = sizeof (state_icon_pair) / sizeof (UgPair);
 
+// ------------------------------------
+// Cached text: formatted string is kept in UgtkNodeObject until value changed.
+// Rebinding a row with unchanged progress doesn't format strings again.
+
+typedef char* (*UgtkNodeFormatFunc) (int64_t value);
+
+static char* format_size (int64_t value)
+{
+	return ug_str_from_int_unit (value, NULL);
+}
+
+static char* format_speed (int64_t value)
+{
+	return ug_str_from_int_unit (value, "/s");
+}
+
+static char* format_seconds (int64_t value)
+{
+	return ug_str_from_seconds ((int) value, TRUE);
+}
+
+static char* format_time (int64_t value)
+{
+	return ug_str_from_time ((time_t) value, FALSE);
+}
+
+static char* format_percent (int64_t value)
+{
+	return ug_strdup_printf ("%d%c", (int) value, '%');
+}
+
+static char* format_ratio (int64_t value)
+{
+	// value = ratio * 100
+	return ug_strdup_printf ("%.2f", value / 100.0);
+}
+
+static const char* get_text (GtkListItem* item, int column, int64_t value,
+                             UgtkNodeFormatFunc format)
+{
+	UgtkNodeObject* obj;
+
+	obj = gtk_list_item_get_item (item);
+	if (obj->text[column].string == NULL || obj->text[column].value != value) {
+		ug_free (obj->text[column].string);
+		obj->text[column].string = format (value);
+		obj->text[column].value = value;
+	}
+	if (obj->text[column].string == NULL)
+		return "";
+	return obj->text[column].string;
+}
+
 // ------------------------------------
 // Bind callbacks for Download columns
 
@@ -157,7 +210,7 @@ static void bind_complete (GtkSignalListItemFactory* factory, GtkListItem* item,
 {
 	UgetNode*       node;
 	UgetProgress*   progress;
-	char*           string;
+	const char*     string;
 
 	node = get_node_from_item (item);
 	if (node == NULL)
@@ -165,18 +218,18 @@ static void bind_complete (GtkSignalListItemFactory* factory, GtkListItem* item,
 	node = node->base;
 	progress = ug_info_get (node->info, UgetProgressInfo);
 	if (progress && progress->total)
-		string = ug_str_from_int_unit (progress->complete, NULL);
+		string = get_text (item, UGTK_NODE_COLUMN_COMPLETE,
+				progress->complete, format_size);
 	else
-		string = NULL;
-	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string ? string : "");
-	ug_free (string);
+		string = "";
+	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string);
 }
 
 static void bind_total (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data)
 {
 	UgetNode*       node;
 	UgetProgress*   progress;
-	char*           string;
+	const char*     string;
 
 	node = get_node_from_item (item);
 	if (node == NULL)
@@ -184,11 +237,11 @@ static void bind_total (GtkSignalListItemFactory* factory, GtkListItem* item, gp
 	node = node->base;
 	progress = ug_info_get (node->info, UgetProgressInfo);
 	if (progress && progress->total)
-		string = ug_str_from_int_unit (progress->total, NULL);
+		string = get_text (item, UGTK_NODE_COLUMN_TOTAL,
+				progress->total, format_size);
 	else
-		string = NULL;
-	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string ? string : "");
-	ug_free (string);
+		string = "";
+	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string);
 }
 
 static void bind_percent (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data)
@@ -196,7 +249,7 @@ static void bind_percent (GtkSignalListItemFactory* factory, GtkListItem* item,
 	UgetNode*       node;
 	UgetProgress*   progress;
 	GtkProgressBar* bar;
-	char*           string;
+	const char*     string;
 
 	node = get_node_from_item (item);
 	bar = GTK_PROGRESS_BAR (gtk_list_item_get_child (item));
@@ -208,11 +261,11 @@ static void bind_percent (GtkSignalListItemFactory* factory, GtkListItem* item,
 	node = node->base;
 	progress = ug_info_get (node->info, UgetProgressInfo);
 	if (progress && progress->total) {
-		string = ug_strdup_printf ("%d%c", progress->percent, '%');
+		string = get_text (item, UGTK_NODE_COLUMN_PERCENT,
+				progress->percent, format_percent);
 		gtk_progress_bar_set_fraction (bar, progress->percent / 100.0);
 		gtk_progress_bar_set_text (bar, string);
 		gtk_widget_set_visible (GTK_WIDGET (bar), TRUE);
-		ug_free (string);
 	}
 	else {
 		gtk_progress_bar_set_fraction (bar, 0.0);
@@ -225,7 +278,7 @@ static void bind_elapsed (GtkSignalListItemFactory* factory, GtkListItem* item,
 {
 	UgetNode*     node;
 	UgetProgress* progress;
-	char*         string;
+	const char*   string;
 
 	node = get_node_from_item (item);
 	if (node == NULL)
@@ -233,11 +286,11 @@ static void bind_elapsed (GtkSignalListItemFactory* factory, GtkListItem* item,
 	node = node->base;
 	progress = ug_info_get (node->info, UgetProgressInfo);
 	if (progress)
-		string = ug_str_from_seconds ((int) progress->elapsed, TRUE);
+		string = get_text (item, UGTK_NODE_COLUMN_ELAPSED,
+				progress->elapsed, format_seconds);
 	else
-		string = NULL;
-	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string ? string : "");
-	ug_free (string);
+		string = "";
+	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string);
 }
 
 static void bind_left (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data)
@@ -245,7 +298,7 @@ static void bind_left (GtkSignalListItemFactory* factory, GtkListItem* item, gpo
 	UgetNode*     node;
 	UgetProgress* progress;
 	UgetRelation* relation;
-	char*         string;
+	const char*   string;
 
 	node = get_node_from_item (item);
 	if (node == NULL)
@@ -254,11 +307,11 @@ static void bind_left (GtkSignalListItemFactory* factory, GtkListItem* item, gpo
 	progress = ug_info_get (node->info, UgetProgressInfo);
 	relation = ug_info_get (node->info, UgetRelationInfo);
 	if (progress && relation && relation->task)
-		string = ug_str_from_seconds ((int) progress->left, TRUE);
+		string = get_text (item, UGTK_NODE_COLUMN_LEFT,
+				progress->left, format_seconds);
 	else
-		string = NULL;
-	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string ? string : "");
-	ug_free (string);
+		string = "";
+	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string);
 }
 
 static void bind_speed (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data)
@@ -266,7 +319,7 @@ static void bind_speed (GtkSignalListItemFactory* factory, GtkListItem* item, gp
 	UgetNode*     node;
 	UgetProgress* progress;
 	UgetRelation* relation;
-	char*         string;
+	const char*   string;
 
 	node = get_node_from_item (item);
 	if (node == NULL)
@@ -275,11 +328,11 @@ static void bind_speed (GtkSignalListItemFactory* factory, GtkListItem* item, gp
 	progress = ug_info_get (node->info, UgetProgressInfo);
 	relation = ug_info_get (node->info, UgetRelationInfo);
 	if (progress && relation && relation->task)
-		string = ug_str_from_int_unit (progress->download_speed, "/s");
+		string = get_text (item, UGTK_NODE_COLUMN_SPEED,
+				progress->download_speed, format_speed);
 	else
-		string = NULL;
-	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string ? string : "");
-	ug_free (string);
+		string = "";
+	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string);
 }
 
 static void bind_upload_speed (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data)
@@ -287,7 +340,7 @@ static void bind_upload_speed (GtkSignalListItemFactory* factory, GtkListItem* i
 	UgetNode*     node;
 	UgetProgress* progress;
 	UgetRelation* relation;
-	char*         string;
+	const char*   string;
 
 	node = get_node_from_item (item);
 	if (node == NULL)
@@ -296,18 +349,18 @@ static void bind_upload_speed (GtkSignalListItemFactory* factory, GtkListItem* i
 	progress = ug_info_get (node->info, UgetProgressInfo);
 	relation = ug_info_get (node->info, UgetRelationInfo);
 	if (progress && relation && relation->task && progress->upload_speed)
-		string = ug_str_from_int_unit (progress->upload_speed, "/s");
+		string = get_text (item, UGTK_NODE_COLUMN_UPLOAD_SPEED,
+				progress->upload_speed, format_speed);
 	else
-		string = NULL;
-	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string ? string : "");
-	ug_free (string);
+		string = "";
+	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string);
 }
 
 static void bind_uploaded (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data)
 {
 	UgetNode*     node;
 	UgetProgress* progress;
-	char*         string;
+	const char*   string;
 
 	node = get_node_from_item (item);
 	if (node == NULL)
@@ -315,18 +368,18 @@ static void bind_uploaded (GtkSignalListItemFactory* factory, GtkListItem* item,
 	node = node->base;
 	progress = ug_info_get (node->info, UgetProgressInfo);
 	if (progress && progress->uploaded)
-		string = ug_str_from_int_unit (progress->uploaded, NULL);
+		string = get_text (item, UGTK_NODE_COLUMN_UPLOADED,
+				progress->uploaded, format_size);
 	else
-		string = NULL;
-	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string ? string : "");
-	ug_free (string);
+		string = "";
+	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string);
 }
 
 static void bind_ratio (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data)
 {
 	UgetNode*     node;
 	UgetProgress* progress;
-	char*         string;
+	const char*   string;
 
 	node = get_node_from_item (item);
 	if (node == NULL)
@@ -334,11 +387,11 @@ static void bind_ratio (GtkSignalListItemFactory* factory, GtkListItem* item, gp
 	node = node->base;
 	progress = ug_info_get (node->info, UgetProgressInfo);
 	if (progress && progress->ratio)
-		string = ug_strdup_printf ("%.2f", progress->ratio);
+		string = get_text (item, UGTK_NODE_COLUMN_RATIO,
+				(int64_t) (progress->ratio * 100 + 0.5), format_ratio);
 	else
-		string = NULL;
-	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string ? string : "");
-	ug_free (string);
+		string = "";
+	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string);
 }
 
 static void bind_retry (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data)
@@ -408,7 +461,7 @@ static void bind_added_on (GtkSignalListItemFactory* factory, GtkListItem* item,
 {
 	UgetNode*   node;
 	UgetLog*    ulog;
-	char*       string;
+	const char* string;
 
 	node = get_node_from_item (item);
 	if (node == NULL)
@@ -416,18 +469,18 @@ static void bind_added_on (GtkSignalListItemFactory* factory, GtkListItem* item,
 	node = node->base;
 	ulog = ug_info_get (node->info, UgetLogInfo);
 	if (ulog && ulog->added_time)
-		string = ug_str_from_time (ulog->added_time, FALSE);
+		string = get_text (item, UGTK_NODE_COLUMN_ADDED_ON,
+				ulog->added_time, format_time);
 	else
-		string = NULL;
-	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string ? string : "");
-	ug_free (string);
+		string = "";
+	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string);
 }
 
 static void bind_completed_on (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data)
 {
 	UgetNode*   node;
 	UgetLog*    ulog;
-	char*       string;
+	const char* string;
 
 	node = get_node_from_item (item);
 	if (node == NULL)
@@ -435,11 +488,11 @@ static void bind_completed_on (GtkSignalListItemFactory* factory, GtkListItem* i
 	node = node->base;
 	ulog = ug_info_get (node->info, UgetLogInfo);
 	if (ulog && ulog->completed_time)
-		string = ug_str_from_time (ulog->completed_time, FALSE);
+		string = get_text (item, UGTK_NODE_COLUMN_COMPLETED_ON,
+				ulog->completed_time, format_time);
 	else
-		string = NULL;
-	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string ? string : "");
-	ug_free (string);
+		string = "";
+	gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (item)), string);
 }
 
 // ------------------------------------
@@ -482,6 +535,18 @@ static void setup_sidebar_row (GtkSignalListItemFactory* factory, GtkListItem* i
 	gtk_list_item_set_child (item, box);
 }
 
+static void set_quantity (GtkListItem* item, GtkWidget* qty_label)
+{
+	UgtkNodeObject* obj;
+	gchar*          quantity;
+
+	obj = gtk_list_item_get_item (item);
+	obj->quantity = obj->node->n_children;
+	quantity = ug_strdup_printf ("%u", obj->quantity);
+	gtk_label_set_text (GTK_LABEL (qty_label), quantity);
+	ug_free (quantity);
+}
+
 static void bind_category_row (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data)
 {
 	UgetNode*    node;
@@ -490,7 +555,6 @@ static void bind_category_row (GtkSignalListItemFactory* factory, GtkListItem* i
 	GtkWidget*   image;
 	GtkWidget*   name_label;
 	GtkWidget*   qty_label;
-	gchar*       quantity;
 
 	node = get_node_from_item (item);
 	if (node == NULL)
@@ -515,9 +579,7 @@ static void bind_category_row (GtkSignalListItemFactory* factory, GtkListItem* i
 		gtk_label_set_text (GTK_LABEL (name_label), _("unnamed"));
 
 	// quantity
-	quantity = ug_strdup_printf ("%u", node->n_children);
-	gtk_label_set_text (GTK_LABEL (qty_label), quantity);
-	ug_free (quantity);
+	set_quantity (item, qty_label);
 }
 
 static void bind_state_row (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data)
@@ -529,7 +591,6 @@ static void bind_state_row (GtkSignalListItemFactory* factory, GtkListItem* item
 	GtkWidget*     qty_label;
 	const gchar*   icon_name;
 	char*          name;
-	gchar*         quantity;
 	int            key, index, group;
 
 	node = get_node_from_item (item);
@@ -570,9 +631,74 @@ static void bind_state_row (GtkSignalListItemFactory* factory, GtkListItem* item
 	gtk_label_set_text (GTK_LABEL (name_label), name);
 
 	// quantity
-	quantity = ug_strdup_printf ("%u", node->n_children);
-	gtk_label_set_text (GTK_LABEL (qty_label), quantity);
-	ug_free (quantity);
+	set_quantity (item, qty_label);
+}
+
+// ------------------------------------
+// Bound cells: every factory records GtkListItem of bound cells by
+// UgtkNodeObject (it is unique for each UgetNode and referenced by bound
+// GtkListItem). ugtk_node_view_update() use it to rebind cells of a row
+// without emitting items-changed (that rebind all cells of row and drop
+// selection of row).
+
+typedef struct UgtkNodeCell     UgtkNodeCell;
+typedef void (*UgtkNodeBindFunc) (GtkSignalListItemFactory* factory, GtkListItem* item, gpointer data);
+
+struct UgtkNodeCell
+{
+	GHashTable*       rows;    // key: UgtkNodeObject*, value: GPtrArray of GtkListItem*
+	UgtkNodeBindFunc  bind;
+	int               column;  // UgtkNodeColumn
+};
+
+static GHashTable* rows_new (void)
+{
+	return g_hash_table_new_full (g_direct_hash, g_direct_equal,
+	                              NULL, (GDestroyNotify) g_ptr_array_unref);
+}
+
+static void cell_free (UgtkNodeCell* cell, GClosure* closure)
+{
+	g_hash_table_unref (cell->rows);
+	g_free (cell);
+}
+
+static void setup_cell (GtkSignalListItemFactory* factory, GtkListItem* item, UgtkNodeCell* cell)
+{
+	g_object_set_data (G_OBJECT (item), "node-view-cell", cell);
+}
+
+static void bind_cell (GtkSignalListItemFactory* factory, GtkListItem* item, UgtkNodeCell* cell)
+{
+	UgtkNodeObject* obj;
+	GPtrArray*      items;
+
+	obj = gtk_list_item_get_item (item);
+	if (obj) {
+		items = g_hash_table_lookup (cell->rows, obj);
+		if (items == NULL) {
+			items = g_ptr_array_new ();
+			g_hash_table_insert (cell->rows, obj, items);
+		}
+		g_ptr_array_add (items, item);
+	}
+	cell->bind (factory, item, NULL);
+}
+
+static void unbind_cell (GtkSignalListItemFactory* factory, GtkListItem* item, UgtkNodeCell* cell)
+{
+	UgtkNodeObject* obj;
+	GPtrArray*      items;
+
+	obj = gtk_list_item_get_item (item);
+	if (obj == NULL)
+		return;
+	items = g_hash_table_lookup (cell->rows, obj);
+	if (items) {
+		g_ptr_array_remove_fast (items, item);
+		if (items->len == 0)
+			g_hash_table_remove (cell->rows, obj);
+	}
 }
 
 // ------------------------------------
@@ -583,13 +709,23 @@ static void teardown_item (GtkSignalListItemFactory* factory, GtkListItem* item,
 	gtk_list_item_set_child (item, NULL);
 }
 
-static GtkListItemFactory* make_factory (GCallback setup_fn, GCallback bind_fn)
+static GtkListItemFactory* make_factory (GHashTable* rows, int column,
+                                         GCallback setup_fn, GCallback bind_fn)
 {
 	GtkListItemFactory* factory;
+	UgtkNodeCell*       cell;
+
+	cell = g_new (UgtkNodeCell, 1);
+	cell->rows = g_hash_table_ref (rows);
+	cell->bind = (UgtkNodeBindFunc) bind_fn;
+	cell->column = column;
 
 	factory = gtk_signal_list_item_factory_new ();
 	g_signal_connect (factory, "setup", setup_fn, NULL);
-	g_signal_connect (factory, "bind",  bind_fn,  NULL);
+	g_signal_connect (factory, "setup", G_CALLBACK (setup_cell), cell);
+	g_signal_connect_data (factory, "bind", G_CALLBACK (bind_cell),
+	                       cell, (GClosureNotify) cell_free, 0);
+	g_signal_connect (factory, "unbind", G_CALLBACK (unbind_cell), cell);
 	g_signal_connect (factory, "teardown", G_CALLBACK (teardown_item), NULL);
 	return factory;
 }
@@ -620,74 +756,94 @@ GtkWidget* ugtk_node_view_new_for_download (void)
 {
 	GtkColumnView*  view;
 	GtkListItemFactory* factory;
+	GHashTable*     rows;
 
 	view = GTK_COLUMN_VIEW (gtk_column_view_new (NULL));
 	gtk_column_view_set_show_column_separators (view, TRUE);
+	rows = rows_new ();
 
 	// UGTK_NODE_COLUMN_STATE (icon)
-	factory = make_factory (G_CALLBACK (setup_icon), G_CALLBACK (bind_icon));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_STATE,
+	                        G_CALLBACK (setup_icon), G_CALLBACK (bind_icon));
 	add_column (view, "", factory, 28, FALSE, FALSE);
 
 	// UGTK_NODE_COLUMN_NAME
-	factory = make_factory (G_CALLBACK (setup_label), G_CALLBACK (bind_name));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_NAME,
+	                        G_CALLBACK (setup_label), G_CALLBACK (bind_name));
 	add_column (view, _("Name"), factory, 180, TRUE, TRUE);
 
 	// UGTK_NODE_COLUMN_COMPLETE
-	factory = make_factory (G_CALLBACK (setup_label_right), G_CALLBACK (bind_complete));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_COMPLETE,
+	                        G_CALLBACK (setup_label_right), G_CALLBACK (bind_complete));
 	add_column (view, _("Complete"), factory, 70, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_TOTAL
-	factory = make_factory (G_CALLBACK (setup_label_right), G_CALLBACK (bind_total));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_TOTAL,
+	                        G_CALLBACK (setup_label_right), G_CALLBACK (bind_total));
 	add_column (view, _("Size"), factory, 70, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_PERCENT
-	factory = make_factory (G_CALLBACK (setup_progress), G_CALLBACK (bind_percent));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_PERCENT,
+	                        G_CALLBACK (setup_progress), G_CALLBACK (bind_percent));
 	add_column (view, _("%"), factory, 60, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_ELAPSED
-	factory = make_factory (G_CALLBACK (setup_label_right), G_CALLBACK (bind_elapsed));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_ELAPSED,
+	                        G_CALLBACK (setup_label_right), G_CALLBACK (bind_elapsed));
 	add_column (view, _("Elapsed"), factory, 65, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_LEFT
-	factory = make_factory (G_CALLBACK (setup_label_right), G_CALLBACK (bind_left));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_LEFT,
+	                        G_CALLBACK (setup_label_right), G_CALLBACK (bind_left));
 	add_column (view, _("Left"), factory, 65, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_SPEED
-	factory = make_factory (G_CALLBACK (setup_label_right), G_CALLBACK (bind_speed));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_SPEED,
+	                        G_CALLBACK (setup_label_right), G_CALLBACK (bind_speed));
 	add_column (view, _("Speed"), factory, 80, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_UPLOAD_SPEED
-	factory = make_factory (G_CALLBACK (setup_label_right), G_CALLBACK (bind_upload_speed));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_UPLOAD_SPEED,
+	                        G_CALLBACK (setup_label_right), G_CALLBACK (bind_upload_speed));
 	add_column (view, _("Up Speed"), factory, 80, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_UPLOADED
-	factory = make_factory (G_CALLBACK (setup_label_right), G_CALLBACK (bind_uploaded));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_UPLOADED,
+	                        G_CALLBACK (setup_label_right), G_CALLBACK (bind_uploaded));
 	add_column (view, _("Uploaded"), factory, 70, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_RATIO
-	factory = make_factory (G_CALLBACK (setup_label_right), G_CALLBACK (bind_ratio));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_RATIO,
+	                        G_CALLBACK (setup_label_right), G_CALLBACK (bind_ratio));
 	add_column (view, _("Ratio"), factory, 45, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_RETRY
-	factory = make_factory (G_CALLBACK (setup_label_right), G_CALLBACK (bind_retry));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_RETRY,
+	                        G_CALLBACK (setup_label_right), G_CALLBACK (bind_retry));
 	add_column (view, _("Retry"), factory, 45, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_CATEGORY
-	factory = make_factory (G_CALLBACK (setup_label), G_CALLBACK (bind_category));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_CATEGORY,
+	                        G_CALLBACK (setup_label), G_CALLBACK (bind_category));
 	add_column (view, _("Category"), factory, 100, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_URI
-	factory = make_factory (G_CALLBACK (setup_label), G_CALLBACK (bind_uri));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_URI,
+	                        G_CALLBACK (setup_label), G_CALLBACK (bind_uri));
 	add_column (view, _("URI"), factory, 300, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_ADDED_ON
-	factory = make_factory (G_CALLBACK (setup_label), G_CALLBACK (bind_added_on));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_ADDED_ON,
+	                        G_CALLBACK (setup_label), G_CALLBACK (bind_added_on));
 	add_column (view, _("Added On"), factory, 140, TRUE, FALSE);
 
 	// UGTK_NODE_COLUMN_COMPLETED_ON
-	factory = make_factory (G_CALLBACK (setup_label), G_CALLBACK (bind_completed_on));
+	factory = make_factory (rows, UGTK_NODE_COLUMN_COMPLETED_ON,
+	                        G_CALLBACK (setup_label), G_CALLBACK (bind_completed_on));
 	add_column (view, _("Completed On"), factory, 140, TRUE, FALSE);
 
+	g_object_set_data_full (G_OBJECT (view), "node-view-rows",
+	                        rows, (GDestroyNotify) g_hash_table_unref);
 	gtk_widget_set_visible (GTK_WIDGET (view), TRUE);
 	return GTK_WIDGET (view);
 }
@@ -696,11 +852,16 @@ GtkWidget* ugtk_node_view_new_for_category (void)
 {
 	GtkListView*        view;
 	GtkListItemFactory* factory;
+	GHashTable*         rows;
 
-	factory = make_factory (G_CALLBACK (setup_sidebar_row),
+	rows = rows_new ();
+	factory = make_factory (rows, UGTK_NODE_COLUMN_STATE,
+	                        G_CALLBACK (setup_sidebar_row),
 	                        G_CALLBACK (bind_category_row));
 	view = GTK_LIST_VIEW (gtk_list_view_new (NULL, factory));
 	gtk_list_view_set_show_separators (view, FALSE);
+	g_object_set_data_full (G_OBJECT (view), "node-view-rows",
+	                        rows, (GDestroyNotify) g_hash_table_unref);
 	gtk_widget_set_visible (GTK_WIDGET (view), TRUE);
 	return GTK_WIDGET (view);
 }
@@ -709,11 +870,129 @@ GtkWidget* ugtk_node_view_new_for_state (void)
 {
 	GtkListView*        view;
 	GtkListItemFactory* factory;
+	GHashTable*         rows;
 
-	factory = make_factory (G_CALLBACK (setup_sidebar_row),
+	rows = rows_new ();
+	factory = make_factory (rows, UGTK_NODE_COLUMN_STATE,
+	                        G_CALLBACK (setup_sidebar_row),
 	                        G_CALLBACK (bind_state_row));
 	view = GTK_LIST_VIEW (gtk_list_view_new (NULL, factory));
 	gtk_list_view_set_show_separators (view, FALSE);
+	g_object_set_data_full (G_OBJECT (view), "node-view-rows",
+	                        rows, (GDestroyNotify) g_hash_table_unref);
 	gtk_widget_set_visible (GTK_WIDGET (view), TRUE);
 	return GTK_WIDGET (view);
 }
+
+void  ugtk_node_view_update (GtkWidget* view, UgetNode* node, guint columns)
+{
+	UgtkNodeCell* cell;
+	GtkListItem*  item;
+	GHashTable*   rows;
+	GPtrArray*    items;
+	guint         index;
+
+	// node has no UgtkNodeObject if it has never been shown
+	if (node->data == NULL)
+		return;
+	rows = g_object_get_data (G_OBJECT (view), "node-view-rows");
+	if (rows == NULL)
+		return;
+	items = g_hash_table_lookup (rows, node->data);
+	if (items == NULL)
+		return;
+	for (index = 0;  index < items->len;  index++) {
+		item = g_ptr_array_index (items, index);
+		cell = g_object_get_data (G_OBJECT (item), "node-view-cell");
+		if (columns & (1 << cell->column))
+			cell->bind (NULL, item, NULL);
+	}
+}
+
+void  ugtk_node_view_update_progress (GtkWidget* view, UgetNode* node)
+{
+	UgtkNodeObject* obj;
+	UgetProgress*   progress;
+
+	obj = node->data;
+	if (obj == NULL)
+		return;
+	progress = ug_info_get (node->info, UgetProgressInfo);
+	if (progress == NULL || progress->generation == obj->generation)
+		return;
+	obj->generation = progress->generation;
+	ugtk_node_view_update (view, node, UGTK_NODE_VIEW_UPDATE_PROGRESS);
+}
+
+void  ugtk_node_view_update_changed (GtkWidget* view, UgetNode* node)
+{
+	UgtkNodeObject* obj;
+	UgetCommon*     common;
+	UgetRelation*   relation;
+	unsigned int    generation;
+	int             group;
+
+	obj = node->data;
+	if (obj == NULL)
+		return;
+	common = ug_info_get (node->info, UgetCommonInfo);
+	relation = ug_info_get (node->info, UgetRelationInfo);
+	generation = (common) ? common->generation : 0;
+	group = (relation) ? relation->group : 0;
+	if (generation == obj->common_generation && group == obj->group)
+		return;
+	obj->common_generation = generation;
+	obj->group = group;
+	ugtk_node_view_update (view, node, ~UGTK_NODE_VIEW_UPDATE_PROGRESS);
+}
+
+void  ugtk_node_view_update_bound (GtkWidget* view, guint columns)
+{
+	UgtkNodeCell*  cell;
+	GtkListItem*   item;
+	GHashTable*    rows;
+	GHashTableIter iter;
+	GPtrArray*     items;
+	guint          index;
+
+	rows = g_object_get_data (G_OBJECT (view), "node-view-rows");
+	if (rows == NULL)
+		return;
+	g_hash_table_iter_init (&iter, rows);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer*) &items)) {
+		for (index = 0;  index < items->len;  index++) {
+			item = g_ptr_array_index (items, index);
+			cell = g_object_get_data (G_OBJECT (item), "node-view-cell");
+			if (columns & (1 << cell->column))
+				cell->bind (NULL, item, NULL);
+		}
+	}
+}
+
+void  ugtk_node_view_update_quantity (GtkWidget* view)
+{
+	UgtkNodeObject* obj;
+	UgtkNodeCell*   cell;
+	GtkListItem*    item;
+	GHashTable*     rows;
+	GHashTableIter  iter;
+	GPtrArray*      items;
+	guint           index;
+
+	rows = g_object_get_data (G_OBJECT (view), "node-view-rows");
+	if (rows == NULL)
+		return;
+	g_hash_table_iter_init (&iter, rows);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer*) &items)) {
+		for (index = 0;  index < items->len;  index++) {
+			item = g_ptr_array_index (items, index);
+			obj = gtk_list_item_get_item (item);
+			if (obj == NULL || obj->node == NULL)
+				continue;
+			if (obj->quantity == obj->node->n_children)
+				continue;
+			cell = g_object_get_data (G_OBJECT (item), "node-view-cell");
+			cell->bind (NULL, item, NULL);
+		}
+	}
+}
@@ -38,6 +38,7 @@
 #define UGTK_NODE_VIEW_H
 
 #include <gtk/gtk.h>
+#include <UgetNode.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -76,6 +77,35 @@ GtkWidget*  ugtk_node_view_new_for_download (void);
 GtkWidget*  ugtk_node_view_new_for_category (void);
 GtkWidget*  ugtk_node_view_new_for_state (void);
 
+// 'columns' for ugtk_node_view_update()
+#define UGTK_NODE_VIEW_UPDATE_ALL        (~0u)
+#define UGTK_NODE_VIEW_UPDATE_PROGRESS   ( \
+		(1 << UGTK_NODE_COLUMN_COMPLETE)     | \
+		(1 << UGTK_NODE_COLUMN_TOTAL)        | \
+		(1 << UGTK_NODE_COLUMN_PERCENT)      | \
+		(1 << UGTK_NODE_COLUMN_ELAPSED)      | \
+		(1 << UGTK_NODE_COLUMN_LEFT)         | \
+		(1 << UGTK_NODE_COLUMN_SPEED)        | \
+		(1 << UGTK_NODE_COLUMN_UPLOAD_SPEED) | \
+		(1 << UGTK_NODE_COLUMN_UPLOADED)     | \
+		(1 << UGTK_NODE_COLUMN_RATIO)        )
+
+// Rebind cells of 'node' that are visible in 'view'. It doesn't emit
+// items-changed, so other cells and selection of row are not touched.
+// 'columns' is bit mask of (1 << UgtkNodeColumn).
+void  ugtk_node_view_update (GtkWidget* view, UgetNode* node, guint columns);
+// Rebind progress cells of 'node' only if UgetProgress.generation changed
+// since they were rebound by this function last time.
+void  ugtk_node_view_update_progress (GtkWidget* view, UgetNode* node);
+// Rebind other cells of 'node' only if UgetCommon.generation or
+// UgetRelation.group changed since they were rebound by this function.
+void  ugtk_node_view_update_changed (GtkWidget* view, UgetNode* node);
+// Rebind cells of all rows that are visible in 'view'.
+void  ugtk_node_view_update_bound (GtkWidget* view, guint columns);
+// Rebind rows of sidebar (category & state) only if their quantity
+// (UgetNode.n_children) changed since they were bound last time.
+void  ugtk_node_view_update_quantity (GtkWidget* view);
+
 #ifdef __cplusplus
 }
 #endif
@@ -198,8 +198,8 @@ void  ugtk_proxy_form_get (UgtkProxyForm* pform, UgInfo* node_info)
 	proxy->password = (*text) ? ug_strdup (text) : NULL;
 	// host
 	text = gtk_editable_get_text ((GtkEditable*)pform->host);
-	ug_free (proxy->host);
-	proxy->host = (*text) ? ug_strdup (text) : NULL;
+	ug_str_unintern (proxy->host);
+	proxy->host = (*text) ? ug_str_intern (text) : NULL;
 
 	proxy->port = gtk_spin_button_get_value_as_int ((GtkSpinButton*) pform->port);
 
@@ -311,6 +311,8 @@ static const UgEntry  UgtkPluginAria2SettingEntry[] =
 			UG_ENTRY_STRING,  NULL,   NULL},
 	{"uri",       offsetof (struct UgtkPluginAria2Setting, uri),
 			UG_ENTRY_STRING,  NULL,   NULL},
+	{"UnixSocket", offsetof (struct UgtkPluginAria2Setting, unix_socket),
+			UG_ENTRY_STRING,  NULL,   NULL},
 	{"MaxUploadSpeed",   offsetof (struct UgtkPluginAria2Setting, limit.upload),
 			UG_ENTRY_INT,     NULL,   NULL},
 	{"MaxDownloadSpeed", offsetof (struct UgtkPluginAria2Setting, limit.download),
@@ -538,6 +540,8 @@ int  ugtk_setting_save (UgtkSetting* setting, const char* file)
 
 	path = g_strconcat (file, ".temp", NULL);
 	jfile = ug_json_file_new (4096);
+	// temp file will be renamed, sync data only.
+	ug_json_file_set_sync (jfile, UG_JSON_FILE_SYNC_DATA);
 	if (ug_json_file_begin_write (jfile, path, UG_JSON_FORMAT_ALL) == FALSE) {
 		ug_json_file_free (jfile);
 		g_free (path);
@@ -226,6 +226,7 @@ struct UgtkSetting
 		char*  path;
 		char*  args;
 		char*  uri;
+		char*  unix_socket;  // HTTP through local Unix socket proxy
 	} aria2;
 
 	// UgetPluginMedia option
@@ -594,6 +594,16 @@ void  ugtk_plugin_form_init (struct UgtkPluginForm* psform)
 	gtk_widget_set_hexpand (widget, TRUE);
 	gtk_box_append (hbox, widget);
 	psform->token = (GtkEntry*) widget;
+	// Unix socket entry
+	hbox = (GtkBox*) gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+	gtk_box_append (vbox, (GtkWidget*) hbox);
+	widget = gtk_label_new (_("Unix socket path (optional)"));
+	gtk_box_append (hbox, widget);
+	widget = gtk_entry_new ();
+	gtk_entry_set_activates_default (GTK_ENTRY (widget), TRUE);
+	gtk_widget_set_hexpand (widget, TRUE);
+	gtk_box_append (hbox, widget);
+	psform->unix_socket = (GtkEntry*) widget;
 
 	// ------------------------------------------------------------------------
 	// Speed Limits
@@ -711,6 +721,8 @@ void  ugtk_plugin_form_set (struct UgtkPluginForm* psform, UgtkSetting* setting)
 		gtk_editable_set_text (GTK_EDITABLE (psform->uri),  setting->aria2.uri);
 	if (setting->aria2.token)
 		gtk_editable_set_text (GTK_EDITABLE (psform->token),  setting->aria2.token);
+	if (setting->aria2.unix_socket)
+		gtk_editable_set_text (GTK_EDITABLE (psform->unix_socket),  setting->aria2.unix_socket);
 	if (setting->aria2.path)
 		gtk_editable_set_text (GTK_EDITABLE (psform->path), setting->aria2.path);
 //	if (setting->aria2.args)
@@ -727,6 +739,7 @@ void  ugtk_plugin_form_get (struct UgtkPluginForm* psform, UgtkSetting* setting)
 	GtkTextIter  iter1;
 	GtkTextIter  iter2;
 	const char*  token;
+	const char*  unix_socket;
 
 	setting->plugin_order = gtk_drop_down_get_selected (psform->order);
 
@@ -735,6 +748,7 @@ void  ugtk_plugin_form_get (struct UgtkPluginForm* psform, UgtkSetting* setting)
 
 	ug_free (setting->aria2.uri);
 	ug_free (setting->aria2.token);
+	ug_free (setting->aria2.unix_socket);
 	ug_free (setting->aria2.path);
 	ug_free (setting->aria2.args);
 	setting->aria2.uri = (gchar*) ug_strdup (gtk_editable_get_text (GTK_EDITABLE (psform->uri)));
@@ -743,6 +757,11 @@ void  ugtk_plugin_form_get (struct UgtkPluginForm* psform, UgtkSetting* setting)
 		setting->aria2.token = NULL;
 	else
 		setting->aria2.token = (gchar*) ug_strdup (token);
+	unix_socket = gtk_editable_get_text (GTK_EDITABLE (psform->unix_socket));
+	if (unix_socket[0] == 0)
+		setting->aria2.unix_socket = NULL;
+	else
+		setting->aria2.unix_socket = (gchar*) ug_strdup (unix_socket);
 	setting->aria2.path = (gchar*) ug_strdup (gtk_editable_get_text (GTK_EDITABLE (psform->path)));
 //	setting->aria2.args = ug_strdup (gtk_entry_get_text (psform->args));
 	gtk_text_buffer_get_start_iter (psform->args_buffer, &iter1);
@@ -168,6 +168,7 @@ struct UgtkPluginForm
 	GtkCheckButton*     shutdown;
 	GtkEntry*           uri;
 	GtkEntry*           token;
+	GtkEntry*           unix_socket;
 	GtkWidget*          local;  // GtkFrame
 	GtkEntry*           path;
 	GtkWidget*          args;   // GtkTextView
@@ -34,30 +34,45 @@
  *
  */
 
+#include <string.h>
 #include <UgetNode.h>
 #include <UgetData.h>
 #include <UgtkSummary.h>
 
 #include <glib/gi18n.h>
 
-static void ugtk_summary_add_row (UgtkSummary* summary,
-                                   const gchar* icon_name,
-                                   const gchar* name,
-                                   const gchar* value);
-static void ugtk_summary_clear (UgtkSummary* summary);
+static void setup_row (GtkSignalListItemFactory* factory, GtkListItem* item, UgtkSummary* summary);
+static void bind_row (GtkSignalListItemFactory* factory, GtkListItem* item, UgtkSummary* summary);
 
 void  ugtk_summary_init (UgtkSummary* summary, gpointer accel_group)
 {
 	GtkScrolledWindow*	scroll;
+	GtkListItemFactory* factory;
 
-	summary->list_box = GTK_LIST_BOX (gtk_list_box_new ());
-	gtk_list_box_set_selection_mode (summary->list_box, GTK_SELECTION_SINGLE);
+	summary->names.name     = g_strconcat (_("Name"), ":", NULL);
+	summary->names.file     = g_strconcat (_("File"), ":", NULL);
+	summary->names.folder   = g_strconcat (_("Folder"), ":", NULL);
+	summary->names.category = g_strconcat (_("Category"), ":", NULL);
+	summary->names.uri      = g_strconcat (_("URI"), ":", NULL);
+	summary->names.message  = g_strconcat (_("Message"), ":", NULL);
+
+	summary->values = gtk_string_list_new (NULL);
+	summary->selection = gtk_single_selection_new (
+			G_LIST_MODEL (g_object_ref (summary->values)));
+	gtk_single_selection_set_autoselect (summary->selection, FALSE);
+	gtk_single_selection_set_can_unselect (summary->selection, TRUE);
+
+	factory = gtk_signal_list_item_factory_new ();
+	g_signal_connect (factory, "setup", G_CALLBACK (setup_row), summary);
+	g_signal_connect (factory, "bind", G_CALLBACK (bind_row), summary);
+	summary->view = GTK_LIST_VIEW (gtk_list_view_new (
+			GTK_SELECTION_MODEL (summary->selection), factory));
 
 	summary->self = gtk_scrolled_window_new ();
 	scroll = GTK_SCROLLED_WINDOW (summary->self);
 	gtk_scrolled_window_set_policy (scroll,
 			GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
-	gtk_scrolled_window_set_child (scroll, GTK_WIDGET (summary->list_box));
+	gtk_scrolled_window_set_child (scroll, GTK_WIDGET (summary->view));
 	gtk_widget_set_size_request (summary->self, 200, 90);
 
 	// visible
@@ -66,155 +81,178 @@ void  ugtk_summary_init (UgtkSummary* summary, gpointer accel_group)
 	summary->visible.category = 0;
 	summary->visible.uri = 0;
 	summary->visible.message = 1;
+
+	summary->shown.node = NULL;
+	summary->shown.common = 0;
+	summary->shown.log = 0;
 }
 
 void  ugtk_summary_show (UgtkSummary* summary, UgetNode* node)
 {
-	gchar*        name;
-	gchar*        value;
-	gchar*        stock;
+	UgtkSummaryRow  rows[UGTK_SUMMARY_MAX_ROWS];
+	const gchar*    values[UGTK_SUMMARY_MAX_ROWS + 1];
+	const gchar*    value;
+	guint           n_rows;
+	guint           n_old;
+	guint           head;
+	guint           tail;
 	union {
 		UgetLog*      log;
 		UgetEvent*    event;
 		UgetCommon*   common;
 	} temp;
 
-	ugtk_summary_clear (summary);
+	summary->shown.node = node;
+	summary->shown.common = 0;
+	summary->shown.log = 0;
 
-	if (node == NULL)
-		return;
+	n_rows = 0;
+	if (node) {
+		temp.common = ug_info_get (node->info, UgetCommonInfo);
+		if (temp.common)
+			summary->shown.common = temp.common->generation;
+		temp.log = ug_info_get (node->info, UgetLogInfo);
+		if (temp.log)
+			summary->shown.log = temp.log->generation;
+		temp.common = ug_info_get (node->info, UgetCommonInfo);
 
-	temp.common = ug_info_get (node->info, UgetCommonInfo);
-
-	// Summary Name
-	if (summary->visible.name) {
-		if (temp.common && temp.common->name) {
-			name = g_strconcat (_("Name"), ":", NULL);
-			value = temp.common->name;
-		}
-		else {
-			name = g_strconcat (_("File"), ":", NULL);
-			value = (temp.common) ? temp.common->file : NULL;
-			if (value == NULL)
-				value = _("unnamed");
+		// Summary Name
+		if (summary->visible.name) {
+			if (temp.common && temp.common->name) {
+				rows[n_rows].name = summary->names.name;
+				value = temp.common->name;
+			}
+			else {
+				rows[n_rows].name = summary->names.file;
+				value = (temp.common) ? temp.common->file : NULL;
+				if (value == NULL)
+					value = _("unnamed");
+			}
+			rows[n_rows].icon = "text-x-generic";
+			values[n_rows++] = value;
 		}
-		ugtk_summary_add_row (summary, "text-x-generic", name, value);
-		g_free (name);
-	}
-	// Summary Folder
-	if (summary->visible.folder) {
-		name = g_strconcat (_("Folder"), ":", NULL);
-		value = (temp.common) ? temp.common->folder : NULL;
-		ugtk_summary_add_row (summary, "folder", name, value);
-		g_free (name);
-	}
-	// Summary Category
-	if (summary->visible.category) {
-		name = g_strconcat (_("Category"), ":", NULL);
-		if (node->parent) {
-			temp.common = ug_info_get (node->parent->info, UgetCommonInfo);
-			value = (temp.common) ? temp.common->name : NULL;
-			temp.common = ug_info_get (node->info, UgetCommonInfo);
+		// Summary Folder
+		if (summary->visible.folder) {
+			rows[n_rows].icon = "folder";
+			rows[n_rows].name = summary->names.folder;
+			values[n_rows++] = (temp.common) ? temp.common->folder : NULL;
 		}
-		else
-			value = NULL;
-		ugtk_summary_add_row (summary, "view-list-symbolic", name, value);
-		g_free (name);
-	}
-	// Summary URL
-	if (summary->visible.uri) {
-		name = g_strconcat (_("URI"), ":", NULL);
-		value = (temp.common) ? temp.common->uri : NULL;
-		ugtk_summary_add_row (summary, "network-workgroup", name, value);
-		g_free (name);
-	}
-	// Summary Message
-	temp.log = ug_info_get (node->info, UgetLogInfo);
-	if (temp.log)
-		temp.event = (UgetEvent*) temp.log->messages.head;
-	if (summary->visible.message) {
-		if (temp.event == NULL) {
-			stock = "dialog-information";
+		// Summary Category
+		if (summary->visible.category) {
 			value = NULL;
+			if (node->parent) {
+				temp.common = ug_info_get (node->parent->info, UgetCommonInfo);
+				value = (temp.common) ? temp.common->name : NULL;
+				temp.common = ug_info_get (node->info, UgetCommonInfo);
+			}
+			rows[n_rows].icon = "view-list-symbolic";
+			rows[n_rows].name = summary->names.category;
+			values[n_rows++] = value;
+		}
+		// Summary URL
+		if (summary->visible.uri) {
+			rows[n_rows].icon = "network-workgroup";
+			rows[n_rows].name = summary->names.uri;
+			values[n_rows++] = (temp.common) ? temp.common->uri : NULL;
 		}
-		else {
-			value = temp.event->string;
-			switch (temp.event->type) {
-			case UGET_EVENT_ERROR:
-				stock = "dialog-error";
-				break;
-			case UGET_EVENT_WARNING:
-				stock = "dialog-warning";
-				break;
-			default:
-				stock = "dialog-information";
-				break;
+		// Summary Message: one row for each message, the newest is first.
+		if (summary->visible.message) {
+			temp.log = ug_info_get (node->info, UgetLogInfo);
+			temp.event = (temp.log) ? (UgetEvent*) temp.log->messages.head : NULL;
+			if (temp.event == NULL) {
+				rows[n_rows].icon = "dialog-information";
+				rows[n_rows].name = summary->names.message;
+				values[n_rows++] = NULL;
+			}
+			for (;  temp.event && n_rows < UGTK_SUMMARY_MAX_ROWS;  temp.event = temp.event->next) {
+				switch (temp.event->type) {
+				case UGET_EVENT_ERROR:
+					rows[n_rows].icon = "dialog-error";
+					break;
+				case UGET_EVENT_WARNING:
+					rows[n_rows].icon = "dialog-warning";
+					break;
+				default:
+					rows[n_rows].icon = "dialog-information";
+					break;
+				}
+				rows[n_rows].name = (temp.event->prev) ? "" : summary->names.message;
+				values[n_rows++] = temp.event->string;
 			}
 		}
-		name = g_strconcat (_("Message"), ":", NULL);
-		ugtk_summary_add_row (summary, stock, name, value);
-		g_free (name);
 	}
+	// GtkStringList can't store NULL
+	for (head = 0;  head < n_rows;  head++) {
+		if (values[head] == NULL)
+			values[head] = "";
+	}
+	values[n_rows] = NULL;
+
+	// find range of changed rows
+	n_old = g_list_model_get_n_items (G_LIST_MODEL (summary->values));
+	for (head = 0;  head < n_old && head < n_rows;  head++) {
+		if (rows[head].icon != summary->rows[head].icon ||
+		    rows[head].name != summary->rows[head].name ||
+		    strcmp (values[head], gtk_string_list_get_string (summary->values, head)) != 0)
+			break;
+	}
+	if (head == n_old && head == n_rows)
+		return;
+	for (tail = 0;  tail < n_old - head && tail < n_rows - head;  tail++) {
+		if (rows[n_rows-1-tail].icon != summary->rows[n_old-1-tail].icon ||
+		    rows[n_rows-1-tail].name != summary->rows[n_old-1-tail].name ||
+		    strcmp (values[n_rows-1-tail],
+		            gtk_string_list_get_string (summary->values, n_old-1-tail)) != 0)
+			break;
+	}
+
+	memcpy (summary->rows, rows, sizeof (UgtkSummaryRow) * n_rows);
+	values[n_rows - tail] = NULL;
+	gtk_string_list_splice (summary->values, head, n_old - head - tail, values + head);
 }
 
-gchar*  ugtk_summary_get_text_selected (UgtkSummary* summary)
+void  ugtk_summary_refresh (UgtkSummary* summary, UgetNode* node)
 {
-	GtkListBoxRow* row;
-	GtkWidget*     box;
-	GtkWidget*     child;
-	const gchar*   name = NULL;
-	const gchar*   value = NULL;
-
-	row = gtk_list_box_get_selected_row (summary->list_box);
-	if (row == NULL)
-		return NULL;
+	UgetCommon*  common;
+	UgetLog*     log;
 
-	box = gtk_list_box_row_get_child (row);
-	// children: image, name_label, value_label
-	child = gtk_widget_get_first_child (box);
-	if (child) child = gtk_widget_get_next_sibling (child);  // skip icon
-	if (child) {
-		name = gtk_label_get_text (GTK_LABEL (child));
-		child = gtk_widget_get_next_sibling (child);
+	if (node && node == summary->shown.node) {
+		common = ug_info_get (node->info, UgetCommonInfo);
+		log = ug_info_get (node->info, UgetLogInfo);
+		if ((common == NULL || common->generation == summary->shown.common) &&
+		    (log == NULL || log->generation == summary->shown.log))
+			return;
 	}
-	if (child)
-		value = gtk_label_get_text (GTK_LABEL (child));
+	else if (node == NULL && summary->shown.node == NULL)
+		return;
+
+	ugtk_summary_show (summary, node);
+}
+
+gchar*  ugtk_summary_get_text_selected (UgtkSummary* summary)
+{
+	guint  position;
+
+	position = gtk_single_selection_get_selected (summary->selection);
+	if (position == GTK_INVALID_LIST_POSITION)
+		return NULL;
 
-	return g_strconcat (name ? name : "", " ", value ? value : "", NULL);
+	return g_strconcat (summary->rows[position].name, " ",
+			gtk_string_list_get_string (summary->values, position), NULL);
 }
 
 gchar*  ugtk_summary_get_text_all (UgtkSummary* summary)
 {
 	GString*       gstr;
-	GtkWidget*     row;
-	GtkWidget*     box;
-	GtkWidget*     child;
-	const gchar*   name;
-	const gchar*   value;
-	int            index;
+	guint          n_rows;
+	guint          index;
 
 	gstr = g_string_sized_new (60);
-	for (index = 0; ; index++) {
-		row = GTK_WIDGET (gtk_list_box_get_row_at_index (summary->list_box, index));
-		if (row == NULL)
-			break;
-		box = gtk_list_box_row_get_child (GTK_LIST_BOX_ROW (row));
-		child = gtk_widget_get_first_child (box);
-		if (child) child = gtk_widget_get_next_sibling (child);  // skip icon
-		name = NULL;
-		value = NULL;
-		if (child) {
-			name = gtk_label_get_text (GTK_LABEL (child));
-			child = gtk_widget_get_next_sibling (child);
-		}
-		if (child)
-			value = gtk_label_get_text (GTK_LABEL (child));
-		if (name)
-			g_string_append (gstr, name);
-		if (value) {
-			g_string_append_c (gstr, ' ');
-			g_string_append (gstr, value);
-		}
+	n_rows = g_list_model_get_n_items (G_LIST_MODEL (summary->values));
+	for (index = 0;  index < n_rows;  index++) {
+		g_string_append (gstr, summary->rows[index].name);
+		g_string_append_c (gstr, ' ');
+		g_string_append (gstr, gtk_string_list_get_string (summary->values, index));
 		g_string_append_c (gstr, '\n');
 	}
 	return g_string_free (gstr, FALSE);
@@ -223,18 +261,7 @@ gchar*  ugtk_summary_get_text_all (UgtkSummary* summary)
 // ----------------------------------------------------------------------------
 // Static functions
 
-static void ugtk_summary_clear (UgtkSummary* summary)
-{
-	GtkListBoxRow* row;
-
-	while ((row = gtk_list_box_get_row_at_index (summary->list_box, 0)) != NULL)
-		gtk_list_box_remove (summary->list_box, GTK_WIDGET (row));
-}
-
-static void ugtk_summary_add_row (UgtkSummary* summary,
-                                   const gchar* icon_name,
-                                   const gchar* name,
-                                   const gchar* value)
+static void setup_row (GtkSignalListItemFactory* factory, GtkListItem* item, UgtkSummary* summary)
 {
 	GtkWidget*  box;
 	GtkWidget*  image;
@@ -242,18 +269,39 @@ static void ugtk_summary_add_row (UgtkSummary* summary,
 	GtkWidget*  value_label;
 
 	box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 6);
-	image = gtk_image_new_from_icon_name (icon_name);
+	image = gtk_image_new ();
 	gtk_box_append (GTK_BOX (box), image);
 
-	name_label = gtk_label_new (name);
+	name_label = gtk_label_new (NULL);
 	gtk_label_set_xalign (GTK_LABEL (name_label), 0.0);
 	gtk_box_append (GTK_BOX (box), name_label);
 
-	value_label = gtk_label_new (value);
+	value_label = gtk_label_new (NULL);
 	gtk_label_set_xalign (GTK_LABEL (value_label), 0.0);
 	gtk_label_set_ellipsize (GTK_LABEL (value_label), PANGO_ELLIPSIZE_END);
 	gtk_widget_set_hexpand (value_label, TRUE);
 	gtk_box_append (GTK_BOX (box), value_label);
 
-	gtk_list_box_append (summary->list_box, box);
+	gtk_list_item_set_child (item, box);
+}
+
+static void bind_row (GtkSignalListItemFactory* factory, GtkListItem* item, UgtkSummary* summary)
+{
+	UgtkSummaryRow*  row;
+	GtkWidget*  child;
+	guint       position;
+
+	position = gtk_list_item_get_position (item);
+	if (position >= UGTK_SUMMARY_MAX_ROWS)
+		return;
+	row = summary->rows + position;
+
+	// children: image, name_label, value_label
+	child = gtk_widget_get_first_child (gtk_list_item_get_child (item));
+	gtk_image_set_from_icon_name (GTK_IMAGE (child), row->icon);
+	child = gtk_widget_get_next_sibling (child);
+	gtk_label_set_text (GTK_LABEL (child), row->name);
+	child = gtk_widget_get_next_sibling (child);
+	gtk_label_set_text (GTK_LABEL (child), gtk_string_object_get_string (
+			GTK_STRING_OBJECT (gtk_list_item_get_item (item))));
 }
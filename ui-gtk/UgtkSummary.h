@@ -39,17 +39,52 @@
 
 #include <gtk/gtk.h>
 #include <UgetNode.h>
+#include <UgetData.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 typedef	struct	UgtkSummary            UgtkSummary;
+typedef	struct	UgtkSummaryRow         UgtkSummaryRow;
+
+// Name, Folder, Category, URI, and messages of UgetLog
+#define UGTK_SUMMARY_MAX_ROWS    (4 + UGET_LOG_MAX_MESSAGES)
+
+// icon and name of row. value of row is in UgtkSummary.values
+struct UgtkSummaryRow
+{
+	const gchar*    icon;
+	const gchar*    name;
+};
 
 struct UgtkSummary
 {
 	GtkWidget*      self;    // (GtkScrolledWindow) container
-	GtkListBox*     list_box;
+	GtkListView*    view;
+	GtkStringList*  values;
+	GtkSingleSelection*  selection;
+
+	// ugtk_summary_show() only splice rows that changed.
+	UgtkSummaryRow  rows[UGTK_SUMMARY_MAX_ROWS];
+
+	// ugtk_summary_refresh() skip node if these are not changed.
+	struct
+	{
+		UgetNode*     node;
+		unsigned int  common;    // UgetCommon.generation
+		unsigned int  log;       // UgetLog.generation
+	} shown;
+
+	struct
+	{
+		gchar*      name;
+		gchar*      file;
+		gchar*      folder;
+		gchar*      category;
+		gchar*      uri;
+		gchar*      message;
+	} names;
 
 	struct
 	{
@@ -62,7 +97,10 @@ struct UgtkSummary
 };
 
 void  ugtk_summary_init (UgtkSummary* summary, gpointer accel_group);
+// It is cheap to call this repeatedly, only changed rows are rebound.
 void  ugtk_summary_show (UgtkSummary* summary, UgetNode* node);
+// Call this from timer. It does nothing if node and it's data are not changed.
+void  ugtk_summary_refresh (UgtkSummary* summary, UgetNode* node);
 
 // call g_free() to free returned string.
 gchar* ugtk_summary_get_text_selected (UgtkSummary* summary);
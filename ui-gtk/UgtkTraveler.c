@@ -35,7 +35,6 @@
  */
 
 #include <UgtkTraveler.h>
-#include <UgtkNodeObject.h>
 #include <UgtkApp.h>
 
 // signal handlers
@@ -46,38 +45,6 @@ static void on_download_selection_changed (GtkSelectionModel* model, guint pos,
 // static data
 const static UgCompareFunc  compare_funcs[UGTK_NODE_N_COLUMNS];
 
-// helper: get UgetNode* at position in a GListModel
-static UgetNode* get_node_at (GListModel* model, guint pos)
-{
-	UgtkNodeObject* obj;
-	UgetNode* node;
-
-	obj = g_list_model_get_item (model, pos);
-	if (obj == NULL)
-		return NULL;
-	node = obj->node;
-	g_object_unref (obj);
-	return node;
-}
-
-// helper: find position of a UgetNode in a GListModel
-static int find_node_position (GListModel* model, UgetNode* target)
-{
-	guint n = g_list_model_get_n_items (model);
-	guint i;
-
-	for (i = 0; i < n; i++) {
-		UgtkNodeObject* obj = g_list_model_get_item (model, i);
-		if (obj) {
-			UgetNode* node = obj->node;
-			g_object_unref (obj);
-			if (node == target)
-				return (int) i;
-		}
-	}
-	return -1;
-}
-
 void  ugtk_traveler_init (UgtkTraveler* traveler, UgtkApp* app)
 {
 	GtkScrolledWindow*  scroll;
@@ -147,8 +114,7 @@ void  ugtk_traveler_init (UgtkTraveler* traveler, UgtkApp* app)
 	// (default autoselect=TRUE), so set_selected(0) is a no-op.
 	// Manually initialize the state model with the first category node.
 	{
-		UgetNode* cnode = get_node_at (
-				G_LIST_MODEL (traveler->category.model), 0);
+		UgetNode* cnode = ugtk_node_tree_nth (traveler->category.model, 0);
 		if (cnode) {
 			traveler->category.cursor.pos = 0;
 			traveler->category.cursor.node = cnode;
@@ -176,7 +142,7 @@ void  ugtk_traveler_set_cursor (UgtkTraveler* traveler, UgetNode* node)
 	if (node == NULL)
 		return;
 
-	pos = find_node_position (G_LIST_MODEL (traveler->download.model), node);
+	pos = ugtk_node_tree_position (traveler->download.model, node);
 	if (pos >= 0) {
 		// Select just this item
 		GtkBitset* bitset = gtk_bitset_new_empty ();
@@ -205,8 +171,7 @@ GList* ugtk_traveler_get_selected (UgtkTraveler* traveler)
 
 	if (gtk_bitset_iter_init_first (&iter, bitset, &pos)) {
 		do {
-			UgetNode* node = get_node_at (
-					G_LIST_MODEL (traveler->download.model), pos);
+			UgetNode* node = ugtk_node_tree_nth (traveler->download.model, pos);
 			if (node)
 				nodes = g_list_prepend (nodes, node);
 		} while (gtk_bitset_iter_next (&iter, &pos));
@@ -228,8 +193,7 @@ void  ugtk_traveler_set_selected (UgtkTraveler* traveler, GList* nodes)
 	for (; nodes; nodes = nodes->next) {
 		if (nodes->data == NULL)
 			continue;
-		int pos = find_node_position (
-				G_LIST_MODEL (traveler->download.model), nodes->data);
+		int pos = ugtk_node_tree_position (traveler->download.model, nodes->data);
 		if (pos >= 0)
 			gtk_bitset_add (select_bitset, pos);
 	}
@@ -309,7 +273,7 @@ gint  ugtk_traveler_move_selected_up (UgtkTraveler* traveler)
 	}
 
 	if (counts > 0) {
-		ugtk_node_tree_refresh (traveler->download.model);
+		ugtk_node_tree_sync (traveler->download.model);
 		ugtk_traveler_set_selected (traveler, list);
 	}
 	g_list_free (list);
@@ -354,7 +318,7 @@ gint  ugtk_traveler_move_selected_down (UgtkTraveler* traveler)
 	}
 
 	if (counts > 0) {
-		ugtk_node_tree_refresh (traveler->download.model);
+		ugtk_node_tree_sync (traveler->download.model);
 		ugtk_traveler_set_selected (traveler, list);
 	}
 	g_list_free (list);
@@ -401,7 +365,7 @@ gint  ugtk_traveler_move_selected_top (UgtkTraveler* traveler)
 	}
 
 	if (counts > 0) {
-		ugtk_node_tree_refresh (traveler->download.model);
+		ugtk_node_tree_sync (traveler->download.model);
 		ugtk_traveler_set_selected (traveler, list);
 	}
 	g_list_free (list);
@@ -449,7 +413,7 @@ gint  ugtk_traveler_move_selected_bottom (UgtkTraveler* traveler)
 	}
 
 	if (counts > 0) {
-		ugtk_node_tree_refresh (traveler->download.model);
+		ugtk_node_tree_sync (traveler->download.model);
 		ugtk_traveler_set_selected (traveler, list);
 	}
 	g_list_free (list);
@@ -473,9 +437,31 @@ void  ugtk_traveler_set_sorting (UgtkTraveler*  traveler,
 		uget_app_set_sorting ((UgetApp*) traveler->app, compare_funcs[nth_col],
 				(type == GTK_SORT_DESCENDING) ? TRUE : FALSE);
 	}
+	// nodes were reordered without notification
+	ugtk_node_tree_sync (traveler->download.model);
 	ugtk_traveler_set_selected (traveler, selected);
 	g_list_free (selected);
-	gtk_widget_queue_draw (GTK_WIDGET (traveler->download.view));
+}
+
+void  ugtk_traveler_search (UgtkTraveler* traveler, const char* pattern)
+{
+	UgetApp*  app;
+
+	app = (UgetApp*) traveler->app;
+	traveler->download.cursor.node = NULL;
+	// detach model because uget_app_search() notify each removed/inserted node
+	traveler->download.model->root = NULL;
+	ugtk_node_tree_refresh (traveler->download.model);
+
+	if (pattern && pattern[0]) {
+		uget_app_search (app, pattern);
+		traveler->download.model->root = &app->searched;
+	}
+	else {
+		uget_app_search (app, NULL);
+		traveler->download.model->root = traveler->state.cursor.node;
+	}
+	ugtk_node_tree_refresh (traveler->download.model);
 }
 
 // ----------------------------------------------------------------------------
@@ -499,8 +485,7 @@ static void on_state_selection_changed (GtkSelectionModel* model, guint pos, gui
 		return;
 
 	traveler->state.cursor.pos = selected;
-	traveler->state.cursor.node = get_node_at (
-			G_LIST_MODEL (traveler->state.model), selected);
+	traveler->state.cursor.node = ugtk_node_list_nth (traveler->state.model, selected);
 
 	// change download.model root and refresh
 	if (traveler->state.cursor.node) {
@@ -528,7 +513,7 @@ static void on_category_selection_changed (GtkSelectionModel* model, guint pos,
 		return;
 
 	traveler->category.cursor.pos = selected;
-	node = get_node_at (G_LIST_MODEL (traveler->category.model), selected);
+	node = ugtk_node_tree_nth (traveler->category.model, selected);
 	traveler->category.cursor.node = node;
 
 	// change state.model root and refresh
@@ -559,8 +544,7 @@ static void on_download_selection_changed (GtkSelectionModel* model, guint pos,
 
 	first = gtk_bitset_get_nth (bitset, 0);
 	traveler->download.cursor.pos = first;
-	traveler->download.cursor.node = get_node_at (
-			G_LIST_MODEL (traveler->download.model), first);
+	traveler->download.cursor.node = ugtk_node_tree_nth (traveler->download.model, first);
 	gtk_bitset_unref (bitset);
 }
 
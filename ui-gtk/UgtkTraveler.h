@@ -129,6 +129,10 @@ void  ugtk_traveler_set_sorting (UgtkTraveler*  traveler,
                                  UgtkNodeColumn nth_column,
                                  GtkSortType    type);
 
+// show downloads that contain 'pattern' (uget_app_search()) in download view.
+// show downloads of current state again if 'pattern' is NULL or empty.
+void  ugtk_traveler_search (UgtkTraveler* traveler, const char* pattern);
+
 #ifdef __cplusplus
 }
 #endif